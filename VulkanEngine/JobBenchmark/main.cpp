@@ -0,0 +1,167 @@
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#include "JobSystem.h"
+
+// Scaling benchmark of the job system: builds world matrices from position, rotation and scale
+// for a large number of transforms with ParallelFor, once for every thread count from 1 to N.
+// Usage: JobBenchmark [--transforms <count>] [--grain <size>] [--iterations <count>] [--threads <max>]
+
+namespace
+{
+	struct Transform
+	{
+		float position[3];
+		float rotation[4]; // Quaternion x, y, z, w
+		float scale[3];
+	};
+
+	struct Matrix
+	{
+		float values[16];
+	};
+
+	void ComposeMatrix(const Transform& transform, Matrix& matrix)
+	{
+		const float x{ transform.rotation[0] };
+		const float y{ transform.rotation[1] };
+		const float z{ transform.rotation[2] };
+		const float w{ transform.rotation[3] };
+
+		const float sx{ transform.scale[0] };
+		const float sy{ transform.scale[1] };
+		const float sz{ transform.scale[2] };
+
+		// Column major, rotation columns scaled by the matching scale axis
+		float* m{ matrix.values };
+		m[0] = (1.f - 2.f * (y * y + z * z)) * sx;
+		m[1] = (2.f * (x * y + z * w)) * sx;
+		m[2] = (2.f * (x * z - y * w)) * sx;
+		m[3] = 0.f;
+
+		m[4] = (2.f * (x * y - z * w)) * sy;
+		m[5] = (1.f - 2.f * (x * x + z * z)) * sy;
+		m[6] = (2.f * (y * z + x * w)) * sy;
+		m[7] = 0.f;
+
+		m[8] = (2.f * (x * z + y * w)) * sz;
+		m[9] = (2.f * (y * z - x * w)) * sz;
+		m[10] = (1.f - 2.f * (x * x + y * y)) * sz;
+		m[11] = 0.f;
+
+		m[12] = transform.position[0];
+		m[13] = transform.position[1];
+		m[14] = transform.position[2];
+		m[15] = 1.f;
+	}
+
+	std::vector<Transform> CreateTransforms(uint32_t count)
+	{
+		std::vector<Transform> transforms(count);
+		for (uint32_t idx{}; idx < count; ++idx)
+		{
+			const float angle{ static_cast<float>(idx) * 0.001f };
+			const float halfAngle{ angle * 0.5f };
+
+			Transform& transform{ transforms[idx] };
+			transform.position[0] = static_cast<float>(idx % 1024);
+			transform.position[1] = static_cast<float>(idx / 1024);
+			transform.position[2] = 0.f;
+			transform.rotation[0] = 0.f;
+			transform.rotation[1] = std::sin(halfAngle);
+			transform.rotation[2] = 0.f;
+			transform.rotation[3] = std::cos(halfAngle);
+			transform.scale[0] = 1.f;
+			transform.scale[1] = 1.f + static_cast<float>(idx % 7) * 0.1f;
+			transform.scale[2] = 1.f;
+		}
+		return transforms;
+	}
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: JobBenchmark [--transforms <count>] [--grain <size>] [--iterations <count>] [--threads <max>]\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t transformCount{ 1 << 20 };
+	uint32_t grainSize{ 4096 };
+	uint32_t iterationCount{ 20 };
+	uint32_t maxThreadCount{ JobSystem::GetDefaultThreadCount() };
+
+	try
+	{
+		for (int argIdx{ 1 }; argIdx < argc; ++argIdx)
+		{
+			if (argIdx + 1 >= argc)
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+
+			const uint32_t value{ static_cast<uint32_t>(std::stoul(argv[argIdx + 1])) };
+			if (std::strcmp(argv[argIdx], "--transforms") == 0) transformCount = value;
+			else if (std::strcmp(argv[argIdx], "--grain") == 0) grainSize = value;
+			else if (std::strcmp(argv[argIdx], "--iterations") == 0) iterationCount = value;
+			else if (std::strcmp(argv[argIdx], "--threads") == 0) maxThreadCount = value;
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+			++argIdx;
+		}
+
+		const std::vector<Transform> transforms{ CreateTransforms(transformCount) };
+		std::vector<Matrix> matrices(transformCount);
+
+		std::cout << transformCount << " transforms, grain size " << grainSize << ", " << iterationCount << " iterations\n";
+		std::cout << "threads   ms/iteration   speedup\n";
+
+		double singleThreadMs{};
+		for (uint32_t threadCount{ 1 }; threadCount <= maxThreadCount; ++threadCount)
+		{
+			JobSystem jobSystem{};
+			jobSystem.Initialize(threadCount);
+
+			const auto composeRange{ [&](uint32_t begin, uint32_t end)
+			{
+				for (uint32_t idx{ begin }; idx < end; ++idx) ComposeMatrix(transforms[idx], matrices[idx]);
+			} };
+
+			// Warm up the workers and the caches before measuring
+			jobSystem.ParallelFor(transformCount, grainSize, composeRange);
+
+			const auto start{ std::chrono::high_resolution_clock::now() };
+			for (uint32_t iteration{}; iteration < iterationCount; ++iteration)
+			{
+				jobSystem.ParallelFor(transformCount, grainSize, composeRange);
+			}
+			const std::chrono::duration<double, std::milli> duration{ std::chrono::high_resolution_clock::now() - start };
+
+			jobSystem.Destroy();
+
+			const double iterationMs{ duration.count() / std::max(iterationCount, 1u) };
+			if (threadCount == 1) singleThreadMs = iterationMs;
+
+			std::cout << std::setw(7) << threadCount << std::setw(15) << std::fixed << std::setprecision(3) << iterationMs
+				<< std::setw(10) << std::setprecision(2) << singleThreadMs / iterationMs << "x\n";
+		}
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "JobBenchmark failed: " << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
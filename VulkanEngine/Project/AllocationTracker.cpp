@@ -0,0 +1,82 @@
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "AllocationTracker.h"
+
+namespace
+{
+	std::atomic<uint64_t> s_AllocationCount{};
+}
+
+#ifndef NDEBUG
+
+// Array and nothrow forms forward to these by default
+void* operator new(std::size_t size)
+{
+	s_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pMemory{ std::malloc(size != 0 ? size : 1) }) return pMemory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+#endif
+
+AllocationTracker::AllocationTracker()
+	: m_FrameCount{}
+	, m_FrameStartCount{}
+	, m_FrameAllocationCount{}
+	, m_TotalFrameAllocationCount{}
+{
+}
+
+void AllocationTracker::BeginFrame()
+{
+	m_FrameStartCount = GetAllocationCount();
+}
+
+void AllocationTracker::EndFrame()
+{
+	m_FrameAllocationCount = GetAllocationCount() - m_FrameStartCount;
+
+	if (++m_FrameCount <= s_WarmupFrames || m_FrameAllocationCount == 0) return;
+
+	m_TotalFrameAllocationCount += m_FrameAllocationCount;
+	std::cout << "Frame " << m_FrameCount << " made " << m_FrameAllocationCount << " heap allocations ("
+		<< m_TotalFrameAllocationCount << " since warmup)\n";
+}
+
+uint64_t AllocationTracker::GetFrameAllocationCount() const
+{
+	return m_FrameAllocationCount;
+}
+
+uint64_t AllocationTracker::GetTotalFrameAllocationCount() const
+{
+	return m_TotalFrameAllocationCount;
+}
+
+uint64_t AllocationTracker::GetAllocationCount()
+{
+	return s_AllocationCount.load(std::memory_order_relaxed);
+}
+
+bool AllocationTracker::IsEnabled()
+{
+#ifndef NDEBUG
+	return true;
+#else
+	return false;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <cstdint>
+
+// Counts heap allocations made through the global operator new, the counting operators are only compiled into debug builds.
+// Every frame after warmup that allocates is reported with a running total, so allocations in the frame loop can not go unnoticed.
+class AllocationTracker final
+{
+public:
+
+	AllocationTracker();
+	~AllocationTracker() = default;
+
+	AllocationTracker(const AllocationTracker& other) = delete;
+	AllocationTracker(AllocationTracker&& other) noexcept = delete;
+	AllocationTracker& operator=(const AllocationTracker& other) = delete;
+	AllocationTracker& operator=(AllocationTracker&& other) noexcept = delete;
+
+	void BeginFrame();
+	void EndFrame();
+
+	uint64_t GetFrameAllocationCount() const;
+	// Allocations of all frames after warmup
+	uint64_t GetTotalFrameAllocationCount() const;
+
+	// Allocations of every thread since startup
+	static uint64_t GetAllocationCount();
+	static bool IsEnabled();
+
+private:
+
+	uint64_t m_FrameCount;
+	uint64_t m_FrameStartCount;
+	uint64_t m_FrameAllocationCount;
+	uint64_t m_TotalFrameAllocationCount;
+
+	// Pipelines, caches and recorded command buffers settle during the first frames
+	static constexpr uint64_t s_WarmupFrames{ 60 };
+
+};
+
+#endif // !ALLOCATIONTRACKER_H
\ No newline at end of file
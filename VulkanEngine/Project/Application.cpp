@@ -1,8 +1,22 @@
+#include <algorithm>
+
 #include "Application.h"
 #include "Timer.h"
+#include "EngineSettings.h"
+#include "DeviceFunctions.h"
 
 #define USE_DEBUG_BACKGROUND_COLOR
 
+namespace
+{
+	// Large scenes are split into chunks of this many models, each recorded as its own secondary command buffer
+	constexpr uint32_t s_ModelsPerRecordJob{ 256 };
+
+	// Pipeline field of the draw sort keys, the instanced pipeline is drawn first
+	constexpr uint32_t s_Pipeline3DIRKey{ 0 };
+	constexpr uint32_t s_Pipeline3DKey{ 1 };
+}
+
 void Application::Run()
 {
 	InitVulkan();
@@ -15,46 +29,84 @@ void Application::InitVulkan()
 	m_Window.Initialize();
 
 	m_VulkanInstance.Initialize(m_Window.GetWindow());
+	DeletionQueue::Get().Initialize(m_VulkanInstance.GetQueue(QueueType::Graphics));
 
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 	const VkPhysicalDevice& phyDevice{ m_VulkanInstance.GetVkPhysicalDevice() };
-	const VkQueue& graphQ{ m_VulkanInstance.GetGraphicsQueue() };
 
 	m_Swapchain.Initialize(m_VulkanInstance, m_Window);
 
 	m_CommandPool.Initialize(m_VulkanInstance);
 	CreateCommandBuffers();
 
-	m_DepthBuffer.Initialize(m_VulkanInstance, m_CommandPool, m_Swapchain);
+	m_DepthBuffer.Initialize(m_VulkanInstance, m_Swapchain);
 
-	m_RenderPass.Initialize(m_VulkanInstance, m_Swapchain, m_DepthBuffer);
+	// Dynamic rendering needs no render pass or framebuffer objects, so nothing has to be rebuilt for them on resize
+	m_UseDynamicRendering = EngineSettings::Get().GetPreferDynamicRendering() && m_VulkanInstance.IsDynamicRenderingSupported();
+	if (!m_UseDynamicRendering) m_RenderPass.Initialize(m_VulkanInstance, m_Swapchain, m_DepthBuffer);
+	std::cout << "Rendering with " << (m_UseDynamicRendering ? "dynamic rendering" : "render pass objects") << "\n";
 
 	CreateFramebuffers();
+	CreateRenderGraph();
 
-	m_3DTexture.Initialize(m_VulkanInstance, m_CommandPool, g_TexturePath1);
-	m_3DIRTexture.Initialize(m_VulkanInstance, m_CommandPool, g_TexturePath3);
+	m_p3DTexture = AssetRegistry::Get().AcquireTexture(m_VulkanInstance, g_TexturePath1);
+	m_p3DIRTexture = AssetRegistry::Get().AcquireTexture(m_VulkanInstance, g_TexturePath3);
+
+	// Filled before the pipeline jobs start, the pipelines only read its layout and set
+	m_TextureTable.Initialize(device, phyDevice, *m_p3DTexture);
+	m_3DMaterial = m_TextureTable.AddTexture(device, AssetRegistry::Get().GetTextureKey(m_p3DTexture), *m_p3DTexture);
+	m_3DIRMaterial = m_TextureTable.AddTexture(device, AssetRegistry::Get().GetTextureKey(m_p3DIRTexture), *m_p3DIRTexture);
 
 	m_Camera.Initialize(m_VulkanInstance, m_Window);
 
-	CreateGraphicsPipeline2D();
-	CreateGraphicsPipeline3D();
-	CreateGraphicsPipeline3DIR();
+	m_PipelineStateCache.Initialize(phyDevice, m_VulkanInstance.GetVkPipelineCache(), m_ShaderCache);
+	m_GlobalDescriptors.Initialize(device, m_PipelineStateCache, m_TextureTable, EngineSettings::Get().GetMaxFramesInFlight());
+
+	// Pipelines compile on worker threads while the scenes are loaded on the main thread
+	m_JobSystem.Initialize(JobSystem::GetDefaultThreadCount());
+	m_CommandRecorder.Initialize(m_VulkanInstance, m_JobSystem.GetThreadCount(), EngineSettings::Get().GetMaxFramesInFlight());
+	m_FrameArena.Initialize(EngineSettings::Get().GetMaxFramesInFlight(), s_FrameArenaSize);
+
+	const auto pipelineStart{ std::chrono::high_resolution_clock::now() };
+
+	JobCounter pipelineJobs{};
+	m_JobSystem.Schedule([this]() { CreateGraphicsPipeline2D(); }, &pipelineJobs);
+	m_JobSystem.Schedule([this]() { CreateGraphicsPipeline3D(); }, &pipelineJobs);
+	m_JobSystem.Schedule([this]() { CreateGraphicsPipeline3DIR(); }, &pipelineJobs);
 
 	Create2DScene();
 	Create3DScene();
 	Create3DIRScene();
 
+	AssetRegistry::Get().PrintResidencyStats();
+
 	m_SyncObjects.Initialize(device);
+
+	CreateFrameTaskGraph();
+
+	// Join before the first frame, the wait only rethrows once every pipeline job finished
+	m_JobSystem.Wait(pipelineJobs);
+
+	const std::chrono::duration<float, std::milli> pipelineTime{ std::chrono::high_resolution_clock::now() - pipelineStart };
+	std::cout << "Pipelines ready after " << pipelineTime.count() << " ms ("
+		<< m_PipelineStateCache.GetPipelineCount() << " unique pipelines on " << m_JobSystem.GetThreadCount() << " threads, "
+		<< (m_VulkanInstance.GetPipelineCache().IsWarm() ? "warm" : "cold") << " pipeline cache)\n";
+
+	// Shader modules are no longer needed once the pipelines exist
+	m_ShaderCache.Destroy(device);
 }
 
 void Application::MainLoop()
 {
 	while (!m_Window.WindowShouldClose())
 	{
+		m_AllocationTracker.BeginFrame();
+
 		Timer::Get().Update();
 		m_Window.PollEvents();
-		Update();
 		DrawFrame();
+
+		m_AllocationTracker.EndFrame();
 	}
 	m_VulkanInstance.DeviceWaitIdle();
 }
@@ -63,123 +115,423 @@ void Application::Cleanup()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 
+	m_FrameTaskGraph.Clear();
+	m_JobSystem.Destroy();
+
 	CleanupWindowResources();
 
-	m_3DIRTexture.Destroy(device);
-	m_3DTexture.Destroy(device);
+	m_TextureTable.RemoveTexture(m_3DIRMaterial);
+	m_TextureTable.RemoveTexture(m_3DMaterial);
+	m_TextureTable.Destroy(device);
+	AssetRegistry::Get().ReleaseTexture(m_p3DIRTexture);
+	AssetRegistry::Get().ReleaseTexture(m_p3DTexture);
 
 	m_Camera.Destroy(device);
 
 	m_GraphicsPipeline3DIR.Destory(device);
 	m_GraphicsPipeline3D.Destroy(device);
 	m_GraphicsPipeline2D.Destroy(device);
+	m_GlobalDescriptors.Destroy(device);
+	m_PipelineStateCache.Destroy(device);
+
+	AssetRegistry::Get().Destroy(device);
 
 	m_RenderPass.Destroy(device);
 
 	m_SyncObjects.Destroy(device);
 
+	m_FrameArena.Destroy();
+	m_CommandRecorder.Destroy(device);
 	m_CommandPool.Destroy(device);
 
+	// The device is idle, so every deferred destruction can run
+	DeletionQueue::Get().Destroy(device);
+
 	m_VulkanInstance.Destroy();
 
 	m_Window.Destroy();
 }
 
-void Application::Update()
+void Application::DrawFrame()
+{
+	m_ImageAcquired = false;
+	m_RecreateWindowResources = false;
+
+	// Input, updates, recording and submission run as one task graph, the tasks that do not depend on each other overlap
+	m_FrameTaskGraph.Execute(m_JobSystem);
+	m_JobSystem.PollUncountedException();
+
+	if (m_PrintCriticalPath)
+	{
+		m_FrameTaskGraph.PrintCriticalPath();
+		std::cout << "Sorted draws: " << m_DrawStats.drawCount << " draws, " << m_DrawStats.pipelineBinds << " pipeline binds, "
+			<< m_DrawStats.descriptorSetBinds << " descriptor set binds, " << m_DrawStats.vertexBufferBinds << " vertex buffer binds\n";
+		m_PrintCriticalPath = false;
+	}
+
+	if (m_RecreateWindowResources) RecreateWindowResources();
+
+	// Nothing was submitted for this frame slot when the image could not be acquired
+	if (m_ImageAcquired) m_CurrentFrame = (m_CurrentFrame + 1) % EngineSettings::Get().GetMaxFramesInFlight();
+}
+
+void Application::CreateFrameTaskGraph()
 {
-	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
+	m_FrameTaskGraph.Clear();
+
+	// Frame slot: the wait on the slot's previous submission and everything that wait protects (deletion queue, frame arena, per frame buffers)
+	const FrameTaskResource frameSlot{ m_FrameTaskGraph.AddResource("Frame Slot") };
+	const FrameTaskResource camera{ m_FrameTaskGraph.AddResource("Camera") };
+	const FrameTaskResource pipelineState{ m_FrameTaskGraph.AddResource("Pipeline State") };
+	const FrameTaskResource instances{ m_FrameTaskGraph.AddResource("Instances") };
+	const FrameTaskResource sceneGraph{ m_FrameTaskGraph.AddResource("Scene Graph") };
+	const FrameTaskResource drawList{ m_FrameTaskGraph.AddResource("Draw List") };
+	const FrameTaskResource cameraUBO{ m_FrameTaskGraph.AddResource("Camera UBO") };
+	const FrameTaskResource swapchainImage{ m_FrameTaskGraph.AddResource("Swapchain Image") };
+	const FrameTaskResource commandBuffer{ m_FrameTaskGraph.AddResource("Command Buffer") };
+
+	m_FrameTaskGraph.AddTask("Input")
+		.Write(camera)
+		.Write(pipelineState)
+		.SetMainThread()
+		.SetExecute([this]() { ProcessInput(); });
+
+	m_FrameTaskGraph.AddTask("Wait Frame Slot")
+		.Write(frameSlot)
+		.SetExecute([this]() { WaitForFrameSlot(); });
+
+	// Writes the instance buffer of the frame slot, which the gpu may still read until the slot is waited on
+	m_FrameTaskGraph.AddTask("Instance Transforms")
+		.Read(frameSlot)
+		.Write(instances)
+		.SetExecute([this]() { m_GraphicsPipeline3DIR.Update(m_VulkanInstance.GetVkDevice(), m_JobSystem, m_CurrentFrame); });
+
+	m_FrameTaskGraph.AddTask("Scene Graph")
+		.Write(sceneGraph)
+		.SetExecute([this]() { m_GraphicsPipeline3D.Update(); });
+
+	m_FrameTaskGraph.AddTask("Draw List")
+		.Read(frameSlot)
+		.Read(camera)
+		.Read(instances)
+		.Read(sceneGraph)
+		.Write(drawList)
+		.SetExecute([this]() { BuildDrawList(); });
+
+	m_FrameTaskGraph.AddTask("Camera UBO")
+		.Read(frameSlot)
+		.Read(camera)
+		.Write(cameraUBO)
+		.SetExecute([this]() { m_Camera.UpdateUniformBufferObjects(m_VulkanInstance.GetVkDevice(), m_CurrentFrame); });
+
+	m_FrameTaskGraph.AddTask("Acquire")
+		.Read(frameSlot)
+		.Write(swapchainImage)
+		.SetExecute([this]() { AcquireImage(); });
+
+	m_FrameTaskGraph.AddTask("Record")
+		.Read(frameSlot)
+		.Read(camera)
+		.Read(pipelineState)
+		.Read(instances)
+		.Read(sceneGraph)
+		.Read(drawList)
+		.Read(swapchainImage)
+		.Write(commandBuffer)
+		.SetExecute([this]() { if (m_ImageAcquired) RecordCommandBuffer(m_ImageIndex); });
+
+	m_FrameTaskGraph.AddTask("Submit")
+		.Read(commandBuffer)
+		.Read(cameraUBO)
+		.Read(instances)
+		.Write(swapchainImage)
+		.Write(frameSlot)
+		.SetExecute([this]() { if (m_ImageAcquired) SubmitFrame(); });
+
+	m_FrameTaskGraph.Compile();
+}
+
+void Application::ProcessInput()
+{
+	// Camera movement and rotation
+	m_Camera.Update();
 
-	// Update the camera (view and projection matrices) uniform buffer
-	m_Camera.Update(device, m_CurrentFrame);
+	// Toggle wireframe on key press
+	const bool wireframeKeyDown{ glfwGetKey(m_Window.GetWindow(), GLFW_KEY_F) == GLFW_PRESS };
+	if (wireframeKeyDown && !m_WireframeKeyDown)
+	{
+		m_Wireframe = !m_Wireframe;
+		m_GraphicsPipeline3D.SetWireframe(m_Wireframe);
+		m_GraphicsPipeline3DIR.SetWireframe(m_Wireframe);
+	}
+	m_WireframeKeyDown = wireframeKeyDown;
 
-	// Update models
-	m_GraphicsPipeline3DIR.Update(m_VulkanInstance.GetVkDevice());
+	// Print the critical path of this frame on key press
+	const bool criticalPathKeyDown{ glfwGetKey(m_Window.GetWindow(), GLFW_KEY_P) == GLFW_PRESS };
+	if (criticalPathKeyDown && !m_CriticalPathKeyDown) m_PrintCriticalPath = true;
+	m_CriticalPathKeyDown = criticalPathKeyDown;
 }
 
-void Application::DrawFrame()
+void Application::WaitForFrameSlot()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
-	const VkQueue& graphQ{ m_VulkanInstance.GetGraphicsQueue() };
-	const VkQueue& presQ{ m_VulkanInstance.GetPresentQueue() };
+	const Queue& graphicsQueue{ m_VulkanInstance.GetQueue(QueueType::Graphics) };
 
-	// Get Sync Objects
-	const VkFence& inFlightFence{ m_SyncObjects.GetInFlightFence(m_CurrentFrame) };
-	const VkSemaphore& imageAvailableSemaphore{ m_SyncObjects.GetImageAvailableSemaphore(m_CurrentFrame) };
-	const VkSemaphore& renderFinishedSemaphore{ m_SyncObjects.GetRenderFinishedSemaphore(m_CurrentFrame) };
+	// Wait until the gpu finished the last frame that used this frame slot
+	graphicsQueue.Wait(device, m_SyncObjects.GetFrameSubmission(m_CurrentFrame));
+
+	// Destroy the resources the finished frames were the last users of
+	DeletionQueue::Get().Flush(device);
+	m_FrameArena.BeginFrame(m_CurrentFrame);
+}
 
-	// Wait for the fence from the previous frame
-	vkWaitForFences(device, 1, &inFlightFence, VK_TRUE, UINT64_MAX);
+void Application::BuildDrawList()
+{
+	const Frustum frustum{ m_Camera.GetFrustum() };
+	m_GraphicsPipeline3DIR.Cull(frustum);
+	m_GraphicsPipeline3D.Cull(frustum);
+
+	// The previous list is kept to see if the draw order changed, swapping keeps both buffers allocated
+	std::swap(m_DrawList, m_PreviousDrawList);
+	m_DrawList.Clear();
+
+	const DrawView drawView{ m_Camera.GetDrawView() };
+	m_GraphicsPipeline3DIR.AddDraws(m_DrawList, s_Pipeline3DIRKey, drawView);
+	m_GraphicsPipeline3D.AddDraws(m_DrawList, s_Pipeline3DKey, drawView);
+	m_DrawList.Sort();
+
+	// Depth changes that keep the order do not need new command buffers
+	if (!m_DrawList.HasSameOrder(m_PreviousDrawList)) ++m_DrawListVersion;
+
+	// The 3D draws come last and every one of them is an instance in the pipeline's stream, in sorted order
+	const std::span<const DrawItem> drawItems{ m_DrawList.GetItems() };
+	const auto firstInstancedItem{ std::find_if(drawItems.begin(), drawItems.end(), [](const DrawItem& drawItem)
+	{
+		return DrawList::GetPipeline(drawItem.key) == s_Pipeline3DKey;
+	}) };
+	m_FirstInstancedDrawItem = static_cast<uint32_t>(std::distance(drawItems.begin(), firstInstancedItem));
+
+	m_GraphicsPipeline3D.UpdateInstanceStream(m_VulkanInstance, m_CurrentFrame, drawItems.subspan(m_FirstInstancedDrawItem));
+}
+
+void Application::AcquireImage()
+{
+	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
+	const VkSemaphore& imageAvailableSemaphore{ m_SyncObjects.GetImageAvailableSemaphore(m_CurrentFrame) };
 
 	// Acquire the next image from the swap chain
-	uint32_t imageIndex{};
 	const VkResult acquireResult
 	{
 		vkAcquireNextImageKHR(device, m_Swapchain.GetVkSwapchain(), UINT64_MAX,
 		imageAvailableSemaphore,
-		VK_NULL_HANDLE, &imageIndex)
+		VK_NULL_HANDLE, &m_ImageIndex)
 	};
 
-	if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR || acquireResult == VK_SUBOPTIMAL_KHR)
+	// A suboptimal image is still acquired and its semaphore signaled, so it gets rendered and the present result triggers the recreation.
+	// The recreation itself waits until the frame's tasks finished.
+	if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR)
 	{
-		RecreateWindowResources();
+		m_RecreateWindowResources = true;
 		return;
 	}
-	else if (acquireResult != VK_SUCCESS) throw std::runtime_error{ "Failed to acquire swap chain image!" };
+	else if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) throw std::runtime_error{ "Failed to acquire swap chain image!" };
 
-	// Reset the fence for this frame
-	vkResetFences(device, 1, &inFlightFence);
+	m_ImageAcquired = true;
+}
+
+DrawStats Application::RecordDraws(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t firstItem, std::span<const DrawItem> drawItems) const
+{
+	// The items are sorted by pipeline first, so every pipeline is bound once per chunk.
+	// Both 3D pipelines share the global sets and their layout, so the sets are bound once for the whole chunk.
+	DrawRecordState state{};
+	state.currentFrame = currentFrame;
+	m_GlobalDescriptors.Bind(commandBuffer, currentFrame);
+	++state.stats.descriptorSetBinds;
+
+	for (uint32_t itemIdx{}; itemIdx < drawItems.size();)
+	{
+		const uint32_t pipeline{ DrawList::GetPipeline(drawItems[itemIdx].key) };
+		if (pipeline != state.pipeline)
+		{
+			if (pipeline == s_Pipeline3DIRKey) m_GraphicsPipeline3DIR.Bind(commandBuffer, state);
+			else m_GraphicsPipeline3D.Bind(commandBuffer, state);
+			state.pipeline = pipeline;
+		}
 
-	// Record commands in the command buffer for this frame
-	RecordCommandBuffer(imageIndex);
+		if (pipeline == s_Pipeline3DIRKey)
+		{
+			m_GraphicsPipeline3DIR.DrawModel(commandBuffer, currentFrame, drawItems[itemIdx].index, state);
+			++itemIdx;
+		}
+		else
+		{
+			// Consecutive draws of the same mesh and material become one instanced draw
+			const uint32_t firstInstance{ firstItem + itemIdx - m_FirstInstancedDrawItem };
+			itemIdx += m_GraphicsPipeline3D.DrawInstances(commandBuffer, drawItems.subspan(itemIdx), firstInstance, state);
+		}
+	}
+	return state.stats;
+}
 
-	// Submit the graphics command buffer
-	VkSemaphore waitSemaphores[]{ imageAvailableSemaphore };
-	VkPipelineStageFlags waitStages[]{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-	VkSemaphore signalSemaphores[]{ renderFinishedSemaphore };
+void Application::SubmitFrame()
+{
+	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
+	Queue& graphicsQueue{ m_VulkanInstance.GetQueue(QueueType::Graphics) };
+	Queue& presentQueue{ m_VulkanInstance.GetQueue(QueueType::Present) };
 
-	VkSubmitInfo submitInfo{};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.waitSemaphoreCount = 1;
-	submitInfo.pWaitSemaphores = waitSemaphores;
-	submitInfo.pWaitDstStageMask = waitStages;
-	submitInfo.signalSemaphoreCount = 1;
-	submitInfo.pSignalSemaphores = signalSemaphores;
+	const VkSemaphore& imageAvailableSemaphore{ m_SyncObjects.GetImageAvailableSemaphore(m_CurrentFrame) };
+	const VkSemaphore& renderFinishedSemaphore{ m_SyncObjects.GetRenderFinishedSemaphore(m_CurrentFrame) };
 
-	m_CommandBuffers[m_CurrentFrame].Submit(submitInfo, graphQ, inFlightFence);
+	// Submit the graphics command buffer, it signals the next graphics timeline value and the binary semaphore for presenting
+	const std::array<VkCommandBuffer, 1> commandBuffers{ m_CommandBuffers[m_CurrentFrame].GetVkCommandBuffer() };
+	const std::array<QueueWait, 1> waits{ QueueWait{ imageAvailableSemaphore, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT } };
+	const std::array<VkSemaphore, 1> signals{ renderFinishedSemaphore };
+	const QueueSubmission frameSubmission{ graphicsQueue.Submit(device, commandBuffers, waits, signals) };
+	m_SyncObjects.SetFrameSubmission(m_CurrentFrame, frameSubmission);
 
 	// Present the swap chain image
 	std::array<VkSwapchainKHR, 1> swapChains{ m_Swapchain.GetVkSwapchain() };
 	VkPresentInfoKHR presentInfo{};
 	presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 	presentInfo.waitSemaphoreCount = 1;
-	presentInfo.pWaitSemaphores = signalSemaphores;
+	presentInfo.pWaitSemaphores = &renderFinishedSemaphore;
 
 	presentInfo.swapchainCount = static_cast<uint32_t>(swapChains.size());
 	presentInfo.pSwapchains = swapChains.data();
 
-	presentInfo.pImageIndices = &imageIndex;
+	presentInfo.pImageIndices = &m_ImageIndex;
 	presentInfo.pResults = nullptr; // Optional
 
-	const VkResult presentResult{ vkQueuePresentKHR(presQ, &presentInfo) };
+	const VkResult presentResult{ presentQueue.Present(presentInfo) };
+
+	// The graphics timeline value of this frame completes after its present was queued behind the presents of the retired swapchains
+	if ((presentResult == VK_SUCCESS || presentResult == VK_SUBOPTIMAL_KHR) && !m_RetiredSwapchains.empty())
+	{
+		DeletionQueue::Get().Push([swapchains = std::move(m_RetiredSwapchains)](VkDevice device) mutable
+			{
+				for (Swapchain& swapchain : swapchains) swapchain.Destroy(device);
+			});
+		m_RetiredSwapchains.clear();
+	}
 
 	if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || m_Window.GetFramebufferResized())
 	{
-		RecreateWindowResources();
+		m_RecreateWindowResources = true;
 	}
 	else if (presentResult != VK_SUCCESS)
 	{
 		throw std::runtime_error("Failed to present swap chain image!");
 	}
-
-	m_CurrentFrame = (m_CurrentFrame + 1) % g_MaxFramesInFlight;
 }
 
 void Application::RecordCommandBuffer(uint32_t imageIndex)
 {
 	const VkExtent2D& swapchainExtent{ m_Swapchain.GetVkExtent() };
 	const CommandBuffer& comndBffr{ m_CommandBuffers[m_CurrentFrame] };
-	const VkCommandBuffer& VkCmndBffr{ comndBffr.GetVkCommandBuffer() };
 
+	VkViewport viewport{};
+	viewport.x = 0.f;
+	viewport.y = 0.f;
+	viewport.width = static_cast<float>(swapchainExtent.width);
+	viewport.height = static_cast<float>(swapchainExtent.height);
+	viewport.minDepth = 0.f;
+	viewport.maxDepth = 1.f;
+
+	VkRect2D scissor{};
+	scissor.offset = { 0, 0 };
+	scissor.extent = swapchainExtent;
+
+	// Scene draws are cached per frame in flight and only re-recorded when a scene or the swapchain changed
+	const uint32_t currentFrame{ m_CurrentFrame };
+	const uint64_t contentVersion
+	{
+		m_SwapchainVersion +
+		m_DrawListVersion +
+		m_GraphicsPipeline3DIR.GetDrawVersion() +
+		m_GraphicsPipeline3D.GetDrawVersion() +
+		m_GraphicsPipeline2D.GetDrawVersion()
+	};
+
+	if (!m_CommandRecorder.IsUpToDate(currentFrame, contentVersion))
+	{
+		// Only the cached buffers of this frame slot use its descriptor sets, and they are about to be replaced
+		m_GlobalDescriptors.ResetFrame(m_VulkanInstance.GetVkDevice(), currentFrame, m_Camera);
+
+		// The sorted draw list and the 2D scene are split into chunks that are recorded in parallel
+		FrameVector<RecordJob> recordJobs{ FrameArenaAllocator<RecordJob>{ m_FrameArena } };
+
+		// Every chunk reports the binds it recorded, the sum is what each replay of the cached buffers costs
+		const std::span<const DrawItem> drawItems{ m_DrawList.GetItems() };
+		const uint32_t drawJobCount{ (static_cast<uint32_t>(drawItems.size()) + s_ModelsPerRecordJob - 1) / s_ModelsPerRecordJob };
+		FrameVector<DrawStats> drawJobStats(drawJobCount, DrawStats{}, FrameArenaAllocator<DrawStats>{ m_FrameArena });
+
+		for (uint32_t jobIdx{}; jobIdx < drawJobCount; ++jobIdx)
+		{
+			const size_t firstItem{ size_t{ jobIdx } * s_ModelsPerRecordJob };
+			const std::span<const DrawItem> jobItems{ drawItems.subspan(firstItem, std::min<size_t>(s_ModelsPerRecordJob, drawItems.size() - firstItem)) };
+
+			recordJobs.emplace_back([this, &viewport, &scissor, &drawJobStats, currentFrame, jobIdx, firstItem, jobItems](VkCommandBuffer secondaryCmndBffr)
+				{
+					vkCmdSetViewport(secondaryCmndBffr, 0, 1, &viewport);
+					vkCmdSetScissor(secondaryCmndBffr, 0, 1, &scissor);
+
+					drawJobStats[jobIdx] = RecordDraws(secondaryCmndBffr, currentFrame, static_cast<uint32_t>(firstItem), jobItems);
+				});
+		}
+
+		const auto addDrawJobs{ [&](const auto& pipeline)
+		{
+			const uint32_t modelCount{ pipeline.GetModelCount() };
+			for (uint32_t firstModel{}; firstModel < modelCount; firstModel += s_ModelsPerRecordJob)
+			{
+				recordJobs.emplace_back([&pipeline, &viewport, &scissor, currentFrame, firstModel](VkCommandBuffer secondaryCmndBffr)
+					{
+						// Dynamic state is not inherited from the primary command buffer
+						vkCmdSetViewport(secondaryCmndBffr, 0, 1, &viewport);
+						vkCmdSetScissor(secondaryCmndBffr, 0, 1, &scissor);
+
+						pipeline.Draw(secondaryCmndBffr, currentFrame, firstModel, s_ModelsPerRecordJob);
+					});
+			}
+		} };
+
+		addDrawJobs(m_GraphicsPipeline2D);
+
+		// Dynamic rendering secondaries inherit the attachment formats instead of a render pass
+		const VkFormat& colorFormat{ m_Swapchain.GetVkFormat() };
+		VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo{};
+		inheritanceRenderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+		inheritanceRenderingInfo.colorAttachmentCount = 1;
+		inheritanceRenderingInfo.pColorAttachmentFormats = &colorFormat;
+		inheritanceRenderingInfo.depthAttachmentFormat = m_DepthBuffer.GetDepthFormat();
+		inheritanceRenderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+		// The framebuffer is left unspecified so the cached buffers can be executed for any swapchain image
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.pNext = m_UseDynamicRendering ? &inheritanceRenderingInfo : nullptr;
+		inheritanceInfo.renderPass = m_RenderPass.GetVkRenderPass();
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+		m_CommandRecorder.Record(m_VulkanInstance.GetVkDevice(), m_JobSystem, currentFrame, inheritanceInfo, recordJobs, contentVersion);
+
+		m_DrawStats = DrawStats{};
+		for (const DrawStats& jobStats : drawJobStats) m_DrawStats += jobStats;
+	}
+
+	// The acquired swapchain image is the only graph resource that changes between frames
+	m_pRenderGraph->SetImportedImage(m_BackbufferResource, m_Swapchain.GetVkImages()[imageIndex], m_Swapchain.GetImageViews()[imageIndex].GetVkImageView());
+
+	comndBffr.Reset();
+
+	comndBffr.BeginRecording();
+	m_pRenderGraph->Execute(comndBffr.GetVkCommandBuffer());
+	comndBffr.EndRecording();
+}
+
+void Application::RecordScenePass(VkCommandBuffer commandBuffer) const
+{
 	const glm::vec3& cameraDir{ glm::normalize(m_Camera.GetDirection()) };
 
 #ifdef USE_DEBUG_BACKGROUND_COLOR
@@ -198,6 +550,54 @@ void Application::RecordCommandBuffer(uint32_t imageIndex)
 
 #endif
 
+	const std::vector<VkCommandBuffer>& secondaryCmndBffrs{ m_CommandRecorder.GetRecorded(m_CurrentFrame) };
+
+	if (m_UseDynamicRendering) BeginSceneRendering(commandBuffer, clearColor);
+	else BeginSceneRenderPass(commandBuffer, clearColor);
+
+	if (!secondaryCmndBffrs.empty())
+	{
+		vkCmdExecuteCommands(commandBuffer, static_cast<uint32_t>(secondaryCmndBffrs.size()), secondaryCmndBffrs.data());
+	}
+
+	if (m_UseDynamicRendering) DeviceFunctions::Get().CmdEndRendering(commandBuffer);
+	else vkCmdEndRenderPass(commandBuffer);
+}
+
+void Application::BeginSceneRendering(VkCommandBuffer commandBuffer, const VkClearColorValue& clearColor) const
+{
+	// The render graph already transitioned both attachments into their attachment layouts
+	VkRenderingAttachmentInfo colorAttachment{};
+	colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+	colorAttachment.imageView = m_pRenderGraph->GetImageView(m_BackbufferResource);
+	colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+	colorAttachment.clearValue.color = clearColor;
+
+	VkRenderingAttachmentInfo depthAttachment{};
+	depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+	depthAttachment.imageView = m_pRenderGraph->GetImageView(m_DepthResource);
+	depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
+
+	VkRenderingInfo renderingInfo{};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+	renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+	renderingInfo.renderArea.offset = { 0, 0 };
+	renderingInfo.renderArea.extent = m_Swapchain.GetVkExtent();
+	renderingInfo.layerCount = 1;
+	renderingInfo.colorAttachmentCount = 1;
+	renderingInfo.pColorAttachments = &colorAttachment;
+	renderingInfo.pDepthAttachment = &depthAttachment;
+
+	DeviceFunctions::Get().CmdBeginRendering(commandBuffer, renderingInfo);
+}
+
+void Application::BeginSceneRenderPass(VkCommandBuffer commandBuffer, const VkClearColorValue& clearColor) const
+{
 	std::array<VkClearValue, 2> clearValues{};
 	clearValues[0].color = clearColor;
 	clearValues[1].depthStencil = { 1.0f, 0 };
@@ -205,47 +605,22 @@ void Application::RecordCommandBuffer(uint32_t imageIndex)
 	VkRenderPassBeginInfo renderPassInfo{};
 	renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 	renderPassInfo.renderPass = m_RenderPass.GetVkRenderPass();
-	renderPassInfo.framebuffer = m_FrameBuffers[imageIndex];
+	renderPassInfo.framebuffer = m_FrameBuffers[m_ImageIndex];
 	renderPassInfo.renderArea.offset = { 0, 0 };
-	renderPassInfo.renderArea.extent = swapchainExtent;
+	renderPassInfo.renderArea.extent = m_Swapchain.GetVkExtent();
 	renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 	renderPassInfo.pClearValues = clearValues.data();
 
-	VkViewport viewport{};
-	viewport.x = 0.f;
-	viewport.y = 0.f;
-	viewport.width = static_cast<float>(swapchainExtent.width);
-	viewport.height = static_cast<float>(swapchainExtent.height);
-	viewport.minDepth = 0.f;
-	viewport.maxDepth = 1.f;
-
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = swapchainExtent;
-
-	comndBffr.Reset();
-
-	comndBffr.BeginRecording();
-
-	comndBffr.BeginRenderPass(renderPassInfo);
-	{
-		vkCmdSetViewport(VkCmndBffr, 0, 1, &viewport);
-
-		vkCmdSetScissor(VkCmndBffr, 0, 1, &scissor);
-
-		m_GraphicsPipeline3DIR.Draw(VkCmndBffr, m_CurrentFrame);
-		m_GraphicsPipeline3D.Draw(VkCmndBffr, m_CurrentFrame);
-		m_GraphicsPipeline2D.Draw(VkCmndBffr, m_CurrentFrame);
-	}
-	comndBffr.EndRenderPass();
-
-	comndBffr.EndRecording();
+	vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 }
 
 void Application::CleanupWindowResources()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 
+	m_pRenderGraph->Destroy(device);
+	m_pRenderGraph.reset();
+
 	m_DepthBuffer.Destroy(device);
 
 	for (auto framebuffer : m_FrameBuffers)
@@ -253,6 +628,9 @@ void Application::CleanupWindowResources()
 		vkDestroyFramebuffer(device, framebuffer, nullptr);
 	}
 
+	for (Swapchain& swapchain : m_RetiredSwapchains) swapchain.Destroy(device);
+	m_RetiredSwapchains.clear();
+
 	m_Swapchain.Destroy(device);
 }
 
@@ -269,20 +647,42 @@ void Application::RecreateWindowResources()
 	}
 	//////////////////////////////////
 
-	m_VulkanInstance.DeviceWaitIdle(); // we shouldnt touch resources that may still be in use
+	// Frames in flight may still use the current resources, they are deferred instead of waiting for the device to go idle
+	DeletionQueue::Get().Push(
+		[depthBuffer = m_DepthBuffer, frameBuffers = std::move(m_FrameBuffers),
+		pRenderGraph = std::shared_ptr<RenderGraph>{ std::move(m_pRenderGraph) }](VkDevice device) mutable
+		{
+			pRenderGraph->Destroy(device);
+			depthBuffer.Destroy(device);
+			for (auto framebuffer : frameBuffers)
+			{
+				vkDestroyFramebuffer(device, framebuffer, nullptr);
+			}
+		});
 
-	CleanupWindowResources();
+	// The graphics timeline does not cover presents, the old swapchain is destroyed once a frame was presented on the new one
+	const Swapchain oldSwapchain{ m_Swapchain };
+	m_RetiredSwapchains.emplace_back(oldSwapchain);
 
-	m_Swapchain.Initialize(m_VulkanInstance, m_Window);
+	m_FrameBuffers.clear();
 
-	m_DepthBuffer.Initialize(m_VulkanInstance, m_CommandPool, m_Swapchain);
+	// The old swapchain hands its presentation resources over to the new one and stays valid until it is destroyed
+	m_Swapchain.Initialize(m_VulkanInstance, m_Window, oldSwapchain.GetVkSwapchain());
+
+	m_DepthBuffer.Initialize(m_VulkanInstance, m_Swapchain);
 	CreateFramebuffers();
+	CreateRenderGraph();
+
+	// Cached secondary command buffers captured the old extent
+	++m_SwapchainVersion;
 
 	m_Window.SetFramebufferResized(false);
 }
 
 void Application::CreateFramebuffers()
 {
+	if (m_UseDynamicRendering) return;
+
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 	const std::vector<ImageView>& swapchainImageViews{ m_Swapchain.GetImageViews() };
 	const VkExtent2D& swapchainExtent{ m_Swapchain.GetVkExtent() };
@@ -313,11 +713,29 @@ void Application::CreateFramebuffers()
 	}
 }
 
+void Application::CreateRenderGraph()
+{
+	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
+
+	m_pRenderGraph = std::make_unique<RenderGraph>();
+
+	// Both attachments are cleared by the scene pass, so their previous contents are never needed
+	m_BackbufferResource = m_pRenderGraph->ImportImage("Backbuffer", VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	m_DepthResource = m_pRenderGraph->ImportImage("Depth", VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_UNDEFINED);
+	m_pRenderGraph->SetImportedImage(m_DepthResource, m_DepthBuffer.GetVkImage(), m_DepthBuffer.GetVkImageView());
+
+	m_pRenderGraph->AddPass("Scene")
+		.Write(m_BackbufferResource, RenderGraphAccess::ColorAttachmentWrite)
+		.Write(m_DepthResource, RenderGraphAccess::DepthAttachmentWrite)
+		.SetExecute([this](VkCommandBuffer commandBuffer) { RecordScenePass(commandBuffer); });
+
+	m_pRenderGraph->Compile(device, m_VulkanInstance.GetVkPhysicalDevice());
+}
+
 void Application::CreateGraphicsPipeline2D()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 	const VkRenderPass& renderPass{ m_RenderPass.GetVkRenderPass() };
-	const VkExtent2D& swapchainExtent{ m_Swapchain.GetVkExtent() };
 
 	const ShaderConfig vertShaderConfig2D
 	{
@@ -338,17 +756,18 @@ void Application::CreateGraphicsPipeline2D()
 	GraphicsPipelineConfigs configs{};
 	configs.device = device;
 	configs.shaderConfigs = shaderConfigs2D;
-	configs.swapchainExtent = swapchainExtent;
 	configs.renderPass = renderPass;
+	configs.colorFormat = m_Swapchain.GetVkFormat();
+	configs.depthFormat = m_DepthBuffer.GetDepthFormat();
+	configs.stateCache = &m_PipelineStateCache;
 
-	m_GraphicsPipeline2D.Initialize(configs, m_Camera);
+	m_GraphicsPipeline2D.Initialize(configs, m_GlobalDescriptors);
 }
 
 void Application::CreateGraphicsPipeline3D()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 	const VkRenderPass& renderPass{ m_RenderPass.GetVkRenderPass() };
-	const VkExtent2D& swapchainExtent{ m_Swapchain.GetVkExtent() };
 
 	const ShaderConfig vertShaderConfig3D
 	{
@@ -369,17 +788,18 @@ void Application::CreateGraphicsPipeline3D()
 	GraphicsPipelineConfigs configs{};
 	configs.device = device;
 	configs.shaderConfigs = shaderConfigs3D;
-	configs.swapchainExtent = swapchainExtent;
 	configs.renderPass = renderPass;
+	configs.colorFormat = m_Swapchain.GetVkFormat();
+	configs.depthFormat = m_DepthBuffer.GetDepthFormat();
+	configs.stateCache = &m_PipelineStateCache;
 
-	m_GraphicsPipeline3D.Initialize(configs, m_3DTexture, m_Camera);
+	m_GraphicsPipeline3D.Initialize(configs, m_GlobalDescriptors);
 }
 
 void Application::CreateGraphicsPipeline3DIR()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 	const VkRenderPass& renderPass{ m_RenderPass.GetVkRenderPass() };
-	const VkExtent2D& swapchainExtent{ m_Swapchain.GetVkExtent() };
 
 	const ShaderConfig vertShaderConfig3D
 	{
@@ -400,19 +820,21 @@ void Application::CreateGraphicsPipeline3DIR()
 	GraphicsPipelineConfigs configs{};
 	configs.device = device;
 	configs.shaderConfigs = shaderConfigs3D;
-	configs.swapchainExtent = swapchainExtent;
 	configs.renderPass = renderPass;
+	configs.colorFormat = m_Swapchain.GetVkFormat();
+	configs.depthFormat = m_DepthBuffer.GetDepthFormat();
+	configs.stateCache = &m_PipelineStateCache;
 
-	m_GraphicsPipeline3DIR.Initialize(configs, m_3DIRTexture, m_Camera);
+	m_GraphicsPipeline3DIR.Initialize(configs, m_GlobalDescriptors);
 }
 
 void Application::CreateCommandBuffers()
 {
 	const VkDevice& device{ m_VulkanInstance.GetVkDevice() };
 
-	m_CommandBuffers.resize(g_MaxFramesInFlight);
+	m_CommandBuffers.resize(EngineSettings::Get().GetMaxFramesInFlight());
 
-	for (int idx{}; idx < g_MaxFramesInFlight; ++idx)
+	for (uint32_t idx{}; idx < EngineSettings::Get().GetMaxFramesInFlight(); ++idx)
 	{
 		m_CommandBuffers[idx] = m_CommandPool.CreateCommandBuffer(device);
 	}
@@ -501,20 +923,23 @@ void Application::Create3DScene()
 
 	model1.SetPosition(glm::vec3{0.f, -2.f, 0.f});
 	model1.SetScale(50.f);
+	model1.SetStatic(true);
+	model1.SetMaterial(m_3DMaterial);
 
 	model2.SetPosition(glm::vec3{ 0.f, 0.f, 0.f });
+	model2.SetMaterial(m_3DMaterial);
 
 	// adding models
 	sceneModels.emplace_back(std::move(model1));
 	sceneModels.emplace_back(std::move(model2));
 
-	m_GraphicsPipeline3D.SetScene(std::move(sceneModels));
+	m_GraphicsPipeline3D.SetScene(m_VulkanInstance, m_CommandPool, std::move(sceneModels));
 }
 
 void Application::Create3DIRScene()
 {
 	Scene3DIR scene3DIR{};
-	scene3DIR.Initialize(m_VulkanInstance, m_CommandPool, "Resources/Scenes/Scene3DIR.json");
+	scene3DIR.Initialize(m_VulkanInstance, m_CommandPool, "Resources/Scenes/Scene3DIR.json", m_3DIRMaterial);
 
 	m_GraphicsPipeline3DIR.SetScene(std::move(scene3DIR));
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <set>
 #include <algorithm>
 #include <chrono>
+#include <memory>
+#include <span>
 
 #include <vulkan/vulkan.h>
 
@@ -39,12 +41,25 @@
 #include "Camera.h"
 #include "Scene.h"
 #include "Texture.h"
+#include "TextureTable.h"
+#include "AssetRegistry.h"
+#include "DeletionQueue.h"
 #include "Window.h"
 #include "GraphicsPipeline2D.h"
 #include "GraphicsPipeline3D.h"
 #include "GraphicsPipeline3DIR.h"
 #include "DepthBuffer.h"
 #include "Swapchain.h"
+#include "JobSystem.h"
+#include "FrameTaskGraph.h"
+#include "ParallelCommandRecorder.h"
+#include "ShaderCache.h"
+#include "PipelineStateCache.h"
+#include "GlobalDescriptors.h"
+#include "RenderGraph.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "DrawList.h"
 
 class Application final
 {
@@ -61,9 +76,20 @@ private:
 	void MainLoop();
 	void Cleanup();
 
-	void Update();
 	void DrawFrame();
+
+	// Frame Tasks
+	void CreateFrameTaskGraph();
+	void ProcessInput();
+	void WaitForFrameSlot();
+	void AcquireImage();
+	void BuildDrawList();
 	void RecordCommandBuffer(uint32_t imageIndex);
+	DrawStats RecordDraws(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t firstItem, std::span<const DrawItem> drawItems) const;
+	void SubmitFrame();
+	void RecordScenePass(VkCommandBuffer commandBuffer) const;
+	void BeginSceneRendering(VkCommandBuffer commandBuffer, const VkClearColorValue& clearColor) const;
+	void BeginSceneRenderPass(VkCommandBuffer commandBuffer, const VkClearColorValue& clearColor) const;
 
 	void CleanupWindowResources();
 	void RecreateWindowResources();
@@ -71,6 +97,9 @@ private:
 	// Frame Buffers
 	void CreateFramebuffers();
 
+	// Render Graph
+	void CreateRenderGraph();
+
 	// Graphics Pipeline
 	void CreateGraphicsPipeline2D();
 	void CreateGraphicsPipeline3D();
@@ -94,37 +123,78 @@ private:
 
 	// SwapChain
 	Swapchain m_Swapchain;
+	// Replaced by a recreation, kept until a frame presented on the new swapchain has finished, their queued presents are done by then
+	std::vector<Swapchain> m_RetiredSwapchains;
 
-	// RenderPass
+	// RenderPass, only used when dynamic rendering is unavailable or disabled
 	RenderPass m_RenderPass;
+	bool m_UseDynamicRendering{ false };
 
 	// Pipeline
+	ShaderCache m_ShaderCache;
+	PipelineStateCache m_PipelineStateCache;
+	GlobalDescriptors m_GlobalDescriptors;
 	GraphicsPipeline2D m_GraphicsPipeline2D;
 	GraphicsPipeline3D m_GraphicsPipeline3D;
 	GraphicsPipeline3DIR m_GraphicsPipeline3DIR;
+	bool m_Wireframe{ false };
+	bool m_WireframeKeyDown{ false };
+	bool m_CriticalPathKeyDown{ false };
 
 	// Frame Buffers
 	std::vector<VkFramebuffer> m_FrameBuffers;
 
+	// Render Graph
+	std::unique_ptr<RenderGraph> m_pRenderGraph;
+	RenderGraphResource m_BackbufferResource{};
+	RenderGraphResource m_DepthResource{};
+
 	// CommandPool
 	CommandPool m_CommandPool;
 	std::vector<CommandBuffer> m_CommandBuffers;
+	ParallelCommandRecorder m_CommandRecorder;
+	uint64_t m_SwapchainVersion{};
 
 	// Sync Objects
 	SyncObjects m_SyncObjects;
 
 	// Frames in flight
 	uint32_t m_CurrentFrame;
-
-	// Textures
-	Texture m_3DTexture;
-	Texture m_3DIRTexture;
+	uint32_t m_ImageIndex{};
+	bool m_ImageAcquired{ false };
+	bool m_RecreateWindowResources{ false };
+
+	// Frame Tasks
+	FrameTaskGraph m_FrameTaskGraph;
+	bool m_PrintCriticalPath{ false };
+
+	// Draws of the 3D pipelines sorted by state and depth, rebuilt every frame
+	DrawList m_DrawList;
+	DrawList m_PreviousDrawList;
+	uint64_t m_DrawListVersion{};
+	uint32_t m_FirstInstancedDrawItem{};
+	DrawStats m_DrawStats{};
+
+	// Transient cpu data of the frame loop
+	FrameArena m_FrameArena;
+	AllocationTracker m_AllocationTracker;
+	static constexpr size_t s_FrameArenaSize{ 1024 * 1024 };
+
+	// Textures (owned by the AssetRegistry), the 3D pipelines sample them through the texture table
+	const Texture* m_p3DTexture{ nullptr };
+	const Texture* m_p3DIRTexture{ nullptr };
+	TextureTable m_TextureTable;
+	uint32_t m_3DMaterial{};
+	uint32_t m_3DIRMaterial{};
 
 	// Depth Buffer
 	DepthBuffer m_DepthBuffer;
 
 	// Camera
 	Camera m_Camera;
+
+	// Worker threads
+	JobSystem m_JobSystem;
 };
 
 #endif // !VULKANBASE_H
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <algorithm>
+#include <iterator>
+
+#include "AssetRegistry.h"
+#include "VulkanInstance.h"
+#include "DeletionQueue.h"
+
+namespace
+{
+	constexpr uint64_t s_FnvOffsetBasis{ 14695981039346656037ull };
+	constexpr uint64_t s_FnvPrime{ 1099511628211ull };
+}
+
+AssetRegistry::AssetRegistry()
+	: m_Meshes{}
+	, m_Textures{}
+	, m_Samplers{}
+	, m_PathKeys{}
+	, m_CacheHits{}
+	, m_CacheMisses{}
+{
+}
+
+void AssetRegistry::Destroy(VkDevice device)
+{
+	if (!m_Meshes.empty() || !m_Textures.empty())
+	{
+		std::cout << "AssetRegistry: destroying " << m_Meshes.size() << " meshes and " << m_Textures.size() << " textures that are still referenced\n";
+	}
+
+	for (auto& [key, entry] : m_Meshes) entry.pAsset->Destroy(device);
+	for (auto& [key, entry] : m_Textures) entry.pAsset->Destroy(device);
+	for (auto& [key, entry] : m_Samplers) entry.pAsset->Destroy(device);
+
+	m_Meshes.clear();
+	m_Textures.clear();
+	m_Samplers.clear();
+	m_PathKeys.clear();
+}
+
+const Mesh* AssetRegistry::AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath, VertexType vertexType)
+{
+	const std::string pathKey{ "mesh" + std::to_string(static_cast<int>(vertexType)) + ":" + GetCanonicalPath(filePath) };
+
+	if (const auto pathIt{ m_PathKeys.find(pathKey) }; pathIt != m_PathKeys.end())
+	{
+		if (const Mesh* pMesh{ FindMesh(pathIt->second) }) return pMesh;
+	}
+
+	// Different paths with identical content still resolve to the same mesh
+	const std::string canonicalPath{ GetCanonicalPath(filePath) };
+	uint64_t key{ HashFile(filePath, s_FnvOffsetBasis) };
+	key = HashBytes(&vertexType, sizeof(vertexType), key);
+	key = ResolveMeshKey(key, canonicalPath);
+	m_PathKeys[pathKey] = key;
+
+	if (const Mesh* pMesh{ FindMesh(key) }) return pMesh;
+
+	const Mesh* pMesh{ nullptr };
+	std::vector<uint32_t> indices{};
+	switch (vertexType)
+	{
+	case VertexType::Vertex3D:
+	{
+		std::vector<Vertex3D> vertices{};
+		Mesh::LoadFromFile(filePath, vertices, indices);
+		pMesh = AcquireMesh(instance, commandPool, key, vertices.data(), sizeof(vertices[0]) * vertices.size(), indices, AABB::FromVertices(vertices));
+		break;
+	}
+	case VertexType::Vertex3DIR:
+	{
+		std::vector<Vertex3DIR> vertices{};
+		Mesh::LoadFromFile(filePath, vertices, indices);
+		pMesh = AcquireMesh(instance, commandPool, key, vertices.data(), sizeof(vertices[0]) * vertices.size(), indices, AABB::FromVertices(vertices));
+		break;
+	}
+	case VertexType::Vertex2D:
+		throw std::runtime_error{ "AssetRegistry: meshes can only be loaded from file as 3D vertices!" };
+	}
+
+	m_Meshes.at(key).filePath = canonicalPath;
+	return pMesh;
+}
+
+const Mesh* AssetRegistry::AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices)
+{
+	constexpr VertexType vertexType{ VertexType::Vertex3D };
+
+	uint64_t key{ HashBytes(vertices.data(), sizeof(vertices[0]) * vertices.size(), s_FnvOffsetBasis) };
+	key = HashBytes(indices.data(), sizeof(indices[0]) * indices.size(), key);
+	key = HashBytes(&vertexType, sizeof(vertexType), key);
+	key = ResolveMeshKey(key, std::string{});
+
+	if (const Mesh* pMesh{ FindMesh(key) }) return pMesh;
+
+	return AcquireMesh(instance, commandPool, key, vertices.data(), sizeof(vertices[0]) * vertices.size(), indices, AABB::FromVertices(vertices));
+}
+
+const Mesh* AssetRegistry::AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices)
+{
+	constexpr VertexType vertexType{ VertexType::Vertex3DIR };
+
+	uint64_t key{ HashBytes(vertices.data(), sizeof(vertices[0]) * vertices.size(), s_FnvOffsetBasis) };
+	key = HashBytes(indices.data(), sizeof(indices[0]) * indices.size(), key);
+	key = HashBytes(&vertexType, sizeof(vertexType), key);
+	key = ResolveMeshKey(key, std::string{});
+
+	if (const Mesh* pMesh{ FindMesh(key) }) return pMesh;
+
+	return AcquireMesh(instance, commandPool, key, vertices.data(), sizeof(vertices[0]) * vertices.size(), indices, AABB::FromVertices(vertices));
+}
+
+void AssetRegistry::ReleaseMesh(const Mesh* pMesh)
+{
+	if (!pMesh) return;
+
+	for (auto it{ m_Meshes.begin() }; it != m_Meshes.end(); ++it)
+	{
+		if (it->second.pAsset.get() != pMesh) continue;
+
+		if (--it->second.refCount == 0)
+		{
+			it->second.pAsset->DeferDestroy();
+			m_Meshes.erase(it);
+		}
+		return;
+	}
+
+	throw std::runtime_error{ "AssetRegistry: released mesh is not registered!" };
+}
+
+const Texture* AssetRegistry::AcquireTexture(const VulkanInstance& instance, const std::string& filePath)
+{
+	const std::string pathKey{ "texture:" + GetCanonicalPath(filePath) };
+
+	if (const auto pathIt{ m_PathKeys.find(pathKey) }; pathIt != m_PathKeys.end())
+	{
+		if (const Texture* pTexture{ FindTexture(pathIt->second) }) return pTexture;
+	}
+
+	// The cooked file is what gets loaded, so a re-cooked texture with an unchanged source is a new asset
+	const std::string canonicalPath{ GetCanonicalPath(filePath) };
+	const uint64_t key{ ResolveTextureKey(HashTextureFiles(filePath), canonicalPath) };
+	m_PathKeys[pathKey] = key;
+
+	if (const Texture* pTexture{ FindTexture(key) }) return pTexture;
+
+	++m_CacheMisses;
+
+	const VkDevice& device{ instance.GetVkDevice() };
+	const Sampler* pSampler{ AcquireSampler(device, instance.GetVkPhysicalDevice(), GetTextureSamplerConfigs()) };
+
+	Entry<Texture> entry{};
+	entry.pAsset = std::make_unique<Texture>();
+	entry.pAsset->Initialize(instance, filePath, *pSampler);
+	entry.refCount = 1;
+	entry.filePath = canonicalPath;
+
+	VkMemoryRequirements memRequirements{};
+	vkGetImageMemoryRequirements(device, entry.pAsset->GetVkImage(), &memRequirements);
+	entry.sizeInBytes = memRequirements.size;
+
+	const Texture* pTexture{ entry.pAsset.get() };
+	m_Textures.emplace(key, std::move(entry));
+
+	return pTexture;
+}
+
+void AssetRegistry::ReleaseTexture(const Texture* pTexture)
+{
+	if (!pTexture) return;
+
+	for (auto it{ m_Textures.begin() }; it != m_Textures.end(); ++it)
+	{
+		if (it->second.pAsset.get() != pTexture) continue;
+
+		if (--it->second.refCount == 0)
+		{
+			it->second.pAsset->DeferDestroy();
+			m_Textures.erase(it);
+
+			if (const auto samplerIt{ m_Samplers.find(GetSamplerKey(GetTextureSamplerConfigs())) }; samplerIt != m_Samplers.end())
+			{
+				ReleaseSampler(samplerIt->second.pAsset.get());
+			}
+		}
+		return;
+	}
+
+	throw std::runtime_error{ "AssetRegistry: released texture is not registered!" };
+}
+
+uint64_t AssetRegistry::GetTextureKey(const Texture* pTexture) const
+{
+	for (const auto& [key, entry] : m_Textures)
+	{
+		if (entry.pAsset.get() == pTexture) return key;
+	}
+
+	throw std::runtime_error{ "AssetRegistry: texture is not registered!" };
+}
+
+const Sampler* AssetRegistry::AcquireSampler(VkDevice device, VkPhysicalDevice phyDevice, const SamplerConfigs& configs)
+{
+	const uint64_t key{ GetSamplerKey(configs) };
+
+	if (const auto it{ m_Samplers.find(key) }; it != m_Samplers.end())
+	{
+		++m_CacheHits;
+		++it->second.refCount;
+		return it->second.pAsset.get();
+	}
+
+	++m_CacheMisses;
+
+	Entry<Sampler> entry{};
+	entry.pAsset = std::make_unique<Sampler>();
+	entry.pAsset->Initialize(device, phyDevice, configs);
+	entry.refCount = 1;
+
+	const Sampler* pSampler{ entry.pAsset.get() };
+	m_Samplers.emplace(key, std::move(entry));
+
+	return pSampler;
+}
+
+void AssetRegistry::ReleaseSampler(const Sampler* pSampler)
+{
+	if (!pSampler) return;
+
+	for (auto it{ m_Samplers.begin() }; it != m_Samplers.end(); ++it)
+	{
+		if (it->second.pAsset.get() != pSampler) continue;
+
+		if (--it->second.refCount == 0)
+		{
+			DeletionQueue::Get().Push([sampler = *it->second.pAsset](VkDevice device) mutable { sampler.Destroy(device); });
+			m_Samplers.erase(it);
+		}
+		return;
+	}
+
+	throw std::runtime_error{ "AssetRegistry: released sampler is not registered!" };
+}
+
+AssetResidencyStats AssetRegistry::GetResidencyStats() const
+{
+	AssetResidencyStats stats{};
+	stats.meshCount = static_cast<uint32_t>(m_Meshes.size());
+	stats.textureCount = static_cast<uint32_t>(m_Textures.size());
+	stats.samplerCount = static_cast<uint32_t>(m_Samplers.size());
+	stats.cacheHits = m_CacheHits;
+	stats.cacheMisses = m_CacheMisses;
+
+	for (const auto& [key, entry] : m_Meshes) stats.meshBytes += entry.sizeInBytes;
+	for (const auto& [key, entry] : m_Textures) stats.textureBytes += entry.sizeInBytes;
+
+	return stats;
+}
+
+void AssetRegistry::PrintResidencyStats() const
+{
+	const AssetResidencyStats stats{ GetResidencyStats() };
+
+	std::cout << "Resident assets: "
+		<< stats.meshCount << " meshes (" << stats.meshBytes / 1024 << " KiB), "
+		<< stats.textureCount << " textures (" << stats.textureBytes / 1024 << " KiB), "
+		<< stats.samplerCount << " samplers | "
+		<< stats.cacheHits << " cache hits, " << stats.cacheMisses << " loads\n";
+}
+
+const Mesh* AssetRegistry::AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, uint64_t key, const void* vertexData, VkDeviceSize vertexDataSize, const std::vector<uint32_t>& indices, const AABB& bounds)
+{
+	++m_CacheMisses;
+
+	Entry<Mesh> entry{};
+	entry.pAsset = std::make_unique<Mesh>();
+	entry.pAsset->Initialize(instance, commandPool, vertexData, vertexDataSize, indices, bounds);
+	entry.refCount = 1;
+	entry.sizeInBytes = entry.pAsset->GetSizeInBytes();
+
+	const Mesh* pMesh{ entry.pAsset.get() };
+	m_Meshes.emplace(key, std::move(entry));
+
+	return pMesh;
+}
+
+const Mesh* AssetRegistry::FindMesh(uint64_t key)
+{
+	const auto it{ m_Meshes.find(key) };
+	if (it == m_Meshes.end()) return nullptr;
+
+	++m_CacheHits;
+	++it->second.refCount;
+	return it->second.pAsset.get();
+}
+
+const Texture* AssetRegistry::FindTexture(uint64_t key)
+{
+	const auto it{ m_Textures.find(key) };
+	if (it == m_Textures.end()) return nullptr;
+
+	++m_CacheHits;
+	++it->second.refCount;
+	return it->second.pAsset.get();
+}
+
+uint64_t AssetRegistry::ResolveMeshKey(uint64_t key, const std::string& filePath) const
+{
+	for (auto it{ m_Meshes.find(key) }; it != m_Meshes.end(); it = m_Meshes.find(key))
+	{
+		// Meshes created from memory are only identified by their hash
+		if (it->second.filePath == filePath) break;
+		if (!it->second.filePath.empty() && !filePath.empty() && AreFilesEqual(it->second.filePath, filePath)) break;
+
+		key = HashBytes(filePath.data(), filePath.size(), key + 1);
+	}
+	return key;
+}
+
+uint64_t AssetRegistry::ResolveTextureKey(uint64_t key, const std::string& filePath) const
+{
+	for (auto it{ m_Textures.find(key) }; it != m_Textures.end(); it = m_Textures.find(key))
+	{
+		const std::string& entryPath{ it->second.filePath };
+		if (entryPath == filePath) break;
+		if (AreFilesEqual(entryPath, filePath) && AreFilesEqual(Texture::GetCookedFilePath(entryPath), Texture::GetCookedFilePath(filePath))) break;
+
+		key = HashBytes(filePath.data(), filePath.size(), key + 1);
+	}
+	return key;
+}
+
+std::string AssetRegistry::GetCanonicalPath(const std::string& filePath)
+{
+	std::error_code errorCode{};
+	const std::filesystem::path canonicalPath{ std::filesystem::weakly_canonical(filePath, errorCode) };
+
+	return errorCode ? filePath : canonicalPath.generic_string();
+}
+
+uint64_t AssetRegistry::HashFile(const std::string& filePath, uint64_t hash)
+{
+	std::ifstream file{ filePath, std::ios::ate | std::ios::binary };
+	if (!file.is_open())
+	{
+		throw std::runtime_error{ "AssetRegistry: failed to open file: " + filePath };
+	}
+
+	const size_t fileSize{ static_cast<size_t>(file.tellg()) };
+	std::vector<char> buffer(fileSize);
+
+	file.seekg(0);
+	file.read(buffer.data(), fileSize);
+	file.close();
+
+	return HashBytes(buffer.data(), buffer.size(), hash);
+}
+
+uint64_t AssetRegistry::HashTextureFiles(const std::string& filePath)
+{
+	uint64_t hash{ HashFile(filePath, s_FnvOffsetBasis) };
+
+	const std::string cookedFilePath{ Texture::GetCookedFilePath(filePath) };
+	if (cookedFilePath != filePath && std::filesystem::exists(cookedFilePath)) hash = HashFile(cookedFilePath, hash);
+
+	return hash;
+}
+
+bool AssetRegistry::AreFilesEqual(const std::string& lhsFilePath, const std::string& rhsFilePath)
+{
+	std::ifstream lhsFile{ lhsFilePath, std::ios::ate | std::ios::binary };
+	std::ifstream rhsFile{ rhsFilePath, std::ios::ate | std::ios::binary };
+
+	// Two missing files are equal, so textures without a cooked version compare by their source only
+	if (!lhsFile.is_open() || !rhsFile.is_open()) return lhsFile.is_open() == rhsFile.is_open();
+	if (lhsFile.tellg() != rhsFile.tellg()) return false;
+
+	lhsFile.seekg(0);
+	rhsFile.seekg(0);
+	return std::equal(std::istreambuf_iterator<char>{ lhsFile }, std::istreambuf_iterator<char>{}, std::istreambuf_iterator<char>{ rhsFile });
+}
+
+uint64_t AssetRegistry::HashBytes(const void* data, size_t size, uint64_t hash)
+{
+	// FNV-1a
+	const uint8_t* pBytes{ static_cast<const uint8_t*>(data) };
+	for (size_t byteIdx{}; byteIdx < size; ++byteIdx)
+	{
+		hash ^= pBytes[byteIdx];
+		hash *= s_FnvPrime;
+	}
+	return hash;
+}
+
+uint64_t AssetRegistry::GetSamplerKey(const SamplerConfigs& configs)
+{
+	uint32_t maxLodBits{};
+	std::memcpy(&maxLodBits, &configs.maxLod, sizeof(maxLodBits));
+
+	return static_cast<uint64_t>(configs.filter)
+		| (static_cast<uint64_t>(configs.addressMode) << 8)
+		| (static_cast<uint64_t>(configs.anisotropyEnable) << 16)
+		| (static_cast<uint64_t>(maxLodBits) << 32);
+}
+
+SamplerConfigs AssetRegistry::GetTextureSamplerConfigs()
+{
+	// No lod clamp so one sampler serves textures with any number of mip levels
+	SamplerConfigs configs{};
+	configs.maxLod = VK_LOD_CLAMP_NONE;
+	return configs;
+}
\ No newline at end of file
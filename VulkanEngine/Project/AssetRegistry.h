@@ -0,0 +1,96 @@
+#ifndef ASSETREGISTRY_H
+#define ASSETREGISTRY_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "Singleton.h"
+#include "VulkanStructs.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "Sampler.h"
+
+class CommandPool;
+class VulkanInstance;
+
+// Reference counted cache of GPU assets. Assets are keyed by their content hash, and file backed
+// assets are additionally indexed by canonical path, so repeated references share a single upload.
+// Unreferenced assets are handed to the DeletionQueue, so they can be released while frames are in flight.
+class AssetRegistry final : public Singleton<AssetRegistry>
+{
+public:
+
+	virtual ~AssetRegistry() = default;
+
+	AssetRegistry(const AssetRegistry& other) = delete;
+	AssetRegistry(AssetRegistry&& other) noexcept = delete;
+	AssetRegistry& operator=(const AssetRegistry& other) = delete;
+	AssetRegistry& operator=(AssetRegistry&& other) noexcept = delete;
+
+	void Destroy(VkDevice device);
+
+	const Mesh* AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath, VertexType vertexType);
+	const Mesh* AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices);
+	const Mesh* AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices);
+	void ReleaseMesh(const Mesh* pMesh);
+
+	const Texture* AcquireTexture(const VulkanInstance& instance, const std::string& filePath);
+	void ReleaseTexture(const Texture* pTexture);
+	// Key the texture is registered under, stays the same for every acquire of the same content
+	uint64_t GetTextureKey(const Texture* pTexture) const;
+
+	const Sampler* AcquireSampler(VkDevice device, VkPhysicalDevice phyDevice, const SamplerConfigs& configs);
+	void ReleaseSampler(const Sampler* pSampler);
+
+	AssetResidencyStats GetResidencyStats() const;
+	void PrintResidencyStats() const;
+
+private:
+
+	friend class Singleton<AssetRegistry>;
+	AssetRegistry();
+
+	template<typename AssetType>
+	struct Entry
+	{
+		std::unique_ptr<AssetType> pAsset{};
+		uint32_t refCount{};
+		VkDeviceSize sizeInBytes{};
+		std::string filePath{}; // Canonical source path of file backed assets, empty for assets created from memory
+	};
+
+	const Mesh* AcquireMesh(const VulkanInstance& instance, const CommandPool& commandPool, uint64_t key, const void* vertexData, VkDeviceSize vertexDataSize, const std::vector<uint32_t>& indices, const AABB& bounds);
+	const Mesh* FindMesh(uint64_t key);
+	const Texture* FindTexture(uint64_t key);
+
+	// A different file under the key of an asset is either a copy with the same content or a hash collision, a collision gets a new key
+	uint64_t ResolveMeshKey(uint64_t key, const std::string& filePath) const;
+	uint64_t ResolveTextureKey(uint64_t key, const std::string& filePath) const;
+
+	static std::string GetCanonicalPath(const std::string& filePath);
+	static uint64_t HashFile(const std::string& filePath, uint64_t hash);
+	static uint64_t HashTextureFiles(const std::string& filePath);
+	static bool AreFilesEqual(const std::string& lhsFilePath, const std::string& rhsFilePath);
+	static uint64_t HashBytes(const void* data, size_t size, uint64_t hash);
+	static uint64_t GetSamplerKey(const SamplerConfigs& configs);
+	static SamplerConfigs GetTextureSamplerConfigs();
+
+private:
+
+	std::unordered_map<uint64_t, Entry<Mesh>> m_Meshes;
+	std::unordered_map<uint64_t, Entry<Texture>> m_Textures;
+	std::unordered_map<uint64_t, Entry<Sampler>> m_Samplers;
+
+	// Canonical path (+ vertex type) to content key, avoids hashing a file that was already loaded
+	std::unordered_map<std::string, uint64_t> m_PathKeys;
+
+	uint64_t m_CacheHits;
+	uint64_t m_CacheMisses;
+
+};
+
+#endif // !ASSETREGISTRY_H
\ No newline at end of file
@@ -0,0 +1,506 @@
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+#include <array>
+#include <cfloat>
+
+#include "BVH.h"
+#include "JobSystem.h"
+
+namespace
+{
+	constexpr uint32_t s_BinCount{ 16 };
+	constexpr uint32_t s_MaxLeafPrimitives{ 4 };
+	// Keeps every traversal within the fixed size stack, a stack never holds more entries than the depth + 1
+	constexpr uint32_t s_MaxDepth{ 48 };
+	constexpr uint32_t s_StackSize{ 64 };
+	constexpr uint32_t s_ParallelBuildThreshold{ 2048 };
+	// A subtree is rebuilt once its surface area grew past this factor of the area it was built with
+	constexpr float s_RebuildAreaRatio{ 2.f };
+	// Marks the stack entries of nodes that are completely inside the frustum
+	constexpr uint32_t s_InsideFlag{ 0x80000000u };
+
+	uint32_t GetBinIndex(float centroid, float centroidMin, float binScale)
+	{
+		return std::min(static_cast<uint32_t>((centroid - centroidMin) * binScale), s_BinCount - 1);
+	}
+
+	AABB GetNodeBounds(const BVHNode& node)
+	{
+		return AABB{ node.boundsMin, node.boundsMax };
+	}
+
+	// Slab test, returns FLT_MAX when the bounds are missed or further away than maxDistance
+	float IntersectBounds(const Ray& ray, const glm::vec3& inverseDirection, const glm::vec3& boundsMin, const glm::vec3& boundsMax, float maxDistance)
+	{
+		const glm::vec3 t1{ (boundsMin - ray.origin) * inverseDirection };
+		const glm::vec3 t2{ (boundsMax - ray.origin) * inverseDirection };
+
+		const float tMin{ std::max({ std::min(t1.x, t2.x), std::min(t1.y, t2.y), std::min(t1.z, t2.z), 0.f }) };
+		const float tMax{ std::min({ std::max(t1.x, t2.x), std::max(t1.y, t2.y), std::max(t1.z, t2.z) }) };
+
+		return tMax >= tMin && tMin < maxDistance ? tMin : FLT_MAX;
+	}
+}
+
+BVH::BVH()
+	: m_Nodes{}
+	, m_PrimitiveIndices{}
+	, m_PrimitiveBounds{}
+	, m_Centroids{}
+	, m_BuildAreas{}
+	, m_NodeDepths{}
+	, m_UnusedNodeCount{}
+{
+}
+
+void BVH::Clear()
+{
+	m_Nodes.clear();
+	m_PrimitiveIndices.clear();
+	m_PrimitiveBounds.clear();
+	m_Centroids.clear();
+	m_BuildAreas.clear();
+	m_NodeDepths.clear();
+	m_UnusedNodeCount = 0;
+}
+
+void BVH::Build(std::span<const AABB> bounds, JobSystem* pJobSystem)
+{
+	Clear();
+
+	const uint32_t primitiveCount{ static_cast<uint32_t>(bounds.size()) };
+	if (primitiveCount == 0) return;
+
+	m_PrimitiveBounds.assign(bounds.begin(), bounds.end());
+	m_PrimitiveIndices.resize(primitiveCount);
+	std::iota(m_PrimitiveIndices.begin(), m_PrimitiveIndices.end(), 0u);
+
+	m_Centroids.resize(primitiveCount);
+	for (uint32_t primitiveIdx{}; primitiveIdx < primitiveCount; ++primitiveIdx)
+	{
+		m_Centroids[primitiveIdx] = bounds[primitiveIdx].GetCenter();
+	}
+
+	// A binary tree with at least one primitive per leaf never has more than 2n - 1 nodes,
+	// reserving them up front lets the build jobs hand out node pairs with an atomic counter
+	const uint32_t maxNodeCount{ 2 * primitiveCount - 1 };
+	m_Nodes.resize(maxNodeCount);
+	m_BuildAreas.resize(maxNodeCount);
+	m_NodeDepths.resize(maxNodeCount);
+
+	m_Nodes[0].leftOrFirst = 0;
+	m_Nodes[0].primitiveCount = primitiveCount;
+
+	std::atomic<uint32_t> nodeCount{ 1 };
+	JobCounter counter{};
+	BuildContext context{ nodeCount, pJobSystem, pJobSystem ? &counter : nullptr };
+
+	Subdivide(0, 0, context);
+	if (pJobSystem) pJobSystem->Wait(counter);
+
+	m_Nodes.resize(nodeCount);
+	m_BuildAreas.resize(nodeCount);
+	m_NodeDepths.resize(nodeCount);
+}
+
+void BVH::Refit(std::span<const AABB> bounds)
+{
+	if (bounds.size() != m_PrimitiveBounds.size()) throw std::runtime_error{ "BVH: refit with a different primitive count than the tree was built with!" };
+	if (m_Nodes.empty()) return;
+
+	std::copy(bounds.begin(), bounds.end(), m_PrimitiveBounds.begin());
+	for (uint32_t primitiveIdx{}; primitiveIdx < bounds.size(); ++primitiveIdx)
+	{
+		m_Centroids[primitiveIdx] = bounds[primitiveIdx].GetCenter();
+	}
+
+	// Children always come after their parent, walking backwards refits them before their parent is reached
+	for (uint32_t nodeIdx{ static_cast<uint32_t>(m_Nodes.size()) }; nodeIdx-- > 0;)
+	{
+		BVHNode& node{ m_Nodes[nodeIdx] };
+		if (node.IsLeaf())
+		{
+			UpdateNodeBounds(nodeIdx);
+			continue;
+		}
+
+		const BVHNode& left{ m_Nodes[node.leftOrFirst] };
+		const BVHNode& right{ m_Nodes[node.leftOrFirst + 1] };
+		node.boundsMin = glm::min(left.boundsMin, right.boundsMin);
+		node.boundsMax = glm::max(left.boundsMax, right.boundsMax);
+	}
+
+	RebuildDegradedNodes();
+}
+
+void BVH::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& primitives) const
+{
+	if (m_Nodes.empty()) return;
+
+	std::array<uint32_t, s_StackSize> stack{};
+	uint32_t stackSize{};
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const uint32_t entry{ stack[--stackSize] };
+		const BVHNode& node{ m_Nodes[entry & ~s_InsideFlag] };
+
+		// Everything below a node that is completely inside is visible without further plane tests
+		bool inside{ (entry & s_InsideFlag) != 0 };
+		if (!inside)
+		{
+			const FrustumTest result{ frustum.Test(GetNodeBounds(node)) };
+			if (result == FrustumTest::Outside) continue;
+			inside = result == FrustumTest::Inside;
+		}
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t idx{ node.leftOrFirst }; idx < node.leftOrFirst + node.primitiveCount; ++idx)
+			{
+				const uint32_t primitiveIdx{ m_PrimitiveIndices[idx] };
+				if (inside || frustum.Test(m_PrimitiveBounds[primitiveIdx]) != FrustumTest::Outside) primitives.emplace_back(primitiveIdx);
+			}
+			continue;
+		}
+
+		const uint32_t flag{ inside ? s_InsideFlag : 0u };
+		stack[stackSize++] = node.leftOrFirst | flag;
+		stack[stackSize++] = (node.leftOrFirst + 1) | flag;
+	}
+}
+
+void BVH::QueryOverlap(const AABB& bounds, std::vector<uint32_t>& primitives) const
+{
+	if (m_Nodes.empty()) return;
+
+	std::array<uint32_t, s_StackSize> stack{};
+	uint32_t stackSize{};
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BVHNode& node{ m_Nodes[stack[--stackSize]] };
+		if (!bounds.Overlaps(GetNodeBounds(node))) continue;
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t idx{ node.leftOrFirst }; idx < node.leftOrFirst + node.primitiveCount; ++idx)
+			{
+				const uint32_t primitiveIdx{ m_PrimitiveIndices[idx] };
+				if (bounds.Overlaps(m_PrimitiveBounds[primitiveIdx])) primitives.emplace_back(primitiveIdx);
+			}
+			continue;
+		}
+
+		stack[stackSize++] = node.leftOrFirst;
+		stack[stackSize++] = node.leftOrFirst + 1;
+	}
+}
+
+bool BVH::Raycast(const Ray& ray, BVHHit& hit) const
+{
+	hit = BVHHit{};
+	hit.distance = ray.maxDistance;
+	if (m_Nodes.empty()) return false;
+
+	const glm::vec3 inverseDirection{ 1.f / ray.direction.x, 1.f / ray.direction.y, 1.f / ray.direction.z };
+
+	const float rootDistance{ IntersectBounds(ray, inverseDirection, m_Nodes[0].boundsMin, m_Nodes[0].boundsMax, hit.distance) };
+	if (rootDistance == FLT_MAX) return false;
+
+	std::array<uint32_t, s_StackSize> stack{};
+	std::array<float, s_StackSize> stackDistances{};
+	uint32_t stackSize{};
+	stack[stackSize] = 0;
+	stackDistances[stackSize++] = rootDistance;
+
+	while (stackSize > 0)
+	{
+		--stackSize;
+
+		// A closer hit may have been found since the node was pushed
+		if (stackDistances[stackSize] >= hit.distance) continue;
+		const BVHNode& node{ m_Nodes[stack[stackSize]] };
+
+		if (node.IsLeaf())
+		{
+			for (uint32_t idx{ node.leftOrFirst }; idx < node.leftOrFirst + node.primitiveCount; ++idx)
+			{
+				const uint32_t primitiveIdx{ m_PrimitiveIndices[idx] };
+				const AABB& bounds{ m_PrimitiveBounds[primitiveIdx] };
+
+				const float distance{ IntersectBounds(ray, inverseDirection, bounds.min, bounds.max, hit.distance) };
+				if (distance < hit.distance)
+				{
+					hit.primitive = primitiveIdx;
+					hit.distance = distance;
+				}
+			}
+			continue;
+		}
+
+		uint32_t nearIdx{ node.leftOrFirst };
+		uint32_t farIdx{ node.leftOrFirst + 1 };
+		float nearDistance{ IntersectBounds(ray, inverseDirection, m_Nodes[nearIdx].boundsMin, m_Nodes[nearIdx].boundsMax, hit.distance) };
+		float farDistance{ IntersectBounds(ray, inverseDirection, m_Nodes[farIdx].boundsMin, m_Nodes[farIdx].boundsMax, hit.distance) };
+		if (farDistance < nearDistance)
+		{
+			std::swap(nearIdx, farIdx);
+			std::swap(nearDistance, farDistance);
+		}
+
+		// The nearest child is pushed last so it is visited first
+		if (farDistance != FLT_MAX)
+		{
+			stack[stackSize] = farIdx;
+			stackDistances[stackSize++] = farDistance;
+		}
+		if (nearDistance != FLT_MAX)
+		{
+			stack[stackSize] = nearIdx;
+			stackDistances[stackSize++] = nearDistance;
+		}
+	}
+
+	return hit.primitive != UINT32_MAX;
+}
+
+uint32_t BVH::GetPrimitiveCount() const
+{
+	return static_cast<uint32_t>(m_PrimitiveIndices.size());
+}
+
+uint32_t BVH::GetNodeCount() const
+{
+	return static_cast<uint32_t>(m_Nodes.size()) - m_UnusedNodeCount;
+}
+
+const std::vector<BVHNode>& BVH::GetNodes() const
+{
+	return m_Nodes;
+}
+
+// Private Functions //
+void BVH::Subdivide(uint32_t nodeIdx, uint32_t depth, BuildContext& context)
+{
+	UpdateNodeBounds(nodeIdx);
+
+	BVHNode& node{ m_Nodes[nodeIdx] };
+	m_BuildAreas[nodeIdx] = GetNodeBounds(node).GetSurfaceArea();
+	m_NodeDepths[nodeIdx] = depth;
+
+	if (node.primitiveCount <= 1 || depth >= s_MaxDepth) return;
+
+	Split split{};
+	if (!FindSplit(node, split)) return;
+
+	// Small nodes stay a leaf when testing their primitives is cheaper than testing two children
+	const float leafCost{ node.primitiveCount * m_BuildAreas[nodeIdx] };
+	if (split.cost >= leafCost && node.primitiveCount <= s_MaxLeafPrimitives) return;
+
+	const uint32_t first{ node.leftOrFirst };
+	uint32_t* pFirst{ m_PrimitiveIndices.data() + first };
+	const uint32_t* pMiddle{ std::partition(pFirst, pFirst + node.primitiveCount, [this, &split](uint32_t primitiveIdx)
+	{
+		return GetBinIndex(m_Centroids[primitiveIdx][split.axis], split.centroidMin, split.binScale) < split.bin;
+	}) };
+
+	const uint32_t leftCount{ static_cast<uint32_t>(pMiddle - pFirst) };
+	const uint32_t rightCount{ node.primitiveCount - leftCount };
+
+	const uint32_t leftIdx{ context.nodeCount.fetch_add(2) };
+	m_Nodes[leftIdx].leftOrFirst = first;
+	m_Nodes[leftIdx].primitiveCount = leftCount;
+	m_Nodes[leftIdx + 1].leftOrFirst = first + leftCount;
+	m_Nodes[leftIdx + 1].primitiveCount = rightCount;
+
+	node.leftOrFirst = leftIdx;
+	node.primitiveCount = 0;
+
+	// The subtrees work on disjoint nodes and primitive ranges, large ones are built in parallel
+	if (context.pJobSystem && leftCount >= s_ParallelBuildThreshold)
+	{
+		context.pJobSystem->Schedule([this, leftIdx, depth, &context]() { Subdivide(leftIdx, depth + 1, context); }, context.pCounter);
+	}
+	else Subdivide(leftIdx, depth + 1, context);
+
+	Subdivide(leftIdx + 1, depth + 1, context);
+}
+
+bool BVH::FindSplit(const BVHNode& node, Split& split) const
+{
+	struct Bin
+	{
+		AABB bounds{};
+		uint32_t count{};
+	};
+
+	const uint32_t first{ node.leftOrFirst };
+	const uint32_t last{ node.leftOrFirst + node.primitiveCount };
+
+	AABB centroidBounds{};
+	for (uint32_t idx{ first }; idx < last; ++idx)
+	{
+		centroidBounds.Grow(m_Centroids[m_PrimitiveIndices[idx]]);
+	}
+
+	bool found{ false };
+	for (int axis{}; axis < 3; ++axis)
+	{
+		const float extent{ centroidBounds.max[axis] - centroidBounds.min[axis] };
+		if (extent <= 0.f) continue;
+
+		const float binScale{ s_BinCount / extent };
+
+		std::array<Bin, s_BinCount> bins{};
+		for (uint32_t idx{ first }; idx < last; ++idx)
+		{
+			const uint32_t primitiveIdx{ m_PrimitiveIndices[idx] };
+			Bin& bin{ bins[GetBinIndex(m_Centroids[primitiveIdx][axis], centroidBounds.min[axis], binScale)] };
+			bin.bounds.Grow(m_PrimitiveBounds[primitiveIdx]);
+			++bin.count;
+		}
+
+		// Sweep from both sides, plane i lies between bin i and bin i + 1
+		std::array<float, s_BinCount - 1> leftAreas{};
+		std::array<float, s_BinCount - 1> rightAreas{};
+		std::array<uint32_t, s_BinCount - 1> leftCounts{};
+		std::array<uint32_t, s_BinCount - 1> rightCounts{};
+
+		AABB leftBounds{};
+		AABB rightBounds{};
+		uint32_t leftCount{};
+		uint32_t rightCount{};
+		for (uint32_t planeIdx{}; planeIdx < s_BinCount - 1; ++planeIdx)
+		{
+			leftBounds.Grow(bins[planeIdx].bounds);
+			leftCount += bins[planeIdx].count;
+			leftAreas[planeIdx] = leftBounds.GetSurfaceArea();
+			leftCounts[planeIdx] = leftCount;
+
+			const uint32_t rightPlaneIdx{ s_BinCount - 2 - planeIdx };
+			rightBounds.Grow(bins[rightPlaneIdx + 1].bounds);
+			rightCount += bins[rightPlaneIdx + 1].count;
+			rightAreas[rightPlaneIdx] = rightBounds.GetSurfaceArea();
+			rightCounts[rightPlaneIdx] = rightCount;
+		}
+
+		for (uint32_t planeIdx{}; planeIdx < s_BinCount - 1; ++planeIdx)
+		{
+			if (leftCounts[planeIdx] == 0 || rightCounts[planeIdx] == 0) continue;
+
+			const float cost{ leftCounts[planeIdx] * leftAreas[planeIdx] + rightCounts[planeIdx] * rightAreas[planeIdx] };
+			if (cost >= split.cost) continue;
+
+			split.axis = axis;
+			split.bin = planeIdx + 1;
+			split.centroidMin = centroidBounds.min[axis];
+			split.binScale = binScale;
+			split.cost = cost;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+void BVH::UpdateNodeBounds(uint32_t nodeIdx)
+{
+	BVHNode& node{ m_Nodes[nodeIdx] };
+
+	AABB bounds{};
+	for (uint32_t idx{ node.leftOrFirst }; idx < node.leftOrFirst + node.primitiveCount; ++idx)
+	{
+		bounds.Grow(m_PrimitiveBounds[m_PrimitiveIndices[idx]]);
+	}
+
+	node.boundsMin = bounds.min;
+	node.boundsMax = bounds.max;
+}
+
+void BVH::RebuildDegradedNodes()
+{
+	if (GetNodeBounds(m_Nodes[0]).GetSurfaceArea() > m_BuildAreas[0] * s_RebuildAreaRatio)
+	{
+		const std::vector<AABB> bounds{ std::move(m_PrimitiveBounds) };
+		Build(bounds);
+		return;
+	}
+
+	// Only the topmost degraded node of every path is rebuilt, that already rebuilds everything below it
+	std::array<uint32_t, s_StackSize> stack{};
+	uint32_t stackSize{};
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const uint32_t nodeIdx{ stack[--stackSize] };
+		const BVHNode node{ m_Nodes[nodeIdx] };
+		if (node.IsLeaf()) continue;
+
+		if (GetNodeBounds(node).GetSurfaceArea() > m_BuildAreas[nodeIdx] * s_RebuildAreaRatio)
+		{
+			RebuildNode(nodeIdx);
+			continue;
+		}
+
+		stack[stackSize++] = node.leftOrFirst;
+		stack[stackSize++] = node.leftOrFirst + 1;
+	}
+
+	// The replaced subtrees stay behind in the node array, compact it once they make up a large part of it
+	if (m_UnusedNodeCount > GetPrimitiveCount())
+	{
+		const std::vector<AABB> bounds{ std::move(m_PrimitiveBounds) };
+		Build(bounds);
+	}
+}
+
+void BVH::RebuildNode(uint32_t nodeIdx)
+{
+	// The primitives of a subtree are contiguous, collapse it into a leaf over their range and subdivide that again
+	uint32_t first{ UINT32_MAX };
+	uint32_t primitiveCount{};
+
+	std::array<uint32_t, s_StackSize> stack{};
+	uint32_t stackSize{};
+	stack[stackSize++] = nodeIdx;
+
+	while (stackSize > 0)
+	{
+		const uint32_t currentIdx{ stack[--stackSize] };
+		const BVHNode& node{ m_Nodes[currentIdx] };
+		if (currentIdx != nodeIdx) ++m_UnusedNodeCount;
+
+		if (node.IsLeaf())
+		{
+			first = std::min(first, node.leftOrFirst);
+			primitiveCount += node.primitiveCount;
+			continue;
+		}
+
+		stack[stackSize++] = node.leftOrFirst;
+		stack[stackSize++] = node.leftOrFirst + 1;
+	}
+
+	m_Nodes[nodeIdx].leftOrFirst = first;
+	m_Nodes[nodeIdx].primitiveCount = primitiveCount;
+
+	// The new children are appended, so they still come after their parent
+	const uint32_t usedNodeCount{ static_cast<uint32_t>(m_Nodes.size()) };
+	const uint32_t maxNodeCount{ usedNodeCount + 2 * primitiveCount - 2 };
+	m_Nodes.resize(maxNodeCount);
+	m_BuildAreas.resize(maxNodeCount);
+	m_NodeDepths.resize(maxNodeCount);
+
+	std::atomic<uint32_t> nodeCount{ usedNodeCount };
+	BuildContext context{ nodeCount };
+	Subdivide(nodeIdx, m_NodeDepths[nodeIdx], context);
+
+	m_Nodes.resize(nodeCount);
+	m_BuildAreas.resize(nodeCount);
+	m_NodeDepths.resize(nodeCount);
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <vector>
+#include <span>
+#include <atomic>
+#include <cstdint>
+#include <cfloat>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+class JobSystem;
+class JobCounter;
+
+// 32 bytes, two nodes share a cache line. Children are stored next to each other, so an interior node
+// only keeps the index of its left child. Leaves point into the primitive index array instead.
+struct BVHNode
+{
+	glm::vec3 boundsMin{};
+	uint32_t leftOrFirst{};
+	glm::vec3 boundsMax{};
+	uint32_t primitiveCount{};
+
+	bool IsLeaf() const { return primitiveCount > 0; }
+};
+
+struct BVHHit
+{
+	uint32_t primitive{ UINT32_MAX };
+	float distance{ FLT_MAX };
+};
+
+// Bounding volume hierarchy over a set of primitive bounds, built top down with a binned surface area heuristic.
+// Nodes are flattened in one array where every child comes after its parent, which lets Refit run as a single reverse pass.
+// Subtrees whose bounds grew too much since they were built are rebuilt in place during Refit.
+class BVH final
+{
+public:
+
+	BVH();
+	~BVH() = default;
+
+	BVH(const BVH& other) = default;
+	BVH(BVH&& other) noexcept = default;
+	BVH& operator=(const BVH& other) = default;
+	BVH& operator=(BVH&& other) noexcept = default;
+
+	void Clear();
+
+	// Subtrees above a size threshold are built as jobs when a job system is passed
+	void Build(std::span<const AABB> bounds, JobSystem* pJobSystem = nullptr);
+	// The primitives have to be the same as the ones the tree was built with, only their bounds may change
+	void Refit(std::span<const AABB> bounds);
+
+	void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& primitives) const;
+	void QueryOverlap(const AABB& bounds, std::vector<uint32_t>& primitives) const;
+	// Nearest primitive bounds hit by the ray, returns false when nothing was hit
+	bool Raycast(const Ray& ray, BVHHit& hit) const;
+
+	uint32_t GetPrimitiveCount() const;
+	uint32_t GetNodeCount() const;
+	const std::vector<BVHNode>& GetNodes() const;
+
+private:
+
+	struct BuildContext
+	{
+		std::atomic<uint32_t>& nodeCount;
+		JobSystem* pJobSystem{ nullptr };
+		JobCounter* pCounter{ nullptr };
+	};
+
+	struct Split
+	{
+		int axis{};
+		uint32_t bin{};
+		float centroidMin{};
+		float binScale{};
+		float cost{ FLT_MAX };
+	};
+
+	void Subdivide(uint32_t nodeIdx, uint32_t depth, BuildContext& context);
+	bool FindSplit(const BVHNode& node, Split& split) const;
+	void UpdateNodeBounds(uint32_t nodeIdx);
+
+	void RebuildDegradedNodes();
+	void RebuildNode(uint32_t nodeIdx);
+
+private:
+
+	std::vector<BVHNode> m_Nodes;
+	std::vector<uint32_t> m_PrimitiveIndices;
+	std::vector<AABB> m_PrimitiveBounds;
+	std::vector<glm::vec3> m_Centroids;
+
+	// Surface area of every node when it was (re)built, to detect degraded subtrees
+	std::vector<float> m_BuildAreas;
+	std::vector<uint32_t> m_NodeDepths;
+	uint32_t m_UnusedNodeCount;
+
+};
+
+#endif // !BVH_H
\ No newline at end of file
@@ -0,0 +1,141 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <array>
+#include <vector>
+#include <cfloat>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+
+struct AABB
+{
+	glm::vec3 min{ FLT_MAX };
+	glm::vec3 max{ -FLT_MAX };
+
+	bool IsValid() const
+	{
+		return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+	}
+
+	void Grow(const glm::vec3& point)
+	{
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	}
+
+	void Grow(const AABB& other)
+	{
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	}
+
+	glm::vec3 GetCenter() const
+	{
+		return (min + max) * 0.5f;
+	}
+
+	glm::vec3 GetExtent() const
+	{
+		return (max - min) * 0.5f;
+	}
+
+	float GetSurfaceArea() const
+	{
+		if (!IsValid()) return 0.f;
+
+		const glm::vec3 size{ max - min };
+		return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool Overlaps(const AABB& other) const
+	{
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y &&
+			min.z <= other.max.z && max.z >= other.min.z;
+	}
+
+	// Bounds of the transformed box, the extent is projected on the absolute axes of the matrix
+	AABB Transform(const glm::mat4& matrix) const
+	{
+		if (!IsValid()) return AABB{};
+
+		const glm::vec3 center{ GetCenter() };
+		const glm::vec3 extent{ GetExtent() };
+
+		const glm::vec3 newCenter{ glm::vec3{ matrix[0] } * center.x + glm::vec3{ matrix[1] } * center.y + glm::vec3{ matrix[2] } * center.z + glm::vec3{ matrix[3] } };
+		const glm::vec3 newExtent{ glm::abs(glm::vec3{ matrix[0] }) * extent.x + glm::abs(glm::vec3{ matrix[1] }) * extent.y + glm::abs(glm::vec3{ matrix[2] }) * extent.z };
+
+		return AABB{ newCenter - newExtent, newCenter + newExtent };
+	}
+
+	template<typename VertexType>
+	static AABB FromVertices(const std::vector<VertexType>& vertices)
+	{
+		AABB bounds{};
+		for (const VertexType& vertex : vertices) bounds.Grow(vertex.pos);
+		return bounds;
+	}
+};
+
+struct Ray
+{
+	glm::vec3 origin{};
+	glm::vec3 direction{ 0.f, 0.f, 1.f };
+	float maxDistance{ FLT_MAX };
+};
+
+enum class FrustumTest
+{
+	Outside,
+	Intersecting,
+	Inside
+};
+
+// Planes point inwards, a point p is inside a plane when dot(normal, p) + distance >= 0
+struct Frustum
+{
+	std::array<glm::vec4, 6> planes{};
+
+	// Gribb/Hartmann plane extraction for a [0, 1] depth range projection
+	static Frustum FromViewProjection(const glm::mat4& viewProjection)
+	{
+		const auto row{ [&viewProjection](int rowIdx)
+		{
+			return glm::vec4{ viewProjection[0][rowIdx], viewProjection[1][rowIdx], viewProjection[2][rowIdx], viewProjection[3][rowIdx] };
+		} };
+
+		Frustum frustum{};
+		frustum.planes[0] = row(3) + row(0); // Left
+		frustum.planes[1] = row(3) - row(0); // Right
+		frustum.planes[2] = row(3) + row(1); // Bottom
+		frustum.planes[3] = row(3) - row(1); // Top
+		frustum.planes[4] = row(2);          // Near
+		frustum.planes[5] = row(3) - row(2); // Far
+
+		for (glm::vec4& plane : frustum.planes)
+		{
+			plane = plane * (1.f / glm::length(glm::vec3{ plane }));
+		}
+		return frustum;
+	}
+
+	FrustumTest Test(const AABB& bounds) const
+	{
+		FrustumTest result{ FrustumTest::Inside };
+		for (const glm::vec4& plane : planes)
+		{
+			const glm::vec3 normal{ plane };
+
+			// The corner furthest along the normal decides if the box is outside, the nearest one if it is inside
+			const glm::vec3 positive{ normal.x >= 0.f ? bounds.max.x : bounds.min.x, normal.y >= 0.f ? bounds.max.y : bounds.min.y, normal.z >= 0.f ? bounds.max.z : bounds.min.z };
+			if (glm::dot(normal, positive) + plane.w < 0.f) return FrustumTest::Outside;
+
+			const glm::vec3 negative{ normal.x >= 0.f ? bounds.min.x : bounds.max.x, normal.y >= 0.f ? bounds.min.y : bounds.max.y, normal.z >= 0.f ? bounds.min.z : bounds.max.z };
+			if (glm::dot(normal, negative) + plane.w < 0.f) result = FrustumTest::Intersecting;
+		}
+		return result;
+	}
+};
+
+#endif // !BOUNDS_H
\ No newline at end of file
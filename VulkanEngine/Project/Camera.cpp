@@ -10,6 +10,7 @@
 #include "Camera.h"
 #include "VulkanStructs.h"
 #include "VulkanUtils.h"
+#include "EngineSettings.h"
 #include "Timer.h"
 #include "Window.h"
 #include "VulkanInstance.h"
@@ -42,7 +43,7 @@ void Camera::Initialize(const VulkanInstance& instance, const Window& window)
 
     VkDeviceSize bufferSize{ sizeof(CameraUBO) };
 
-    m_UniformBuffers.resize(g_MaxFramesInFlight);
+    m_UniformBuffers.resize(EngineSettings::Get().GetMaxFramesInFlight());
 
     VkBufferUsageFlags uniformBuffersUsage{ VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT };
     VkMemoryPropertyFlags uniformBuffersProperties
@@ -51,7 +52,7 @@ void Camera::Initialize(const VulkanInstance& instance, const Window& window)
         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
     };
 
-    for (size_t idx{}; idx < g_MaxFramesInFlight; idx++)
+    for (size_t idx{}; idx < EngineSettings::Get().GetMaxFramesInFlight(); idx++)
     {
         m_UniformBuffers[idx].Initialize(device, phyDevice, uniformBuffersProperties, bufferSize, uniformBuffersUsage);
         UpdateUniformBufferObjects(device, static_cast<uint32_t>(idx));
@@ -66,7 +67,7 @@ void Camera::Destroy(VkDevice device)
     }
 }
 
-void Camera::Update(VkDevice device, uint32_t currentFrame)
+void Camera::Update()
 {
     m_InputState.keyChange = false;
     m_InputState.mouseChange = false;
@@ -131,7 +132,6 @@ void Camera::Update(VkDevice device, uint32_t currentFrame)
     {
         UpdateCameraVectors();
     }
-    UpdateUniformBufferObjects(device, currentFrame);
 }
 
 const std::vector<DataBuffer>& Camera::GetUniformBuffers() const
@@ -144,6 +144,16 @@ const glm::vec3& Camera::GetDirection() const
     return m_Front;
 }
 
+Frustum Camera::GetFrustum() const
+{
+    return Frustum::FromViewProjection(m_CameraMatrix.proj * m_CameraMatrix.view);
+}
+
+DrawView Camera::GetDrawView() const
+{
+    return DrawView{ m_Position, m_Front, m_Far };
+}
+
 void Camera::UpdateCameraVectors()
 {
     // Set Correct Variables
@@ -16,6 +16,7 @@
 
 #include "VulkanStructs.h"
 #include "DataBuffer.h"
+#include "DrawList.h"
 
 class VulkanInstance;
 class Window;
@@ -30,15 +31,19 @@ public:
     void Initialize(const VulkanInstance& instance, const Window& window);
     void Destroy(VkDevice device);
 
-    void Update(VkDevice device, uint32_t currentFrame);
+    // Input has to be processed on the thread that created the window, the uniform buffer upload can run on any thread
+    void Update();
+    void UpdateUniformBufferObjects(VkDevice device, uint32_t currentFrame);
 
     const std::vector<DataBuffer>& GetUniformBuffers() const;
     const glm::vec3& GetDirection() const;
+    // World space view frustum of the matrices computed by the last Update
+    Frustum GetFrustum() const;
+    DrawView GetDrawView() const;
 
 private:
 
     void UpdateCameraVectors();
-    void UpdateUniformBufferObjects(VkDevice device, uint32_t currentFrame);
 
 private:
 
@@ -54,6 +54,20 @@ void CommandBuffer::BeginRecording(VkCommandBufferUsageFlags usage) const
     }
 }
 
+void CommandBuffer::BeginRecording(const VkCommandBufferInheritanceInfo& inheritanceInfo, VkCommandBufferUsageFlags usage) const
+{
+    // Secondary command buffers need to know the render pass and framebuffer they will be executed in
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = usage;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(m_VkCommandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording secondary command buffer!");
+    }
+}
+
 void CommandBuffer::EndRecording() const
 {
     if (vkEndCommandBuffer(m_VkCommandBuffer) != VK_SUCCESS)
@@ -72,6 +86,13 @@ void CommandBuffer::EndRenderPass() const
     vkCmdEndRenderPass(m_VkCommandBuffer);
 }
 
+void CommandBuffer::ExecuteCommands(const std::vector<VkCommandBuffer>& secondaryCommandBuffers) const
+{
+    if (secondaryCommandBuffers.empty()) return;
+
+    vkCmdExecuteCommands(m_VkCommandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+}
+
 void CommandBuffer::Submit(VkQueue queue, VkFence fence) const
 {
     VkSubmitInfo submitInfo{};
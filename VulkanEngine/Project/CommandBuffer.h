@@ -1,6 +1,8 @@
 #ifndef COMMANDBUFFER_H
 #define COMMANDBUFFER_H
 
+#include <vector>
+
 #include "vulkan/vulkan.h"
 
 class CommandPool;
@@ -19,11 +21,14 @@ public:
 
 	void Reset(VkCommandBufferResetFlags flags = 0) const;
 	void BeginRecording(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) const;
+	void BeginRecording(const VkCommandBufferInheritanceInfo& inheritanceInfo, VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT) const;
 	void EndRecording() const;
 
 	void BeginRenderPass(const VkRenderPassBeginInfo& renderPassInfo, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) const;
 	void EndRenderPass() const;
 
+	void ExecuteCommands(const std::vector<VkCommandBuffer>& secondaryCommandBuffers) const;
+
 	void Submit(VkQueue queue, VkFence fence) const;
 	void Submit(VkSubmitInfo& submitInfo, VkQueue queue, VkFence fence) const;
 
@@ -9,7 +9,7 @@ CommandPool::CommandPool()
 {
 }
 
-void CommandPool::Initialize(const VulkanInstance& instance)
+void CommandPool::Initialize(const VulkanInstance& instance, VkCommandPoolCreateFlags flags)
 {
 	const VkDevice& device{ instance.GetVkDevice() };
 	const QueueFamilyIndices queueFamilies{ instance.FindQueueFamilies() };
@@ -18,7 +18,7 @@ void CommandPool::Initialize(const VulkanInstance& instance)
 	// VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT (Allow command buffers to be rerecorded individually)
 	VkCommandPoolCreateInfo poolInfo{};
 	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.flags = flags;
 	poolInfo.queueFamilyIndex = queueFamilies.graphicsFamily.value();
 
 	if (vkCreateCommandPool(device, &poolInfo, VK_NULL_HANDLE, &m_VkCommandPool) != VK_SUCCESS)
@@ -36,6 +36,15 @@ void CommandPool::Destroy(VkDevice device)
 	}
 }
 
+void CommandPool::Reset(VkDevice device) const
+{
+	// Returns every command buffer allocated from this pool to the initial state in one call
+	if (vkResetCommandPool(device, m_VkCommandPool, 0) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to reset command pool!" };
+	}
+}
+
 CommandBuffer CommandPool::CreateCommandBuffer(VkDevice device, VkCommandBufferLevel level) const
 {
 	VkCommandBufferAllocateInfo allocInfo{};
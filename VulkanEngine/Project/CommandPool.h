@@ -13,9 +13,11 @@ public:
 	CommandPool();
 	~CommandPool() = default;
 
-	void Initialize(const VulkanInstance& instance);
+	void Initialize(const VulkanInstance& instance, VkCommandPoolCreateFlags flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
 	void Destroy(VkDevice device);
 
+	void Reset(VkDevice device) const;
+
 	CommandBuffer CreateCommandBuffer(VkDevice device, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) const;
 	const VkCommandPool& GetVkCommandPool() const;
 
@@ -1,7 +1,8 @@
 #include <stdexcept>
 
 #include "DataBuffer.h"
-#include "CommandPool.h"
+#include "Queue.h"
+#include "DeletionQueue.h"
 
 DataBuffer::DataBuffer()
 	: m_Size{ 0 }
@@ -62,6 +63,17 @@ void DataBuffer::Destroy(VkDevice device)
     }
 }
 
+void DataBuffer::DeferDestroy()
+{
+    if (m_VkBuffer == VK_NULL_HANDLE && m_VkBufferMemory == VK_NULL_HANDLE) return;
+
+    DeletionQueue::Get().Push([buffer = *this](VkDevice device) mutable { buffer.Destroy(device); });
+
+    m_VkBuffer = VK_NULL_HANDLE;
+    m_VkBufferMemory = VK_NULL_HANDLE;
+    m_Size = 0;
+}
+
 const VkBuffer& DataBuffer::GetVkBuffer() const
 {
 	return m_VkBuffer;
@@ -102,21 +114,20 @@ void DataBuffer::BindAsIndexBuffer(VkCommandBuffer commandBuffer) const
     vkCmdBindIndexBuffer(commandBuffer, m_VkBuffer, 0, VK_INDEX_TYPE_UINT32);
 }
 
-void DataBuffer::CopyBuffer(VkQueue graphicsQueue, VkDevice device, const CommandPool& commandPool, DataBuffer srcBuffer, DataBuffer dstBuffer, VkDeviceSize size)
+void DataBuffer::CopyBuffer(Queue& queue, VkDevice device, const DataBuffer& srcBuffer, const DataBuffer& dstBuffer, VkDeviceSize size)
 {
-    CommandBuffer commandBuffer{ commandPool.CreateCommandBuffer(device) };
-
-    commandBuffer.BeginRecording();
-    {
-        VkBufferCopy copyRegion{};
-        copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer.GetVkCommandBuffer(), srcBuffer.GetVkBuffer(), dstBuffer.GetVkBuffer(), 1, &copyRegion);
-    }
-    commandBuffer.EndRecording();
-
-    commandBuffer.Submit(graphicsQueue, VK_NULL_HANDLE);
-
-    commandBuffer.Destroy(device, commandPool);
+    queue.SubmitImmediate(device, [&](VkCommandBuffer commandBuffer)
+        {
+            VkBufferCopy copyRegion{};
+            copyRegion.size = size;
+            vkCmdCopyBuffer(commandBuffer, srcBuffer.GetVkBuffer(), dstBuffer.GetVkBuffer(), 1, &copyRegion);
+
+            VkMemoryBarrier barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        });
 }
 
 uint32_t DataBuffer::FindMemoryType(VkPhysicalDevice physDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties) const
@@ -3,7 +3,7 @@
 
 #include <vulkan/vulkan.h>
 
-class CommandPool;
+class Queue;
 
 class DataBuffer final
 {
@@ -15,6 +15,8 @@ public:
 	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, VkMemoryPropertyFlags properties, VkDeviceSize size, VkBufferUsageFlags usage);
 	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, VkMemoryPropertyFlags properties, const VkBufferCreateInfo& bufferCreateInfo);
 	void Destroy(VkDevice device);
+	// Hands the handles to the DeletionQueue, so the resource can be replaced while frames in flight still use it
+	void DeferDestroy();
 
 	const VkBuffer& GetVkBuffer() const;
 	const VkDeviceMemory& GetVkDeviceMemory() const;
@@ -25,7 +27,8 @@ public:
 	void BindAsVertexBuffer(VkCommandBuffer commandBuffer, uint32_t firstBinding = 0) const;
 	void BindAsIndexBuffer(VkCommandBuffer commandBuffer) const;
 
-	static void CopyBuffer(VkQueue graphicsQueue, VkDevice device, const CommandPool& commandPool, DataBuffer srcBuffer, DataBuffer dstBuffer, VkDeviceSize size);
+	// Submits the copy without waiting for it, later submissions on the same queue see the data from vertex input on
+	static void CopyBuffer(Queue& queue, VkDevice device, const DataBuffer& srcBuffer, const DataBuffer& dstBuffer, VkDeviceSize size);
 
 private:
 
@@ -0,0 +1,71 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "DeletionQueue.h"
+#include "Queue.h"
+
+DeletionQueue::DeletionQueue()
+	: m_pQueue{ nullptr }
+	, m_Entries{}
+{
+}
+
+void DeletionQueue::Initialize(const Queue& queue)
+{
+	m_pQueue = &queue;
+}
+
+void DeletionQueue::Destroy(VkDevice device)
+{
+	std::vector<Entry> entries{};
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+		entries.swap(m_Entries);
+	}
+
+	for (Entry& entry : entries) entry.deleter(device);
+
+	m_pQueue = nullptr;
+}
+
+void DeletionQueue::Push(Deleter&& deleter)
+{
+	if (!m_pQueue) throw std::runtime_error{ "DeletionQueue: not initialized!" };
+
+	Push(m_pQueue->GetLastSubmission().timelineValue, std::move(deleter));
+}
+
+void DeletionQueue::Push(uint64_t retireValue, Deleter&& deleter)
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	m_Entries.emplace_back(Entry{ retireValue, std::move(deleter) });
+}
+
+void DeletionQueue::Flush(VkDevice device)
+{
+	if (!m_pQueue) return;
+
+	const uint64_t completedValue{ m_pQueue->GetCompletedValue(device) };
+
+	// The ready deleters run outside the lock, so they can push again (a texture releasing its sampler, ..)
+	std::vector<Entry> readyEntries{};
+	{
+		std::lock_guard<std::mutex> lock{ m_Mutex };
+
+		const auto readyIt
+		{
+			std::stable_partition(m_Entries.begin(), m_Entries.end(), [completedValue](const Entry& entry) { return entry.retireValue > completedValue; })
+		};
+
+		readyEntries.insert(readyEntries.end(), std::make_move_iterator(readyIt), std::make_move_iterator(m_Entries.end()));
+		m_Entries.erase(readyIt, m_Entries.end());
+	}
+
+	for (Entry& entry : readyEntries) entry.deleter(device);
+}
+
+uint32_t DeletionQueue::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock{ m_Mutex };
+	return static_cast<uint32_t>(m_Entries.size());
+}
\ No newline at end of file
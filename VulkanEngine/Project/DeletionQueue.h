@@ -0,0 +1,63 @@
+#ifndef DELETIONQUEUE_H
+#define DELETIONQUEUE_H
+
+#include <vector>
+#include <mutex>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+#include "Singleton.h"
+
+class Queue;
+
+// Defers the destruction of gpu resources until the submissions that may still use them are finished.
+// Entries are keyed on a timeline value of the graphics queue and flushed once per frame.
+class DeletionQueue final : public Singleton<DeletionQueue>
+{
+public:
+
+	using Deleter = std::function<void(VkDevice)>;
+
+	virtual ~DeletionQueue() = default;
+
+	DeletionQueue(const DeletionQueue& other) = delete;
+	DeletionQueue(DeletionQueue&& other) noexcept = delete;
+	DeletionQueue& operator=(const DeletionQueue& other) = delete;
+	DeletionQueue& operator=(DeletionQueue&& other) noexcept = delete;
+
+	void Initialize(const Queue& queue);
+
+	// Runs every pending deleter, the device has to be idle
+	void Destroy(VkDevice device);
+
+	// Runs the deleter once everything submitted to the queue so far has finished
+	void Push(Deleter&& deleter);
+	void Push(uint64_t retireValue, Deleter&& deleter);
+
+	// Runs the deleters whose retire value the queue's timeline reached
+	void Flush(VkDevice device);
+
+	uint32_t GetPendingCount() const;
+
+private:
+
+	friend class Singleton<DeletionQueue>;
+	DeletionQueue();
+
+	struct Entry
+	{
+		uint64_t retireValue{};
+		Deleter deleter{};
+	};
+
+private:
+
+	const Queue* m_pQueue;
+	std::vector<Entry> m_Entries;
+
+	mutable std::mutex m_Mutex;
+
+};
+
+#endif // !DELETIONQUEUE_H
\ No newline at end of file
@@ -4,11 +4,10 @@
 #include "Swapchain.h"
 #include "VulkanInstance.h"
 
-void DepthBuffer::Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const Swapchain& swapchain)
+void DepthBuffer::Initialize(const VulkanInstance& instance, const Swapchain& swapchain)
 {
 	const VkDevice& device{ instance.GetVkDevice() };
 	const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
-	const VkQueue& graphQ{ instance.GetGraphicsQueue() };
 	const VkExtent2D& swapchainExtent{ swapchain.GetVkExtent() };
 
 	m_DepthFormat = FindDepthFormat(phyDevice);
@@ -16,7 +15,7 @@ void DepthBuffer::Initialize(const VulkanInstance& instance, const CommandPool&
 	m_DepthImage.Initialize(device, phyDevice, swapchainExtent.width, swapchainExtent.height, m_DepthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 	m_DepthImageView.Initialize(device, m_DepthImage.GetVkImage(), m_DepthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
 
-	m_DepthImage.TransitionImageLayout(device, commandPool, graphQ, m_DepthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+	// The render graph transitions the image on its first use
 }
 
 void DepthBuffer::Destroy(VkDevice device)
@@ -25,6 +24,11 @@ void DepthBuffer::Destroy(VkDevice device)
 	m_DepthImageView.Destroy(device);
 }
 
+const VkImage& DepthBuffer::GetVkImage() const
+{
+	return m_DepthImage.GetVkImage();
+}
+
 const VkImageView& DepthBuffer::GetVkImageView() const
 {
 	return m_DepthImageView.GetVkImageView();
@@ -8,7 +8,6 @@
 #include "Image.h"
 #include "ImageView.h"
 
-class CommandPool;
 class VulkanInstance;
 class Swapchain;
 
@@ -19,9 +18,10 @@ public:
 	DepthBuffer() = default;
 	~DepthBuffer() = default;
 
-	void Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const Swapchain& swapchain);
+	void Initialize(const VulkanInstance& instance, const Swapchain& swapchain);
 	void Destroy(VkDevice device);
 
+	const VkImage& GetVkImage() const;
 	const VkImageView& GetVkImageView() const;
 	const VkFormat& GetDepthFormat() const;
 
@@ -0,0 +1,112 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+
+#include "DescriptorAllocator.h"
+
+namespace
+{
+	constexpr uint32_t s_InitialSetsPerPool{ 16 };
+	constexpr uint32_t s_MaxSetsPerPool{ 4096 };
+}
+
+DescriptorAllocator::DescriptorAllocator()
+	: m_FramePools{}
+	, m_PoolRatios{}
+{
+}
+
+void DescriptorAllocator::Initialize(uint32_t framesInFlight, const std::vector<DescriptorPoolRatio>& poolRatios)
+{
+	// Pools are created by the first allocation that needs them
+	m_FramePools.resize(framesInFlight);
+	for (FramePools& framePools : m_FramePools) framePools.setsPerPool = s_InitialSetsPerPool;
+
+	m_PoolRatios = poolRatios;
+}
+
+void DescriptorAllocator::Destroy(VkDevice device)
+{
+	for (FramePools& framePools : m_FramePools)
+	{
+		for (VkDescriptorPool pool : framePools.readyPools) vkDestroyDescriptorPool(device, pool, nullptr);
+		for (VkDescriptorPool pool : framePools.fullPools) vkDestroyDescriptorPool(device, pool, nullptr);
+	}
+	m_FramePools.clear();
+}
+
+void DescriptorAllocator::ResetFrame(VkDevice device, uint32_t currentFrame)
+{
+	FramePools& framePools{ m_FramePools[currentFrame] };
+
+	for (VkDescriptorPool pool : framePools.readyPools) vkResetDescriptorPool(device, pool, 0);
+	for (VkDescriptorPool pool : framePools.fullPools)
+	{
+		vkResetDescriptorPool(device, pool, 0);
+		framePools.readyPools.emplace_back(pool);
+	}
+	framePools.fullPools.clear();
+}
+
+VkDescriptorSet DescriptorAllocator::Allocate(VkDevice device, uint32_t currentFrame, VkDescriptorSetLayout setLayout)
+{
+	FramePools& framePools{ m_FramePools[currentFrame] };
+
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = GetPool(device, framePools);
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &setLayout;
+
+	VkDescriptorSet descriptorSet{ VK_NULL_HANDLE };
+	VkResult result{ vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) };
+
+	// A full pool is retired until the next reset and the allocation is retried once in a fresh pool
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+	{
+		framePools.fullPools.emplace_back(framePools.readyPools.back());
+		framePools.readyPools.pop_back();
+
+		allocInfo.descriptorPool = GetPool(device, framePools);
+		result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+	}
+
+	if (result != VK_SUCCESS) throw std::runtime_error{ "failed to allocate descriptor set!" };
+
+	return descriptorSet;
+}
+
+// Private Functions //
+VkDescriptorPool DescriptorAllocator::GetPool(VkDevice device, FramePools& framePools) const
+{
+	if (framePools.readyPools.empty())
+	{
+		framePools.readyPools.emplace_back(CreatePool(device, framePools.setsPerPool));
+		framePools.setsPerPool = std::min(framePools.setsPerPool * 2, s_MaxSetsPerPool);
+	}
+	return framePools.readyPools.back();
+}
+
+VkDescriptorPool DescriptorAllocator::CreatePool(VkDevice device, uint32_t setCount) const
+{
+	std::vector<VkDescriptorPoolSize> poolSizes{};
+	poolSizes.reserve(m_PoolRatios.size());
+	for (const DescriptorPoolRatio& poolRatio : m_PoolRatios)
+	{
+		const uint32_t descriptorCount{ std::max(1u, static_cast<uint32_t>(std::ceil(poolRatio.ratio * static_cast<float>(setCount)))) };
+		poolSizes.emplace_back(VkDescriptorPoolSize{ poolRatio.type, descriptorCount });
+	}
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = setCount;
+
+	VkDescriptorPool pool{ VK_NULL_HANDLE };
+	if (vkCreateDescriptorPool(device, &poolInfo, VK_NULL_HANDLE, &pool) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create descriptor pool!" };
+	}
+	return pool;
+}
\ No newline at end of file
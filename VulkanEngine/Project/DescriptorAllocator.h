@@ -0,0 +1,56 @@
+#ifndef DESCRIPTORALLOCATOR_H
+#define DESCRIPTORALLOCATOR_H
+
+#include <vector>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+// Share of every descriptor type in a pool, per set that fits in it
+struct DescriptorPoolRatio
+{
+	VkDescriptorType type{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER };
+	float ratio{ 1.f };
+};
+
+// Descriptor sets that live for one frame in flight. Every frame has its own list of pools that grows when a pool runs out,
+// each new pool twice the size of the last. Sets are never freed one by one, all pools of a frame are reset at once.
+class DescriptorAllocator final
+{
+public:
+
+	DescriptorAllocator();
+	~DescriptorAllocator() = default;
+
+	DescriptorAllocator(const DescriptorAllocator& other) = delete;
+	DescriptorAllocator(DescriptorAllocator&& other) noexcept = delete;
+	DescriptorAllocator& operator=(const DescriptorAllocator& other) = delete;
+	DescriptorAllocator& operator=(DescriptorAllocator&& other) noexcept = delete;
+
+	void Initialize(uint32_t framesInFlight, const std::vector<DescriptorPoolRatio>& poolRatios);
+	void Destroy(VkDevice device);
+
+	// Every set allocated for the frame becomes invalid, only call once no command buffer using them can still execute
+	void ResetFrame(VkDevice device, uint32_t currentFrame);
+	VkDescriptorSet Allocate(VkDevice device, uint32_t currentFrame, VkDescriptorSetLayout setLayout);
+
+private:
+
+	struct FramePools
+	{
+		std::vector<VkDescriptorPool> readyPools{};
+		std::vector<VkDescriptorPool> fullPools{};
+		uint32_t setsPerPool{};
+	};
+
+	VkDescriptorPool GetPool(VkDevice device, FramePools& framePools) const;
+	VkDescriptorPool CreatePool(VkDevice device, uint32_t setCount) const;
+
+private:
+
+	std::vector<FramePools> m_FramePools;
+	std::vector<DescriptorPoolRatio> m_PoolRatios;
+
+};
+
+#endif // !DESCRIPTORALLOCATOR_H
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include <stdexcept>
+
+#include "DescriptorUpdateTemplate.h"
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate()
+	: m_VkUpdateTemplate{ VK_NULL_HANDLE }
+	, m_BindingCount{}
+{
+}
+
+void DescriptorUpdateTemplate::Initialize(VkDevice device, VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingDesc>& bindings)
+{
+	std::vector<VkDescriptorUpdateTemplateEntry> entries{};
+	entries.reserve(bindings.size());
+	for (size_t bindingIdx{}; bindingIdx < bindings.size(); ++bindingIdx)
+	{
+		VkDescriptorUpdateTemplateEntry entry{};
+		entry.dstBinding = bindings[bindingIdx].binding;
+		entry.dstArrayElement = 0;
+		entry.descriptorCount = 1;
+		entry.descriptorType = bindings[bindingIdx].type;
+		entry.offset = sizeof(DescriptorInfo) * bindingIdx;
+		entry.stride = sizeof(DescriptorInfo);
+		entries.emplace_back(entry);
+	}
+
+	VkDescriptorUpdateTemplateCreateInfo templateInfo{};
+	templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+	templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+	templateInfo.pDescriptorUpdateEntries = entries.data();
+	templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+	templateInfo.descriptorSetLayout = setLayout;
+
+	if (vkCreateDescriptorUpdateTemplate(device, &templateInfo, VK_NULL_HANDLE, &m_VkUpdateTemplate) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create descriptor update template!" };
+	}
+
+	m_BindingCount = static_cast<uint32_t>(bindings.size());
+}
+
+void DescriptorUpdateTemplate::Destroy(VkDevice device)
+{
+	if (m_VkUpdateTemplate != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorUpdateTemplate(device, m_VkUpdateTemplate, nullptr);
+		m_VkUpdateTemplate = VK_NULL_HANDLE;
+	}
+}
+
+void DescriptorUpdateTemplate::Update(VkDevice device, VkDescriptorSet descriptorSet, std::span<const DescriptorInfo> infos) const
+{
+	if (infos.size() != m_BindingCount) throw std::runtime_error{ "Descriptor update template expects one info per binding!" };
+
+	vkUpdateDescriptorSetWithTemplate(device, descriptorSet, m_VkUpdateTemplate, infos.data());
+}
\ No newline at end of file
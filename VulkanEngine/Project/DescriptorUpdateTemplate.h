@@ -0,0 +1,45 @@
+#ifndef DESCRIPTORUPDATETEMPLATE_H
+#define DESCRIPTORUPDATETEMPLATE_H
+
+#include <vector>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "PipelineBuilder.h"
+
+// One entry of the data a template reads, the member that is used depends on the type of its binding
+union DescriptorInfo
+{
+	VkDescriptorBufferInfo buffer;
+	VkDescriptorImageInfo image;
+};
+
+// Writes every binding of a set layout in one call from a packed array of DescriptorInfo, instead of building VkWriteDescriptorSet arrays
+class DescriptorUpdateTemplate final
+{
+public:
+
+	DescriptorUpdateTemplate();
+	~DescriptorUpdateTemplate() = default;
+
+	DescriptorUpdateTemplate(const DescriptorUpdateTemplate& other) = delete;
+	DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept = delete;
+	DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate& other) = delete;
+	DescriptorUpdateTemplate& operator=(DescriptorUpdateTemplate&& other) noexcept = delete;
+
+	// The bindings have to be the ones the set layout was created from
+	void Initialize(VkDevice device, VkDescriptorSetLayout setLayout, const std::vector<DescriptorBindingDesc>& bindings);
+	void Destroy(VkDevice device);
+
+	// One info per binding, in the order of the bindings the template was created with
+	void Update(VkDevice device, VkDescriptorSet descriptorSet, std::span<const DescriptorInfo> infos) const;
+
+private:
+
+	VkDescriptorUpdateTemplate m_VkUpdateTemplate;
+	uint32_t m_BindingCount;
+
+};
+
+#endif // !DESCRIPTORUPDATETEMPLATE_H
\ No newline at end of file
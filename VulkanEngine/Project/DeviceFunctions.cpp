@@ -0,0 +1,50 @@
+#include <stdexcept>
+#include <string>
+
+#include "DeviceFunctions.h"
+
+DeviceFunctions::DeviceFunctions()
+	: m_pCmdPipelineBarrier2{ nullptr }
+	, m_pCmdBeginRendering{ nullptr }
+	, m_pCmdEndRendering{ nullptr }
+{
+}
+
+void DeviceFunctions::Initialize(VkDevice device, uint32_t apiVersion, bool dynamicRendering)
+{
+	const bool isCore{ apiVersion >= VK_API_VERSION_1_3 };
+
+	m_pCmdPipelineBarrier2 = reinterpret_cast<PFN_vkCmdPipelineBarrier2>(Load(device, "vkCmdPipelineBarrier2", "vkCmdPipelineBarrier2KHR", isCore));
+
+	if (dynamicRendering)
+	{
+		m_pCmdBeginRendering = reinterpret_cast<PFN_vkCmdBeginRendering>(Load(device, "vkCmdBeginRendering", "vkCmdBeginRenderingKHR", isCore));
+		m_pCmdEndRendering = reinterpret_cast<PFN_vkCmdEndRendering>(Load(device, "vkCmdEndRendering", "vkCmdEndRenderingKHR", isCore));
+	}
+}
+
+void DeviceFunctions::CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo& dependencyInfo) const
+{
+	m_pCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+void DeviceFunctions::CmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo& renderingInfo) const
+{
+	m_pCmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void DeviceFunctions::CmdEndRendering(VkCommandBuffer commandBuffer) const
+{
+	m_pCmdEndRendering(commandBuffer);
+}
+
+// Private Functions //
+PFN_vkVoidFunction DeviceFunctions::Load(VkDevice device, const char* coreName, const char* extensionName, bool isCore)
+{
+	const char* name{ isCore ? coreName : extensionName };
+
+	const PFN_vkVoidFunction pFunction{ vkGetDeviceProcAddr(device, name) };
+	if (!pFunction) throw std::runtime_error{ std::string{ "failed to load device function " } + name + "!" };
+
+	return pFunction;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef DEVICEFUNCTIONS_H
+#define DEVICEFUNCTIONS_H
+
+#include <vulkan/vulkan.h>
+
+#include "Singleton.h"
+
+// Device commands that are core in Vulkan 1.3 but come from an extension on a 1.2 device.
+// They are loaded once after device creation under the name the device exposes them with.
+class DeviceFunctions final : public Singleton<DeviceFunctions>
+{
+public:
+
+	virtual ~DeviceFunctions() = default;
+
+	DeviceFunctions(const DeviceFunctions& other) = delete;
+	DeviceFunctions(DeviceFunctions&& other) noexcept = delete;
+	DeviceFunctions& operator=(const DeviceFunctions& other) = delete;
+	DeviceFunctions& operator=(DeviceFunctions&& other) noexcept = delete;
+
+	// apiVersion is the version of the device, below 1.3 the KHR entry points are loaded.
+	// The rendering commands are only loaded when dynamic rendering was enabled on the device.
+	void Initialize(VkDevice device, uint32_t apiVersion, bool dynamicRendering);
+
+	void CmdPipelineBarrier2(VkCommandBuffer commandBuffer, const VkDependencyInfo& dependencyInfo) const;
+	void CmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfo& renderingInfo) const;
+	void CmdEndRendering(VkCommandBuffer commandBuffer) const;
+
+private:
+
+	friend class Singleton<DeviceFunctions>;
+	DeviceFunctions();
+
+	static PFN_vkVoidFunction Load(VkDevice device, const char* coreName, const char* extensionName, bool isCore);
+
+private:
+
+	PFN_vkCmdPipelineBarrier2 m_pCmdPipelineBarrier2;
+	PFN_vkCmdBeginRendering m_pCmdBeginRendering;
+	PFN_vkCmdEndRendering m_pCmdEndRendering;
+
+};
+
+#endif // !DEVICEFUNCTIONS_H
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <array>
+
+#include "DrawList.h"
+
+namespace
+{
+	constexpr uint32_t s_RadixBits{ 8 };
+	constexpr uint32_t s_RadixBucketCount{ 1 << s_RadixBits };
+	constexpr uint32_t s_RadixPassCount{ 64 / s_RadixBits };
+
+	constexpr uint64_t GetFieldMask(uint32_t bitCount)
+	{
+		return (uint64_t{ 1 } << bitCount) - 1;
+	}
+}
+
+DrawList::DrawList()
+	: m_Items{}
+	, m_SortBuffer{}
+{
+}
+
+uint64_t DrawList::MakeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float viewDepth, float farPlane)
+{
+	// Linear depth over the view range, draws behind the camera or past the far plane are clamped
+	const float normalizedDepth{ std::clamp(viewDepth / farPlane, 0.f, 1.f) };
+	const uint64_t depth{ static_cast<uint64_t>(normalizedDepth * static_cast<float>(GetFieldMask(s_DepthBits))) };
+
+	uint64_t key{ pipeline & GetFieldMask(s_PipelineBits) };
+	key = (key << s_MaterialBits) | (material & GetFieldMask(s_MaterialBits));
+	key = (key << s_MeshBits) | (mesh & GetFieldMask(s_MeshBits));
+	key = (key << s_DepthBits) | depth;
+	return key;
+}
+
+uint32_t DrawList::GetPipeline(uint64_t key)
+{
+	return static_cast<uint32_t>(key >> (s_MaterialBits + s_MeshBits + s_DepthBits));
+}
+
+uint32_t DrawList::GetMaterial(uint64_t key)
+{
+	return static_cast<uint32_t>((key >> (s_MeshBits + s_DepthBits)) & GetFieldMask(s_MaterialBits));
+}
+
+void DrawList::Clear()
+{
+	m_Items.clear();
+}
+
+void DrawList::Add(uint64_t key, uint32_t index)
+{
+	m_Items.emplace_back(DrawItem{ key, index });
+}
+
+void DrawList::Sort()
+{
+	const size_t itemCount{ m_Items.size() };
+	if (itemCount < 2) return;
+
+	// The buffers only grow, after the first frames sorting does not allocate anymore
+	m_SortBuffer.resize(itemCount);
+
+	// All histograms in one read of the keys
+	std::array<std::array<uint32_t, s_RadixBucketCount>, s_RadixPassCount> histograms{};
+	for (const DrawItem& item : m_Items)
+	{
+		for (uint32_t passIdx{}; passIdx < s_RadixPassCount; ++passIdx)
+		{
+			++histograms[passIdx][(item.key >> (passIdx * s_RadixBits)) & (s_RadixBucketCount - 1)];
+		}
+	}
+
+	for (uint32_t passIdx{}; passIdx < s_RadixPassCount; ++passIdx)
+	{
+		std::array<uint32_t, s_RadixBucketCount>& histogram{ histograms[passIdx] };
+
+		// A digit that is the same for every key does not change the order
+		const uint32_t shift{ passIdx * s_RadixBits };
+		if (histogram[(m_Items.front().key >> shift) & (s_RadixBucketCount - 1)] == itemCount) continue;
+
+		uint32_t offset{};
+		for (uint32_t& bucket : histogram)
+		{
+			const uint32_t count{ bucket };
+			bucket = offset;
+			offset += count;
+		}
+
+		// Stable scatter, the order of the previous passes is kept within every bucket
+		for (const DrawItem& item : m_Items)
+		{
+			m_SortBuffer[histogram[(item.key >> shift) & (s_RadixBucketCount - 1)]++] = item;
+		}
+		m_Items.swap(m_SortBuffer);
+	}
+}
+
+bool DrawList::HasSameOrder(const DrawList& other) const
+{
+	constexpr uint64_t stateMask{ ~GetFieldMask(s_DepthBits) };
+
+	return std::equal(m_Items.begin(), m_Items.end(), other.m_Items.begin(), other.m_Items.end(), [stateMask](const DrawItem& lhs, const DrawItem& rhs)
+	{
+		return lhs.index == rhs.index && (lhs.key & stateMask) == (rhs.key & stateMask);
+	});
+}
+
+std::span<const DrawItem> DrawList::GetItems() const
+{
+	return m_Items;
+}
+
+uint32_t DrawList::GetCount() const
+{
+	return static_cast<uint32_t>(m_Items.size());
+}
\ No newline at end of file
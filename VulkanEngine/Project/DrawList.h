@@ -0,0 +1,104 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+class Mesh;
+
+struct DrawItem
+{
+	uint64_t key{};
+	uint32_t index{}; // Model index within the pipeline's scene
+};
+
+struct DrawStats
+{
+	uint32_t drawCount{};
+	uint32_t pipelineBinds{};
+	uint32_t descriptorSetBinds{};
+	uint32_t vertexBufferBinds{};
+
+	DrawStats& operator+=(const DrawStats& other)
+	{
+		drawCount += other.drawCount;
+		pipelineBinds += other.pipelineBinds;
+		descriptorSetBinds += other.descriptorSetBinds;
+		vertexBufferBinds += other.vertexBufferBinds;
+		return *this;
+	}
+};
+
+// What is bound in the command buffer that is being recorded, consecutive draws skip the binds that did not change
+struct DrawRecordState
+{
+	uint32_t currentFrame{};
+	uint32_t pipeline{ UINT32_MAX };
+	const Mesh* pMesh{ nullptr };
+	DrawStats stats{};
+};
+
+// Camera data needed to quantize the view depth of a draw
+struct DrawView
+{
+	glm::vec3 position{};
+	glm::vec3 direction{ 0.f, 0.f, 1.f };
+	float farPlane{ 1.f };
+
+	float GetDepth(const AABB& bounds) const
+	{
+		return glm::dot(bounds.GetCenter() - position, direction);
+	}
+};
+
+// Per frame list of draws ordered by a packed 64 bit key, from most to least significant:
+// pipeline (8 bits) | material (12 bits) | mesh (20 bits) | view depth (24 bits).
+// Draws sharing state end up next to each other and every state group is drawn front to back for early depth rejection.
+// Clear keeps the capacity, a list that is reused every frame stops allocating once it has held the largest frame.
+class DrawList final
+{
+public:
+
+	static constexpr uint32_t s_PipelineBits{ 8 };
+	static constexpr uint32_t s_MaterialBits{ 12 };
+	static constexpr uint32_t s_MeshBits{ 20 };
+	static constexpr uint32_t s_DepthBits{ 24 };
+
+	DrawList();
+	~DrawList() = default;
+
+	DrawList(const DrawList& other) = default;
+	DrawList(DrawList&& other) noexcept = default;
+	DrawList& operator=(const DrawList& other) = default;
+	DrawList& operator=(DrawList&& other) noexcept = default;
+
+	// Ids wider than their field are truncated, which only costs grouping and never correctness
+	static uint64_t MakeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float viewDepth, float farPlane);
+	static uint32_t GetPipeline(uint64_t key);
+	static uint32_t GetMaterial(uint64_t key);
+
+	void Clear();
+	void Add(uint64_t key, uint32_t index);
+
+	// LSD radix sort on 8 bit digits, passes where every key has the same digit are skipped
+	void Sort();
+
+	// Same draws in the same order, the depths may differ
+	bool HasSameOrder(const DrawList& other) const;
+
+	std::span<const DrawItem> GetItems() const;
+	uint32_t GetCount() const;
+
+private:
+
+	std::vector<DrawItem> m_Items;
+	std::vector<DrawItem> m_SortBuffer;
+
+};
+
+#endif // !DRAWLIST_H
\ No newline at end of file
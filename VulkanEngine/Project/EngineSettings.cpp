@@ -0,0 +1,132 @@
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+
+#include <nlohmann/json.hpp>
+
+#include "EngineSettings.h"
+#include "VulkanUtils.h"
+
+EngineSettings::EngineSettings()
+	: m_MaxFramesInFlight{ 2 }
+	, m_PreferredPresentMode{ VK_PRESENT_MODE_MAILBOX_KHR }
+	, m_SwapchainImageCount{ 0 }
+	, m_PreferDynamicRendering{ true }
+{
+}
+
+void EngineSettings::Initialize(int argc, char* argv[])
+{
+	// The settings file is read first so command line arguments can override it
+	std::string settingsFilePath{ g_EngineSettingsPath };
+	for (int argIdx{ 1 }; argIdx + 1 < argc; ++argIdx)
+	{
+		if (std::string{ argv[argIdx] } == "--settings") settingsFilePath = argv[argIdx + 1];
+	}
+	LoadFromFile(settingsFilePath);
+
+	for (int argIdx{ 1 }; argIdx < argc; ++argIdx)
+	{
+		const std::string argument{ argv[argIdx] };
+		if (argIdx + 1 >= argc) throw std::runtime_error{ "Missing value for argument: " + argument };
+
+		const std::string value{ argv[++argIdx] };
+
+		if (argument == "--settings") continue;
+		else if (argument == "--frames-in-flight") SetMaxFramesInFlight(std::stoi(value));
+		else if (argument == "--present-mode") SetPreferredPresentMode(value);
+		else if (argument == "--swapchain-images") SetSwapchainImageCount(std::stoi(value));
+		else if (argument == "--render-path") SetRenderPath(value);
+		else throw std::runtime_error{ "Unknown argument: " + argument };
+	}
+}
+
+uint32_t EngineSettings::GetMaxFramesInFlight() const
+{
+	return m_MaxFramesInFlight;
+}
+
+VkPresentModeKHR EngineSettings::GetPreferredPresentMode() const
+{
+	return m_PreferredPresentMode;
+}
+
+uint32_t EngineSettings::GetSwapchainImageCount() const
+{
+	return m_SwapchainImageCount;
+}
+
+bool EngineSettings::GetPreferDynamicRendering() const
+{
+	return m_PreferDynamicRendering;
+}
+
+void EngineSettings::Print() const
+{
+	std::cout << "Engine settings: " << m_MaxFramesInFlight << " frames in flight, "
+		<< GetPresentModeName(m_PreferredPresentMode) << " present mode, ";
+
+	if (m_SwapchainImageCount == 0) std::cout << "default swapchain image count, ";
+	else std::cout << m_SwapchainImageCount << " swapchain images, ";
+
+	std::cout << (m_PreferDynamicRendering ? "dynamic" : "renderpass") << " render path\n";
+}
+
+void EngineSettings::LoadFromFile(const std::string& filePath)
+{
+	std::ifstream file{ filePath };
+	if (!file.is_open())
+	{
+		std::cout << "No engine settings file found at " << filePath << ", using defaults\n";
+		return;
+	}
+
+	nlohmann::json settingsData{};
+	file >> settingsData;
+
+	if (settingsData.contains("framesInFlight")) SetMaxFramesInFlight(settingsData["framesInFlight"].get<int>());
+	if (settingsData.contains("presentMode")) SetPreferredPresentMode(settingsData["presentMode"].get<std::string>());
+	if (settingsData.contains("swapchainImageCount")) SetSwapchainImageCount(settingsData["swapchainImageCount"].get<int>());
+	if (settingsData.contains("renderPath")) SetRenderPath(settingsData["renderPath"].get<std::string>());
+}
+
+void EngineSettings::SetMaxFramesInFlight(int framesInFlight)
+{
+	if (framesInFlight < static_cast<int>(s_MinFramesInFlight) || framesInFlight > static_cast<int>(s_MaxFramesInFlight))
+	{
+		throw std::runtime_error{ "Frames in flight must be between 1 and 4, got: " + std::to_string(framesInFlight) };
+	}
+	m_MaxFramesInFlight = static_cast<uint32_t>(framesInFlight);
+}
+
+void EngineSettings::SetPreferredPresentMode(const std::string& presentModeName)
+{
+	if (presentModeName == "fifo") m_PreferredPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+	else if (presentModeName == "mailbox") m_PreferredPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+	else if (presentModeName == "immediate") m_PreferredPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+	else throw std::runtime_error{ "Unknown present mode: " + presentModeName };
+}
+
+void EngineSettings::SetSwapchainImageCount(int imageCount)
+{
+	if (imageCount < 0) throw std::runtime_error{ "Swapchain image count can not be negative!" };
+	m_SwapchainImageCount = static_cast<uint32_t>(imageCount);
+}
+
+void EngineSettings::SetRenderPath(const std::string& renderPathName)
+{
+	if (renderPathName == "dynamic") m_PreferDynamicRendering = true;
+	else if (renderPathName == "renderpass") m_PreferDynamicRendering = false;
+	else throw std::runtime_error{ "Unknown render path: " + renderPathName };
+}
+
+const char* EngineSettings::GetPresentModeName(VkPresentModeKHR presentMode)
+{
+	switch (presentMode)
+	{
+	case VK_PRESENT_MODE_FIFO_KHR: return "fifo";
+	case VK_PRESENT_MODE_MAILBOX_KHR: return "mailbox";
+	case VK_PRESENT_MODE_IMMEDIATE_KHR: return "immediate";
+	default: return "unknown";
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#ifndef ENGINESETTINGS_H
+#define ENGINESETTINGS_H
+
+#include <string>
+
+#include <vulkan/vulkan.h>
+
+#include "Singleton.h"
+
+// Runtime engine settings, read from a json file and overridden by command line arguments.
+// Settings are fixed once the application starts, per frame resources are sized from them.
+class EngineSettings final : public Singleton<EngineSettings>
+{
+public:
+
+	virtual ~EngineSettings() = default;
+
+	EngineSettings(const EngineSettings& other) = delete;
+	EngineSettings(EngineSettings&& other) noexcept = delete;
+	EngineSettings& operator=(const EngineSettings& other) = delete;
+	EngineSettings& operator=(EngineSettings&& other) noexcept = delete;
+
+	// --settings <file> --frames-in-flight <1-4> --present-mode <fifo|mailbox|immediate> --swapchain-images <count> --render-path <dynamic|renderpass>
+	void Initialize(int argc, char* argv[]);
+
+	uint32_t GetMaxFramesInFlight() const;
+	VkPresentModeKHR GetPreferredPresentMode() const;
+	uint32_t GetSwapchainImageCount() const; // 0 means the surface minimum + 1
+	bool GetPreferDynamicRendering() const; // Falls back to render pass objects when the device lacks dynamic rendering
+
+	void Print() const;
+
+private:
+
+	friend class Singleton<EngineSettings>;
+	EngineSettings();
+
+	void LoadFromFile(const std::string& filePath);
+
+	void SetMaxFramesInFlight(int framesInFlight);
+	void SetPreferredPresentMode(const std::string& presentModeName);
+	void SetSwapchainImageCount(int imageCount);
+	void SetRenderPath(const std::string& renderPathName);
+
+	static const char* GetPresentModeName(VkPresentModeKHR presentMode);
+
+private:
+
+	uint32_t m_MaxFramesInFlight;
+	VkPresentModeKHR m_PreferredPresentMode;
+	uint32_t m_SwapchainImageCount;
+	bool m_PreferDynamicRendering;
+
+	static constexpr uint32_t s_MinFramesInFlight{ 1 };
+	static constexpr uint32_t s_MaxFramesInFlight{ 4 };
+
+};
+
+#endif // !ENGINESETTINGS_H
\ No newline at end of file
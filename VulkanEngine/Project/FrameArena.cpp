@@ -0,0 +1,87 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "FrameArena.h"
+
+FrameArena::FrameArena()
+	: m_Frames{}
+	, m_CurrentFrame{}
+{
+}
+
+void FrameArena::Initialize(uint32_t framesInFlight, size_t bytesPerFrame)
+{
+	m_Frames.resize(framesInFlight);
+	for (FrameBlock& frameBlock : m_Frames)
+	{
+		frameBlock.pMemory = std::make_unique<std::byte[]>(bytesPerFrame);
+		frameBlock.capacity = bytesPerFrame;
+	}
+	m_CurrentFrame = 0;
+}
+
+void FrameArena::Destroy()
+{
+	m_Frames.clear();
+}
+
+void FrameArena::BeginFrame(uint32_t currentFrame)
+{
+	m_CurrentFrame = currentFrame;
+	FrameBlock& frameBlock{ GetCurrentBlock() };
+
+	// The block is grown to everything the frame needed, so only the first frames after a larger workload allocate
+	if (!frameBlock.overflowAllocations.empty())
+	{
+		const size_t requiredCapacity{ std::max(frameBlock.capacity * 2, frameBlock.offset + frameBlock.overflowBytes) };
+		frameBlock.overflowAllocations.clear();
+		frameBlock.pMemory = std::make_unique<std::byte[]>(requiredCapacity);
+		frameBlock.capacity = requiredCapacity;
+	}
+
+	frameBlock.offset = 0;
+	frameBlock.overflowBytes = 0;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	if (m_Frames.empty()) throw std::runtime_error{ "FrameArena: not initialized!" };
+
+	FrameBlock& frameBlock{ GetCurrentBlock() };
+
+	const size_t alignedOffset{ (frameBlock.offset + alignment - 1) & ~(alignment - 1) };
+	if (alignedOffset + size <= frameBlock.capacity)
+	{
+		frameBlock.offset = alignedOffset + size;
+		return frameBlock.pMemory.get() + alignedOffset;
+	}
+
+	// Heap memory is max_align_t aligned, over aligned types are not supported
+	frameBlock.overflowBytes += size + alignment;
+	frameBlock.overflowAllocations.emplace_back(std::make_unique<std::byte[]>(size));
+	return frameBlock.overflowAllocations.back().get();
+}
+
+size_t FrameArena::GetUsedBytes() const
+{
+	if (m_Frames.empty()) return 0;
+
+	const FrameBlock& frameBlock{ GetCurrentBlock() };
+	return frameBlock.offset + frameBlock.overflowBytes;
+}
+
+size_t FrameArena::GetCapacity() const
+{
+	if (m_Frames.empty()) return 0;
+	return GetCurrentBlock().capacity;
+}
+
+FrameArena::FrameBlock& FrameArena::GetCurrentBlock()
+{
+	return m_Frames[m_CurrentFrame];
+}
+
+const FrameArena::FrameBlock& FrameArena::GetCurrentBlock() const
+{
+	return m_Frames[m_CurrentFrame];
+}
\ No newline at end of file
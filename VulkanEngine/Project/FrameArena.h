@@ -0,0 +1,112 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+// Linear allocator for transient cpu data (draw lists, culling results, ..) with one block per frame in flight.
+// A frame's block is reset in O(1) when its frame slot comes around again. Allocations that do not fit go to the heap
+// and grow the block at the next reset, so data placed in the arena stops allocating once the blocks have grown.
+// Not thread safe: BeginFrame and Allocate may run on any thread, but never at the same time. In the frame task graph BeginFrame
+// runs in the task that writes the frame slot and allocations only happen in tasks that read it, which orders them.
+class FrameArena final
+{
+public:
+
+	FrameArena();
+	~FrameArena() = default;
+
+	FrameArena(const FrameArena& other) = delete;
+	FrameArena(FrameArena&& other) noexcept = delete;
+	FrameArena& operator=(const FrameArena& other) = delete;
+	FrameArena& operator=(FrameArena&& other) noexcept = delete;
+
+	void Initialize(uint32_t framesInFlight, size_t bytesPerFrame);
+	void Destroy();
+
+	// Releases everything allocated the last time this frame slot was used
+	void BeginFrame(uint32_t currentFrame);
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	template<typename T>
+	T* Allocate(size_t count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	size_t GetUsedBytes() const;
+	size_t GetCapacity() const;
+
+private:
+
+	struct FrameBlock
+	{
+		std::unique_ptr<std::byte[]> pMemory{};
+		size_t capacity{};
+		size_t offset{};
+		size_t overflowBytes{};
+		std::vector<std::unique_ptr<std::byte[]>> overflowAllocations{};
+	};
+
+	FrameBlock& GetCurrentBlock();
+	const FrameBlock& GetCurrentBlock() const;
+
+private:
+
+	std::vector<FrameBlock> m_Frames;
+	uint32_t m_CurrentFrame;
+
+};
+
+// Standard allocator on top of the frame arena, deallocation is a no-op because the arena is reset as a whole.
+// Not final, containers derive from their allocator.
+template<typename T>
+class FrameArenaAllocator
+{
+public:
+
+	using value_type = T;
+
+	FrameArenaAllocator(FrameArena& arena) noexcept
+		: m_pArena{ &arena }
+	{
+	}
+
+	template<typename U>
+	FrameArenaAllocator(const FrameArenaAllocator<U>& other) noexcept
+		: m_pArena{ other.GetArena() }
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		return m_pArena->Allocate<T>(count);
+	}
+
+	void deallocate(T*, size_t) noexcept
+	{
+	}
+
+	FrameArena* GetArena() const noexcept
+	{
+		return m_pArena;
+	}
+
+	template<typename U>
+	bool operator==(const FrameArenaAllocator<U>& other) const noexcept
+	{
+		return m_pArena == other.GetArena();
+	}
+
+private:
+
+	FrameArena* m_pArena;
+
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+
+#endif // !FRAMEARENA_H
\ No newline at end of file
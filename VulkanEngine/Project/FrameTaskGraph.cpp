@@ -0,0 +1,307 @@
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#include "FrameTaskGraph.h"
+#include "JobSystem.h"
+
+FrameTask::FrameTask(const std::string& name)
+	: m_Name{ name }
+	, m_Uses{}
+	, m_Execute{}
+	, m_IsMainThread{ false }
+{
+}
+
+FrameTask& FrameTask::Read(FrameTaskResource resource)
+{
+	m_Uses.emplace_back(ResourceUse{ resource, false });
+	return *this;
+}
+
+FrameTask& FrameTask::Write(FrameTaskResource resource)
+{
+	m_Uses.emplace_back(ResourceUse{ resource, true });
+	return *this;
+}
+
+FrameTask& FrameTask::SetMainThread()
+{
+	m_IsMainThread = true;
+	return *this;
+}
+
+FrameTask& FrameTask::SetExecute(const ExecuteFunction& execute)
+{
+	m_Execute = execute;
+	return *this;
+}
+
+FrameTaskGraph::FrameTaskGraph()
+	: m_Resources{}
+	, m_Tasks{}
+	, m_Predecessors{}
+	, m_Successors{}
+	, m_RootTasks{}
+	, m_IsCompiled{ false }
+	, m_pJobSystem{ nullptr }
+	, m_PendingPredecessors{}
+	, m_CompletedTaskCount{}
+	, m_MainThreadMutex{}
+	, m_MainThreadTasks{}
+	, m_Failed{ false }
+	, m_ExceptionMutex{}
+	, m_Exception{}
+	, m_FrameStart{}
+	, m_Timings{}
+	, m_CriticalPath{}
+	, m_FrameDuration{}
+{
+}
+
+void FrameTaskGraph::Clear()
+{
+	m_Resources.clear();
+	m_Tasks.clear();
+	m_Predecessors.clear();
+	m_Successors.clear();
+	m_RootTasks.clear();
+	m_PendingPredecessors.clear();
+	m_MainThreadTasks.clear();
+	m_Timings.clear();
+	m_CriticalPath.clear();
+	m_FrameDuration = 0.f;
+	m_IsCompiled = false;
+}
+
+FrameTaskResource FrameTaskGraph::AddResource(const std::string& name)
+{
+	m_Resources.emplace_back(name);
+	m_IsCompiled = false;
+	return static_cast<FrameTaskResource>(m_Resources.size() - 1);
+}
+
+FrameTask& FrameTaskGraph::AddTask(const std::string& name)
+{
+	m_IsCompiled = false;
+	return m_Tasks.emplace_back(name);
+}
+
+void FrameTaskGraph::Compile()
+{
+	const uint32_t taskCount{ static_cast<uint32_t>(m_Tasks.size()) };
+
+	m_Predecessors.assign(taskCount, {});
+	m_Successors.assign(taskCount, {});
+	m_RootTasks.clear();
+
+	// Per resource the last writer and the readers since, a read waits on the writer and a write on both
+	constexpr uint32_t noTask{ UINT32_MAX };
+	std::vector<uint32_t> lastWriters(m_Resources.size(), noTask);
+	std::vector<std::vector<uint32_t>> readersSinceWrite(m_Resources.size());
+
+	for (uint32_t taskIdx{}; taskIdx < taskCount; ++taskIdx)
+	{
+		const FrameTask& task{ m_Tasks[taskIdx] };
+		if (!task.m_Execute) throw std::runtime_error{ "Frame task without execute function: " + task.m_Name };
+
+		std::vector<uint32_t>& predecessors{ m_Predecessors[taskIdx] };
+
+		for (const FrameTask::ResourceUse& use : task.m_Uses)
+		{
+			if (use.resource >= m_Resources.size()) throw std::runtime_error{ "Frame task " + task.m_Name + " uses an unknown resource!" };
+
+			if (lastWriters[use.resource] != noTask && lastWriters[use.resource] != taskIdx) predecessors.emplace_back(lastWriters[use.resource]);
+
+			if (use.isWrite)
+			{
+				for (uint32_t readerIdx : readersSinceWrite[use.resource])
+				{
+					if (readerIdx != taskIdx) predecessors.emplace_back(readerIdx);
+				}
+			}
+		}
+
+		// Resources are only updated after every use of the task was resolved, a task that reads and writes the same data is no reader of its own write
+		for (const FrameTask::ResourceUse& use : task.m_Uses)
+		{
+			if (use.isWrite)
+			{
+				lastWriters[use.resource] = taskIdx;
+				readersSinceWrite[use.resource].clear();
+			}
+		}
+		for (const FrameTask::ResourceUse& use : task.m_Uses)
+		{
+			if (!use.isWrite && lastWriters[use.resource] != taskIdx) readersSinceWrite[use.resource].emplace_back(taskIdx);
+		}
+
+		std::sort(predecessors.begin(), predecessors.end());
+		predecessors.erase(std::unique(predecessors.begin(), predecessors.end()), predecessors.end());
+
+		for (uint32_t predecessorIdx : predecessors) m_Successors[predecessorIdx].emplace_back(taskIdx);
+		if (predecessors.empty()) m_RootTasks.emplace_back(taskIdx);
+	}
+
+	// Sized once, so executing the graph does not allocate (tasks are dispatched by index into the job system's fixed rings)
+	m_PendingPredecessors = std::vector<std::atomic<uint32_t>>(taskCount);
+	m_MainThreadTasks.clear();
+	m_MainThreadTasks.reserve(taskCount);
+	m_Timings.assign(taskCount, TaskTiming{});
+	m_CriticalPath.clear();
+	m_CriticalPath.reserve(taskCount);
+
+	m_IsCompiled = true;
+}
+
+void FrameTaskGraph::Execute(JobSystem& jobSystem)
+{
+	if (!m_IsCompiled) throw std::runtime_error{ "FrameTaskGraph executed before it was compiled!" };
+
+	const uint32_t taskCount{ static_cast<uint32_t>(m_Tasks.size()) };
+
+	m_pJobSystem = &jobSystem;
+	m_CompletedTaskCount.store(0, std::memory_order_relaxed);
+	m_Failed.store(false, std::memory_order_relaxed);
+	for (uint32_t taskIdx{}; taskIdx < taskCount; ++taskIdx)
+	{
+		m_PendingPredecessors[taskIdx].store(static_cast<uint32_t>(m_Predecessors[taskIdx].size()), std::memory_order_relaxed);
+	}
+
+	m_FrameStart = Clock::now();
+	for (uint32_t taskIdx : m_RootTasks) Dispatch(taskIdx);
+
+	// Main thread tasks go first, the calling thread only takes worker tasks while none of them is ready
+	while (m_CompletedTaskCount.load(std::memory_order_acquire) < taskCount)
+	{
+		uint32_t taskIdx{};
+		if (TryPopMainThreadTask(taskIdx)) RunTask(taskIdx);
+		else if (!jobSystem.TryExecuteJob()) std::this_thread::yield();
+	}
+
+	m_pJobSystem = nullptr;
+	UpdateCriticalPath();
+
+	if (m_Exception)
+	{
+		std::exception_ptr exception{};
+		std::swap(exception, m_Exception);
+		std::rethrow_exception(exception);
+	}
+}
+
+const std::vector<uint32_t>& FrameTaskGraph::GetCriticalPath() const
+{
+	return m_CriticalPath;
+}
+
+float FrameTaskGraph::GetFrameDuration() const
+{
+	return m_FrameDuration;
+}
+
+void FrameTaskGraph::PrintCriticalPath() const
+{
+	std::cout << "Frame tasks took " << m_FrameDuration << " ms, critical path:";
+
+	for (size_t pathIdx{}; pathIdx < m_CriticalPath.size(); ++pathIdx)
+	{
+		const uint32_t taskIdx{ m_CriticalPath[pathIdx] };
+		std::cout << (pathIdx == 0 ? " " : " -> ") << m_Tasks[taskIdx].m_Name << " (" << GetTaskDuration(taskIdx) << " ms)";
+	}
+	std::cout << "\n";
+}
+
+// Private Functions //
+void FrameTaskGraph::Dispatch(uint32_t taskIdx)
+{
+	if (m_Tasks[taskIdx].m_IsMainThread)
+	{
+		std::lock_guard<std::mutex> lock{ m_MainThreadMutex };
+		m_MainThreadTasks.emplace_back(taskIdx);
+		return;
+	}
+
+	// The task is identified by its index, so dispatching does not create a new function object
+	m_pJobSystem->Schedule(&FrameTaskGraph::RunTaskJob, this, taskIdx);
+}
+
+void FrameTaskGraph::RunTaskJob(void* pGraph, uint32_t taskIdx)
+{
+	static_cast<FrameTaskGraph*>(pGraph)->RunTask(taskIdx);
+}
+
+void FrameTaskGraph::RunTask(uint32_t taskIdx)
+{
+	TaskTiming& timing{ m_Timings[taskIdx] };
+	timing.start = Clock::now();
+
+	if (!m_Failed.load(std::memory_order_acquire))
+	{
+		try
+		{
+			m_Tasks[taskIdx].m_Execute();
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> lock{ m_ExceptionMutex };
+			if (!m_Exception) m_Exception = std::current_exception();
+			m_Failed.store(true, std::memory_order_release);
+		}
+	}
+
+	timing.end = Clock::now();
+
+	// Successors are still released after a failure, otherwise the frame would never finish
+	for (uint32_t successorIdx : m_Successors[taskIdx])
+	{
+		if (m_PendingPredecessors[successorIdx].fetch_sub(1, std::memory_order_acq_rel) == 1) Dispatch(successorIdx);
+	}
+
+	m_CompletedTaskCount.fetch_add(1, std::memory_order_acq_rel);
+}
+
+bool FrameTaskGraph::TryPopMainThreadTask(uint32_t& taskIdx)
+{
+	std::lock_guard<std::mutex> lock{ m_MainThreadMutex };
+	if (m_MainThreadTasks.empty()) return false;
+
+	taskIdx = m_MainThreadTasks.back();
+	m_MainThreadTasks.pop_back();
+	return true;
+}
+
+void FrameTaskGraph::UpdateCriticalPath()
+{
+	m_CriticalPath.clear();
+	m_FrameDuration = 0.f;
+	if (m_Tasks.empty()) return;
+
+	// The chain ends at the task that finished last, every step back goes to the predecessor that released the task
+	const auto finishedLater{ [this](uint32_t lhs, uint32_t rhs) { return m_Timings[lhs].end < m_Timings[rhs].end; } };
+
+	uint32_t taskIdx{};
+	for (uint32_t otherIdx{ 1 }; otherIdx < m_Tasks.size(); ++otherIdx)
+	{
+		if (finishedLater(taskIdx, otherIdx)) taskIdx = otherIdx;
+	}
+	m_FrameDuration = std::chrono::duration<float, std::milli>(m_Timings[taskIdx].end - m_FrameStart).count();
+
+	while (true)
+	{
+		m_CriticalPath.emplace_back(taskIdx);
+
+		const std::vector<uint32_t>& predecessors{ m_Predecessors[taskIdx] };
+		if (predecessors.empty()) break;
+
+		taskIdx = *std::max_element(predecessors.begin(), predecessors.end(), finishedLater);
+	}
+
+	std::reverse(m_CriticalPath.begin(), m_CriticalPath.end());
+}
+
+float FrameTaskGraph::GetTaskDuration(uint32_t taskIdx) const
+{
+	return std::chrono::duration<float, std::milli>(m_Timings[taskIdx].end - m_Timings[taskIdx].start).count();
+}
\ No newline at end of file
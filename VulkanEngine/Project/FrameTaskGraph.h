@@ -0,0 +1,129 @@
+#ifndef FRAMETASKGRAPH_H
+#define FRAMETASKGRAPH_H
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <exception>
+
+class JobSystem;
+
+using FrameTaskResource = uint32_t;
+
+class FrameTaskGraph;
+
+class FrameTask final
+{
+public:
+
+	using ExecuteFunction = std::function<void()>;
+
+	FrameTask(const std::string& name);
+
+	FrameTask& Read(FrameTaskResource resource);
+	FrameTask& Write(FrameTaskResource resource);
+
+	// Window input has to be polled on the thread that created the window
+	FrameTask& SetMainThread();
+	FrameTask& SetExecute(const ExecuteFunction& execute);
+
+private:
+
+	friend class FrameTaskGraph;
+
+	struct ResourceUse
+	{
+		FrameTaskResource resource{};
+		bool isWrite{};
+	};
+
+	std::string m_Name;
+	std::vector<ResourceUse> m_Uses;
+	ExecuteFunction m_Execute;
+	bool m_IsMainThread;
+
+};
+
+// Per frame task graph on top of the job system. Tasks declare the data they read and write, Compile derives
+// the dependencies from the declaration order and Execute runs every task whose dependencies finished concurrently.
+// The start and end of every task are recorded, so each frame knows the chain of tasks that bounded its length.
+class FrameTaskGraph final
+{
+public:
+
+	FrameTaskGraph();
+	~FrameTaskGraph() = default;
+
+	FrameTaskGraph(const FrameTaskGraph& other) = delete;
+	FrameTaskGraph(FrameTaskGraph&& other) noexcept = delete;
+	FrameTaskGraph& operator=(const FrameTaskGraph& other) = delete;
+	FrameTaskGraph& operator=(FrameTaskGraph&& other) noexcept = delete;
+
+	// Removes every task and resource so the graph can be rebuilt
+	void Clear();
+
+	FrameTaskResource AddResource(const std::string& name);
+	FrameTask& AddTask(const std::string& name);
+
+	void Compile();
+
+	// Has to be called from the thread that initialized the job system, it runs the main thread tasks and helps with the others.
+	// Rethrows the first exception of a task once the frame finished, tasks after a failed one are skipped.
+	void Execute(JobSystem& jobSystem);
+
+	// Task indices of the last frame's critical path, from the first task to the one that finished last
+	const std::vector<uint32_t>& GetCriticalPath() const;
+	float GetFrameDuration() const;
+	void PrintCriticalPath() const;
+
+private:
+
+	using Clock = std::chrono::high_resolution_clock;
+
+	struct TaskTiming
+	{
+		Clock::time_point start{};
+		Clock::time_point end{};
+	};
+
+	void Dispatch(uint32_t taskIdx);
+	void RunTask(uint32_t taskIdx);
+	static void RunTaskJob(void* pGraph, uint32_t taskIdx);
+	bool TryPopMainThreadTask(uint32_t& taskIdx);
+	void UpdateCriticalPath();
+
+	float GetTaskDuration(uint32_t taskIdx) const;
+
+private:
+
+	std::vector<std::string> m_Resources;
+	std::vector<FrameTask> m_Tasks;
+
+	// Set during compilation
+	std::vector<std::vector<uint32_t>> m_Predecessors;
+	std::vector<std::vector<uint32_t>> m_Successors;
+	std::vector<uint32_t> m_RootTasks;
+	bool m_IsCompiled;
+
+	// Execution state of the running frame
+	JobSystem* m_pJobSystem;
+	std::vector<std::atomic<uint32_t>> m_PendingPredecessors;
+	std::atomic<uint32_t> m_CompletedTaskCount;
+	std::mutex m_MainThreadMutex;
+	std::vector<uint32_t> m_MainThreadTasks;
+	std::atomic<bool> m_Failed;
+	std::mutex m_ExceptionMutex;
+	std::exception_ptr m_Exception;
+
+	// Timings of the last frame
+	Clock::time_point m_FrameStart;
+	std::vector<TaskTiming> m_Timings;
+	std::vector<uint32_t> m_CriticalPath;
+	float m_FrameDuration;
+
+};
+
+#endif // !FRAMETASKGRAPH_H
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include <array>
+
+#include "GlobalDescriptors.h"
+
+#include "PipelineBuilder.h"
+#include "PipelineStateCache.h"
+#include "VulkanStructs.h"
+#include "TextureTable.h"
+#include "Camera.h"
+
+GlobalDescriptors::GlobalDescriptors()
+	: m_CameraSetLayout{ VK_NULL_HANDLE }
+	, m_SharedPipelineLayout{ VK_NULL_HANDLE }
+	, m_TextureTableSetLayout{ VK_NULL_HANDLE }
+	, m_TextureTableSet{ VK_NULL_HANDLE }
+	, m_Allocator{}
+	, m_CameraTemplate{}
+	, m_CameraSets{}
+{
+}
+
+void GlobalDescriptors::Initialize(VkDevice device, PipelineStateCache& stateCache, const TextureTable& textureTable, uint32_t framesInFlight)
+{
+	m_TextureTableSetLayout = textureTable.GetVkDescriptorSetLayout();
+	m_TextureTableSet = textureTable.GetVkDescriptorSet();
+
+	m_CameraSetLayout = stateCache.GetDescriptorSetLayout(device, GetCameraBindings());
+	m_CameraTemplate.Initialize(device, m_CameraSetLayout, GetCameraBindings());
+
+	// Same layout description as the 3D pipelines, so the state cache hands out the same layout they use
+	PipelineBuilder builder{};
+	AddSharedLayout(builder);
+	m_SharedPipelineLayout = stateCache.GetPipelineLayout(device, builder.GetDesc());
+
+	// Only camera sets for now, one per frame
+	m_Allocator.Initialize(framesInFlight, { DescriptorPoolRatio{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1.f } });
+	m_CameraSets.resize(framesInFlight, VK_NULL_HANDLE);
+}
+
+void GlobalDescriptors::Destroy(VkDevice device)
+{
+	m_CameraTemplate.Destroy(device);
+	m_Allocator.Destroy(device);
+	m_CameraSets.clear();
+
+	m_CameraSetLayout = VK_NULL_HANDLE;
+	m_SharedPipelineLayout = VK_NULL_HANDLE;
+	m_TextureTableSetLayout = VK_NULL_HANDLE;
+	m_TextureTableSet = VK_NULL_HANDLE;
+}
+
+void GlobalDescriptors::ResetFrame(VkDevice device, uint32_t currentFrame, const Camera& camera)
+{
+	m_Allocator.ResetFrame(device, currentFrame);
+
+	m_CameraSets[currentFrame] = m_Allocator.Allocate(device, currentFrame, m_CameraSetLayout);
+
+	std::array<DescriptorInfo, 1> infos{};
+	infos[0].buffer.buffer = camera.GetUniformBuffers()[currentFrame].GetVkBuffer();
+	infos[0].buffer.offset = 0;
+	infos[0].buffer.range = sizeof(CameraUBO);
+
+	m_CameraTemplate.Update(device, m_CameraSets[currentFrame], infos);
+}
+
+void GlobalDescriptors::AddCameraLayout(PipelineBuilder& builder) const
+{
+	for (const DescriptorBindingDesc& binding : GetCameraBindings())
+	{
+		builder.AddDescriptorBinding(binding.binding, binding.type, binding.stages);
+	}
+}
+
+void GlobalDescriptors::AddSharedLayout(PipelineBuilder& builder) const
+{
+	AddCameraLayout(builder);
+	builder.AddDescriptorSetLayout(m_TextureTableSetLayout)
+		.SetPushConstant(VK_SHADER_STAGE_FRAGMENT_BIT, sizeof(uint32_t)); // Material of the draw
+}
+
+void GlobalDescriptors::Bind(VkCommandBuffer commandBuffer, uint32_t currentFrame) const
+{
+	const std::array<VkDescriptorSet, 2> descriptorSets{ m_CameraSets[currentFrame], m_TextureTableSet };
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_SharedPipelineLayout, 0, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data(), 0, VK_NULL_HANDLE);
+}
+
+void GlobalDescriptors::BindCameraSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const
+{
+	vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &m_CameraSets[currentFrame], 0, VK_NULL_HANDLE);
+}
+
+// Private Functions //
+const std::vector<DescriptorBindingDesc>& GlobalDescriptors::GetCameraBindings()
+{
+	static const std::vector<DescriptorBindingDesc> s_CameraBindings{ DescriptorBindingDesc{ 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT } };
+	return s_CameraBindings;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#ifndef GLOBALDESCRIPTORS_H
+#define GLOBALDESCRIPTORS_H
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "DescriptorAllocator.h"
+#include "DescriptorUpdateTemplate.h"
+
+class PipelineStateCache;
+class PipelineBuilder;
+class TextureTable;
+class Camera;
+
+// Descriptor sets every pipeline reads: the camera in set 0 and the texture table in set 1.
+// The 3D pipelines share one pipeline layout, so on the sorted draw list path both sets are bound once at the start of a command buffer
+// and stay bound across pipeline switches. The standalone Draw paths of the 2D and 3D IR pipelines still bind them on every call.
+class GlobalDescriptors final
+{
+public:
+
+	GlobalDescriptors();
+	~GlobalDescriptors() = default;
+
+	GlobalDescriptors(const GlobalDescriptors& other) = delete;
+	GlobalDescriptors(GlobalDescriptors&& other) noexcept = delete;
+	GlobalDescriptors& operator=(const GlobalDescriptors& other) = delete;
+	GlobalDescriptors& operator=(GlobalDescriptors&& other) noexcept = delete;
+
+	void Initialize(VkDevice device, PipelineStateCache& stateCache, const TextureTable& textureTable, uint32_t framesInFlight);
+	void Destroy(VkDevice device);
+
+	// Frees the sets of the frame and writes a new camera set, only call when the frame's command buffers are re-recorded
+	void ResetFrame(VkDevice device, uint32_t currentFrame, const Camera& camera);
+
+	// Camera set only, for pipelines that keep their own push constants
+	void AddCameraLayout(PipelineBuilder& builder) const;
+	// Camera set, texture table and the material push constant, identical for every pipeline that uses Bind
+	void AddSharedLayout(PipelineBuilder& builder) const;
+
+	void Bind(VkCommandBuffer commandBuffer, uint32_t currentFrame) const;
+	void BindCameraSet(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const;
+
+private:
+
+	static const std::vector<DescriptorBindingDesc>& GetCameraBindings();
+
+private:
+
+	// Layouts (owned by the PipelineStateCache)
+	VkDescriptorSetLayout m_CameraSetLayout;
+	VkPipelineLayout m_SharedPipelineLayout;
+	VkDescriptorSetLayout m_TextureTableSetLayout;
+	VkDescriptorSet m_TextureTableSet;
+
+	DescriptorAllocator m_Allocator;
+	DescriptorUpdateTemplate m_CameraTemplate;
+	std::vector<VkDescriptorSet> m_CameraSets;
+
+};
+
+#endif // !GLOBALDESCRIPTORS_H
\ No newline at end of file
@@ -8,7 +8,7 @@
 #include "Shader.h"
 
 class CommandPool;
-class Camera;
+class GlobalDescriptors;
 
 struct GraphicsPipelineConfigs;
 
@@ -24,35 +24,32 @@ public:
 	GraphicsPipeline2D& operator=(const GraphicsPipeline2D& other) = delete;
 	GraphicsPipeline2D& operator=(GraphicsPipeline2D&& other) noexcept = delete;
 
-	void Initialize(const GraphicsPipelineConfigs& configs, const Camera& pCamera);
+	// Binds the global camera set with its own layout, its push constant range differs from the 3D pipelines
+	void Initialize(const GraphicsPipelineConfigs& configs, const GlobalDescriptors& globalDescriptors);
 	void Destroy(VkDevice device);
 
-	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame);
+	// Binds the pipeline and the camera set on every call, each call records into its own secondary command buffer
+	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame) const;
+	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t firstModel, uint32_t modelCount) const;
 
-	void SetScene(std::vector<Model2D>&& models);
-
-private:
+	uint32_t GetModelCount() const;
 
-	void CreateDescriptorSetLayout(VkDevice device);
-	void CreateDescriptorPool(VkDevice device);
-	void AllocateDescriptorSets(VkDevice device);
-	void UpdateDescriptorSets(VkDevice device, const Camera& pCam);
+	// Changes whenever the recorded draw commands would change
+	uint64_t GetDrawVersion() const;
 
-	void CreatePipelineLayout(VkDevice device);
-	void CreatePipeline(VkDevice device, const ShadersConfigs& shaderConfigs, const VkExtent2D& swapchainExtent, VkRenderPass renderPass);
+	void SetScene(std::vector<Model2D>&& models);
 
 private:
 
-	// Pipeline
+	// Pipeline (owned by the PipelineStateCache)
 	VkPipeline m_VkPipeline;
 	VkPipelineLayout m_VkPipelineLayout;
 
-	// Descriptors
-	VkDescriptorSetLayout m_VkDescriptorSetLayout;
-	VkDescriptorPool m_DescriptorPool;
-	std::vector<VkDescriptorSet> m_DescriptorSets;
+	// Descriptors (shared with the other pipelines)
+	const GlobalDescriptors* m_pGlobalDescriptors{ nullptr };
 
 	// Scene
+	uint64_t m_DrawVersion{};
 	Scene2D m_Scene;
 
 };
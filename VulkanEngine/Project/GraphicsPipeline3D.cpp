@@ -2,327 +2,110 @@
 
 #include "GraphicsPipeline3D.h"
 
-#include "Shader.h"
+#include "PipelineBuilder.h"
+#include "PipelineStateCache.h"
 #include "VulkanUtils.h"
+#include "EngineSettings.h"
 #include "VulkanStructs.h"
 
-#include "Camera.h"
-#include "Texture.h"
+#include "GlobalDescriptors.h"
 
-void GraphicsPipeline3D::Initialize(const GraphicsPipelineConfigs& configs, const Texture& pTex, const Camera& pCam)
+void GraphicsPipeline3D::Initialize(const GraphicsPipelineConfigs& configs, const GlobalDescriptors& globalDescriptors)
 {
-	CreateDescriptorSetLayout(configs.device);
-	CreateDescriptorPool(configs.device);
-	AllocateDescriptorSets(configs.device);
-	UpdateDescriptorSets(configs.device, pTex, pCam);
-
-	CreatePipelineLayout(configs.device);
-	CreatePipeline(configs.device, configs.shaderConfigs, configs.swapchainExtent, configs.renderPass);
+	PipelineBuilder builder{};
+	builder.SetShaders(configs.shaderConfigs)
+		.SetVertexInput(VertexType::Vertex3D)
+		.SetRasterizer(VK_POLYGON_MODE_FILL, VK_CULL_MODE_BACK_BIT)
+		.SetDepthState(true, true, VK_COMPARE_OP_LESS)
+		.SetRenderPass(configs.renderPass)
+		.SetAttachmentFormats(configs.colorFormat, configs.depthFormat);
+	globalDescriptors.AddSharedLayout(builder);
+	const PipelineDesc& desc{ builder.GetDesc() };
+
+	// Layouts and pipelines are owned by the state cache and shared with identical descriptions
+	m_VkPipelineLayout = configs.stateCache->GetPipelineLayout(configs.device, desc);
+	m_VkPipeline = configs.stateCache->GetPipeline(configs.device, desc);
+	m_VkWireframePipeline = configs.stateCache->GetPipeline(configs.device, desc.GetWireframeVariant());
+
+	m_InstanceStream.Initialize(EngineSettings::Get().GetMaxFramesInFlight());
 }
 
 void GraphicsPipeline3D::Destroy(VkDevice device)
 {
-	if (m_VkPipelineLayout != VK_NULL_HANDLE)
-	{
-		vkDestroyPipelineLayout(device, m_VkPipelineLayout, nullptr);
-		m_VkPipelineLayout = VK_NULL_HANDLE;
-	}
-
-	if (m_VkPipeline != VK_NULL_HANDLE)
-	{
-		vkDestroyPipeline(device, m_VkPipeline, nullptr);
-		m_VkPipeline = VK_NULL_HANDLE;
-	}
-
-	if (m_DescriptorPool != VK_NULL_HANDLE)
-	{
-		vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
-		m_DescriptorPool = VK_NULL_HANDLE;
-	}
-
-	if (m_VkDescriptorSetLayout != VK_NULL_HANDLE)
-	{
-		vkDestroyDescriptorSetLayout(device, m_VkDescriptorSetLayout, nullptr);
-		m_VkDescriptorSetLayout = VK_NULL_HANDLE;
-	}
+	m_VkPipeline = VK_NULL_HANDLE;
+	m_VkWireframePipeline = VK_NULL_HANDLE;
+	m_VkPipelineLayout = VK_NULL_HANDLE;
 
 	m_Scene.Destroy(device);
+	m_InstanceStream.Destroy(device);
+	m_Instances.clear();
+	++m_DrawVersion;
 }
 
-void GraphicsPipeline3D::Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame) const
+void GraphicsPipeline3D::Update()
 {
-	constexpr VkPipelineBindPoint bindPoint{ VK_PIPELINE_BIND_POINT_GRAPHICS };
-
-	vkCmdBindPipeline(commandBuffer, bindPoint, m_VkPipeline);
-
-	vkCmdBindDescriptorSets(commandBuffer, bindPoint, m_VkPipelineLayout, 0, 1, &m_DescriptorSets[currentFrame], 0, VK_NULL_HANDLE);
-
-	m_Scene.Draw(commandBuffer, m_VkPipelineLayout);
+	m_Scene.Update();
 }
 
-void GraphicsPipeline3D::SetScene(std::vector<Model3D>&& models)
+void GraphicsPipeline3D::Cull(const Frustum& frustum)
 {
-	m_Scene.Initialize(std::move(models));
+	m_Scene.Cull(frustum);
 }
 
-void GraphicsPipeline3D::CreateDescriptorSetLayout(VkDevice device)
+void GraphicsPipeline3D::AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const
 {
-	VkDescriptorSetLayoutBinding uboLayoutBinding{};
-	uboLayoutBinding.binding = 0;
-	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboLayoutBinding.pImmutableSamplers = VK_NULL_HANDLE; // Optional
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
-	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-	samplerLayoutBinding.binding = 1;
-	samplerLayoutBinding.descriptorCount = 1;
-	samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerLayoutBinding.pImmutableSamplers = VK_NULL_HANDLE;
-	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-
-	std::array<VkDescriptorSetLayoutBinding, 2> bindings{ uboLayoutBinding, samplerLayoutBinding };
-	VkDescriptorSetLayoutCreateInfo layoutInfo{};
-	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	layoutInfo.pBindings = bindings.data();
-
-	if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &m_VkDescriptorSetLayout) != VK_SUCCESS)
-	{
-		throw std::runtime_error{ "failed to create descriptor set layout!" };
-	}
+	m_Scene.AddDraws(drawList, pipeline, view);
 }
 
-void GraphicsPipeline3D::CreateDescriptorPool(VkDevice device)
+void GraphicsPipeline3D::UpdateInstanceStream(const VulkanInstance& instance, uint32_t currentFrame, std::span<const DrawItem> drawItems)
 {
-	std::array<VkDescriptorPoolSize, 2> poolSizes{};
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER; // Camera uniform buffer
-	poolSizes[0].descriptorCount = static_cast<uint32_t>(g_MaxFramesInFlight);
+	m_Scene.GetInstances(drawItems, m_Instances);
 
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER; // Sampler
-	poolSizes[1].descriptorCount = static_cast<uint32_t>(g_MaxFramesInFlight);
-
-	VkDescriptorPoolCreateInfo poolInfo{};
-	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = static_cast<uint32_t>(g_MaxFramesInFlight);
-	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-
-	if (vkCreateDescriptorPool(device, &poolInfo, VK_NULL_HANDLE, &m_DescriptorPool) != VK_SUCCESS)
-	{
-		throw std::runtime_error{ "failed to create descriptor pool!" };
-	}
+	// A grown stream is a new buffer, which the cached draws of the frame slot do not reference yet
+	if (m_InstanceStream.Upload(instance, currentFrame, m_Instances)) ++m_DrawVersion;
 }
 
-void GraphicsPipeline3D::AllocateDescriptorSets(VkDevice device)
+void GraphicsPipeline3D::Bind(VkCommandBuffer commandBuffer, DrawRecordState& state) const
 {
-	std::vector<VkDescriptorSetLayout> layouts{ g_MaxFramesInFlight, m_VkDescriptorSetLayout };
-
-	VkDescriptorSetAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	allocInfo.descriptorPool = m_DescriptorPool;
-	allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
-	allocInfo.pSetLayouts = layouts.data();
+	// The global sets are already bound, the shared pipeline layout keeps them bound across the switch
+	vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_Wireframe ? m_VkWireframePipeline : m_VkPipeline);
+	++state.stats.pipelineBinds;
 
-	m_DescriptorSets.resize(layouts.size());
-
-	if (vkAllocateDescriptorSets(device, &allocInfo, m_DescriptorSets.data()) != VK_SUCCESS)
-	{
-		throw std::runtime_error{ "failed to allocate descriptor sets!" };
-	}
+	// 3D IR models bind their own instance buffers to binding 1, so the stream is rebound with the pipeline
+	m_InstanceStream.Bind(commandBuffer, state.currentFrame, 1);
+	++state.stats.vertexBufferBinds;
 }
 
-void GraphicsPipeline3D::UpdateDescriptorSets(VkDevice device, const Texture& pTex, const Camera& pCam)
+uint32_t GraphicsPipeline3D::DrawInstances(VkCommandBuffer commandBuffer, std::span<const DrawItem> drawItems, uint32_t firstInstance, DrawRecordState& state) const
 {
-	const auto& cameraBuffers{ pCam.GetUniformBuffers() };
-
-	VkDescriptorImageInfo imageInfo{};
-	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-	imageInfo.imageView = pTex.GetVkImageView();
-	imageInfo.sampler = pTex.GetVkSampler();
-
-	for (size_t frameIdx{}; frameIdx < g_MaxFramesInFlight; ++frameIdx)
-	{
-		VkDescriptorBufferInfo cameraBufferInfo{};
-		cameraBufferInfo.buffer = cameraBuffers[frameIdx].GetVkBuffer();
-		cameraBufferInfo.offset = 0;
-		cameraBufferInfo.range = sizeof(CameraUBO);
-
-		std::array<VkWriteDescriptorSet, 2>descriptorWrites{};
-
-		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[1].dstSet = m_DescriptorSets[frameIdx];
-		descriptorWrites[1].dstBinding = 0;
-		descriptorWrites[1].dstArrayElement = 0;
-		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-		descriptorWrites[1].descriptorCount = 1;
-		descriptorWrites[1].pBufferInfo = &cameraBufferInfo;
-
-		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-		descriptorWrites[0].dstSet = m_DescriptorSets[frameIdx];
-		descriptorWrites[0].dstBinding = 1;
-		descriptorWrites[0].dstArrayElement = 0;
-		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-		descriptorWrites[0].descriptorCount = 1;
-		descriptorWrites[0].pImageInfo = &imageInfo;
-
-		vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, VK_NULL_HANDLE);
-	}
+	return m_Scene.DrawInstances(commandBuffer, drawItems, firstInstance, state);
 }
 
-void GraphicsPipeline3D::CreatePipelineLayout(VkDevice device)
+uint32_t GraphicsPipeline3D::GetModelCount() const
 {
-	std::array<VkPushConstantRange, 1> pushConstantRange{};
-	pushConstantRange[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	pushConstantRange[0].offset = 0;
-	pushConstantRange[0].size = sizeof(ModelUBO);
-
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &m_VkDescriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRange.size());
-	pipelineLayoutInfo.pPushConstantRanges = pushConstantRange.data();
-
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VK_NULL_HANDLE, &m_VkPipelineLayout) != VK_SUCCESS)
-	{
-		throw std::runtime_error{ "failed to create pipeline layout!" };
-	}
+	return m_Scene.GetModelCount();
 }
 
-void GraphicsPipeline3D::CreatePipeline(VkDevice device, const ShadersConfigs& shaderConfigs, const VkExtent2D& swapchainExtent, VkRenderPass renderPass)
+uint64_t GraphicsPipeline3D::GetDrawVersion() const
 {
-	Shader vertShader{};
-	Shader fragShader{};
-	vertShader.Initialize(device, shaderConfigs.vertShaderConfig);
-	fragShader.Initialize(device, shaderConfigs.fragShaderConfig);
-
-	std::array<VkPipelineShaderStageCreateInfo, 2> shaderStages
-	{
-		vertShader.GetPipelineShaderStageInfo(),
-		fragShader.GetPipelineShaderStageInfo()
-	};
-
-	const auto bindingDescription{ Descriptions::Get3DBindingDescriptions() };
-	const auto attributeDescriptions{ Descriptions::Get3DAttributeDescriptions() };
-
-	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindingDescription.size());
-	vertexInputInfo.pVertexBindingDescriptions = bindingDescription.data();
-	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-	vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
-
-	const auto inputAssembly{ Shader::GetInputAssemblyStateInfo() };
-
-	std::array<VkDynamicState, 2> dynamicStates
-	{
-		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_SCISSOR
-	};
-	VkPipelineDynamicStateCreateInfo dynamicState{};
-	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-	dynamicState.pDynamicStates = dynamicStates.data();
-
-	VkViewport viewport{};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = static_cast<float>(swapchainExtent.width);
-	viewport.height = static_cast<float>(swapchainExtent.height);
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-
-	VkRect2D scissor{};
-	scissor.offset = { 0, 0 };
-	scissor.extent = swapchainExtent;
-
-	VkPipelineViewportStateCreateInfo viewportState{};
-	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportState.viewportCount = 1;
-	viewportState.pViewports = &viewport;
-	viewportState.scissorCount = 1;
-	viewportState.pScissors = &scissor;
-
-	VkPipelineRasterizationStateCreateInfo rasterizer{};
-	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-	rasterizer.depthClampEnable = VK_FALSE;
-	rasterizer.rasterizerDiscardEnable = VK_FALSE;
-	// VK_POLYGON_MODE_FILL (fill the area of the polygon with fragments)
-	// VK_POLYGON_MODE_LINE (polygon edges are drawn as lines)
-	// VK_POLYGON_MODE_POINT (polygon vertices are drawn as points)
-	rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-	rasterizer.lineWidth = 1.0f;
-	rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-	rasterizer.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
-	rasterizer.depthBiasEnable = VK_FALSE;
-	rasterizer.depthBiasConstantFactor = 0.0f; // Optional
-	rasterizer.depthBiasClamp = 0.0f; // Optional
-	rasterizer.depthBiasSlopeFactor = 0.0f; // Optional
-
-	VkPipelineMultisampleStateCreateInfo multisampling{};
-	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-	multisampling.sampleShadingEnable = VK_FALSE;
-	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-	multisampling.minSampleShading = 1.0f; // Optional
-	multisampling.pSampleMask = VK_NULL_HANDLE; // Optional
-	multisampling.alphaToCoverageEnable = VK_FALSE; // Optional
-	multisampling.alphaToOneEnable = VK_FALSE; // Optional
-
-	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-	colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_FALSE;
-	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD; // Optional
-	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE; // Optional
-	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO; // Optional
-	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD; // Optional
-
-	VkPipelineColorBlendStateCreateInfo colorBlending{};
-	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	colorBlending.logicOpEnable = VK_FALSE;
-	colorBlending.logicOp = VK_LOGIC_OP_COPY; // Optional
-	colorBlending.attachmentCount = 1;
-	colorBlending.pAttachments = &colorBlendAttachment;
-	colorBlending.blendConstants[0] = 0.0f; // Optional
-	colorBlending.blendConstants[1] = 0.0f; // Optional
-	colorBlending.blendConstants[2] = 0.0f; // Optional
-	colorBlending.blendConstants[3] = 0.0f; // Optional
+	return m_DrawVersion;
+}
 
-	VkPipelineDepthStencilStateCreateInfo depthStencil{};
-	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-	depthStencil.depthTestEnable = VK_TRUE;
-	depthStencil.depthWriteEnable = VK_TRUE;
-	depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
-	depthStencil.depthBoundsTestEnable = VK_FALSE;
-	depthStencil.minDepthBounds = 0.0f; // Optional
-	depthStencil.maxDepthBounds = 1.0f; // Optional
-	depthStencil.stencilTestEnable = VK_FALSE;
-	depthStencil.front = {}; // Optional
-	depthStencil.back = {}; // Optional
+void GraphicsPipeline3D::SetWireframe(bool wireframe)
+{
+	if (m_Wireframe == wireframe) return;
 
-	VkGraphicsPipelineCreateInfo pipelineInfo{};
-	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-	pipelineInfo.pStages = shaderStages.data();
-	pipelineInfo.pVertexInputState = &vertexInputInfo;
-	pipelineInfo.pInputAssemblyState = &inputAssembly;
-	pipelineInfo.pViewportState = &viewportState;
-	pipelineInfo.pRasterizationState = &rasterizer;
-	pipelineInfo.pMultisampleState = &multisampling;
-	pipelineInfo.pColorBlendState = &colorBlending;
-	pipelineInfo.layout = m_VkPipelineLayout;
-	pipelineInfo.renderPass = renderPass;
-	pipelineInfo.subpass = 0;
-	pipelineInfo.pDepthStencilState = &depthStencil;
+	m_Wireframe = wireframe;
+	++m_DrawVersion;
+}
 
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, VK_NULL_HANDLE, &m_VkPipeline) != VK_SUCCESS)
-	{
-		throw std::runtime_error{ "failed to create graphics pipeline!" };
-	}
+void GraphicsPipeline3D::SetScene(const VulkanInstance& instance, const CommandPool& commandPool, std::vector<Model3D>&& models)
+{
+	++m_DrawVersion;
+	m_Scene.Initialize(instance, commandPool, std::move(models));
+}
 
-	vertShader.Destroy(device);
-	fragShader.Destroy(device);
+SceneGraph& GraphicsPipeline3D::GetSceneGraph()
+{
+	return m_Scene.GetSceneGraph();
 }
\ No newline at end of file
@@ -2,10 +2,11 @@
 #define GRAPHICSPIPELINE3D_H
 
 #include "Scene.h"
+#include "InstanceStream.h"
 
 class CommandPool;
-class Texture;
-class Camera;
+class VulkanInstance;
+class GlobalDescriptors;
 
 struct ShaderConfig;
 struct ShadersConfigs;
@@ -24,36 +25,49 @@ public:
 	GraphicsPipeline3D& operator=(const GraphicsPipeline3D& other) = delete;
 	GraphicsPipeline3D& operator=(GraphicsPipeline3D&& other) noexcept = delete;
 
-	void Initialize(const GraphicsPipelineConfigs& configs, const Texture& pTex, const Camera& pCam);
+	// Models pick their texture from the table through the material of their instance, the global sets are bound by the recorder
+	void Initialize(const GraphicsPipelineConfigs& configs, const GlobalDescriptors& globalDescriptors);
 	void Destroy(VkDevice device);
 
-	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame) const;
+	// Propagates the scene graph, moved models only change the instance stream so the cached draws stay valid
+	void Update();
+	// Frustum culls the scene through its BVH, only the visible models are added to the draw list
+	void Cull(const Frustum& frustum);
 
-	void SetScene(std::vector<Model3D>&& models);
+	// Sorted draw list path: the pipeline adds its draws, the recorder binds it once per run of its draws.
+	// The recorder binds the global sets once per command buffer, Bind only binds the pipeline and the instance stream.
+	void AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const;
+	// Writes the model matrices and materials of the pipeline's sorted draws into the instance stream of the frame
+	void UpdateInstanceStream(const VulkanInstance& instance, uint32_t currentFrame, std::span<const DrawItem> drawItems);
+	void Bind(VkCommandBuffer commandBuffer, DrawRecordState& state) const;
+	// Draws the leading draws that share mesh and material as one instanced draw, returns how many draws it covered
+	uint32_t DrawInstances(VkCommandBuffer commandBuffer, std::span<const DrawItem> drawItems, uint32_t firstInstance, DrawRecordState& state) const;
 
-private:
+	uint32_t GetModelCount() const;
+
+	// Changes whenever the recorded draw commands would change
+	uint64_t GetDrawVersion() const;
 
-	void CreateDescriptorSetLayout(VkDevice device);
-	void CreateDescriptorPool(VkDevice device);
-	void AllocateDescriptorSets(VkDevice device);
-	void UpdateDescriptorSets(VkDevice device, const Texture& pTex, const Camera& pCam);
+	void SetWireframe(bool wireframe);
+	void SetScene(const VulkanInstance& instance, const CommandPool& commandPool, std::vector<Model3D>&& models);
 
-	void CreatePipelineLayout(VkDevice device);
-	void CreatePipeline(VkDevice device, const ShadersConfigs& shaderConfigs, const VkExtent2D& swapchainExtent, VkRenderPass renderPass);
+	SceneGraph& GetSceneGraph();
 
 private:
 
-	// Pipeline
+	// Pipeline (owned by the PipelineStateCache)
 	VkPipeline m_VkPipeline;
+	VkPipeline m_VkWireframePipeline;
 	VkPipelineLayout m_VkPipelineLayout;
-
-	// Descritor
-	VkDescriptorSetLayout m_VkDescriptorSetLayout;
-	VkDescriptorPool m_DescriptorPool;
-	std::vector<VkDescriptorSet> m_DescriptorSets;
+	bool m_Wireframe{ false };
 
 	// Scene
+	uint64_t m_DrawVersion{};
 	Scene3D m_Scene;
+
+	// Instances in draw order, one per draw
+	InstanceStream m_InstanceStream;
+	std::vector<InstanceData> m_Instances;
 };
 
 #endif // !GRAPHICSPIPELINE3D_H
\ No newline at end of file
@@ -8,8 +8,8 @@
 #include "Scene.h"
 
 class VulkanInstance;
-class Texture;
-class Camera;
+class GlobalDescriptors;
+class JobSystem;
 
 struct GraphicsPipelineConfigs;
 struct ShadersConfigs;
@@ -21,37 +21,45 @@ public:
 	GraphicsPipeline3DIR() = default;
 	~GraphicsPipeline3DIR() = default;
 
-	void Initialize(const GraphicsPipelineConfigs& configs, const Texture& tex, const Camera& cam);
+	// Every model pushes its material, the texture table slot it samples, before its draw
+	void Initialize(const GraphicsPipelineConfigs& configs, const GlobalDescriptors& globalDescriptors);
 	void Destory(VkDevice device);
 
-	void Update(VkDevice device);
+	void Update(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame);
+	// Frustum culls the instances through the scene's BVH, only models with a visible instance are added to the draw list
+	void Cull(const Frustum& frustum);
+	// Standalone path, binds the pipeline and the global sets itself on every call
 	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame) const;
+	void Draw(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t firstModel, uint32_t modelCount) const;
 
-	void SetScene(Scene3DIR&& scene);
-	void SetScene(std::vector<Model3DIR>&& models);
+	// Sorted draw list path: the pipeline adds its draws, the recorder binds it once per run of its draws.
+	// The recorder binds the global sets once per command buffer, Bind only binds the pipeline.
+	void AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const;
+	void Bind(VkCommandBuffer commandBuffer, DrawRecordState& state) const;
+	void DrawModel(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t modelIdx, DrawRecordState& state) const;
 
-private:
+	uint32_t GetModelCount() const;
 
-	void CreateDescriptorSetLayout(VkDevice device);
-	void CreateDescriptorPool(VkDevice device);
-	void AllocateDescriptorSets(VkDevice device);
-	void UpdateDescriptorSets(VkDevice device, const Texture& tex, const Camera& cam);
+	// Changes whenever the recorded draw commands would change
+	uint64_t GetDrawVersion() const;
 
-	void CreatePipelineLayout(VkDevice device);
-	void CreatePipeline(VkDevice device, const ShadersConfigs& shaderConfigs, const VkExtent2D& swapchainExtent, VkRenderPass renderPass);
+	void SetWireframe(bool wireframe);
+	void SetScene(Scene3DIR&& scene);
+	void SetScene(std::vector<Model3DIR>&& models);
 
 private:
 
-	// Pipeline
+	// Pipeline (owned by the PipelineStateCache)
 	VkPipeline m_VkPipeline;
+	VkPipeline m_VkWireframePipeline;
 	VkPipelineLayout m_VkPipelineLayout;
+	bool m_Wireframe{ false };
 
-	// Descritor
-	VkDescriptorSetLayout m_VkDescriptorSetLayout;
-	VkDescriptorPool m_DescriptorPool;
-	std::vector<VkDescriptorSet> m_DescriptorSets;
+	// Descriptors (shared with the other pipelines)
+	const GlobalDescriptors* m_pGlobalDescriptors{ nullptr };
 
 	// Scene
+	uint64_t m_DrawVersion{};
 	Scene3DIR m_Scene;
 
 };
@@ -1,22 +1,25 @@
 #include <stdexcept>
 
 #include "Image.h"
-#include "CommandPool.h"
-#include "CommandBuffer.h"
 #include "DataBuffer.h"
+#include "DeletionQueue.h"
+#include "DeviceFunctions.h"
+#include "Queue.h"
 
 Image::Image()
     : m_Width{}
     , m_Heigth{}
+    , m_MipLevels{ 1 }
     , m_VkImage{ VK_NULL_HANDLE }
     , m_VkImageMemory{ VK_NULL_HANDLE }
 {
 }
 
-void Image::Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags prop)
+void Image::Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags prop, uint32_t mipLevels)
 {
     m_Width = width;
     m_Heigth = height;
+    m_MipLevels = mipLevels;
 
     // Creating Image //
     VkImageCreateInfo imageInfo{};
@@ -25,7 +28,7 @@ void Image::Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t wid
     imageInfo.extent.width = width;
     imageInfo.extent.height = height;
     imageInfo.extent.depth = 1;
-    imageInfo.mipLevels = 1;
+    imageInfo.mipLevels = mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = format;
     imageInfo.tiling = tiling;
@@ -69,13 +72,31 @@ void Image::Destroy(VkDevice device)
     }
 }
 
-void Image::TransitionImageLayout(VkDevice device, const CommandPool& commandPool, VkQueue queue, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+void Image::DeferDestroy()
 {
-    CommandBuffer commandBuffer{ commandPool.CreateCommandBuffer(device) };
-    commandBuffer.BeginRecording();
+    if (m_VkImage == VK_NULL_HANDLE && m_VkImageMemory == VK_NULL_HANDLE) return;
 
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    DeletionQueue::Get().Push([image = *this](VkDevice device) mutable { image.Destroy(device); });
+
+    m_VkImage = VK_NULL_HANDLE;
+    m_VkImageMemory = VK_NULL_HANDLE;
+}
+
+void Image::TransitionImageLayout(VkDevice device, Queue& queue, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
+    VkPipelineStageFlags2 srcStage{};
+    VkAccessFlags2 srcAccess{};
+    VkPipelineStageFlags2 dstStage{};
+    VkAccessFlags2 dstAccess{};
+    GetLayoutStageAccess(oldLayout, srcStage, srcAccess);
+    GetLayoutStageAccess(newLayout, dstStage, dstAccess);
+
+    VkImageMemoryBarrier2 barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
     barrier.oldLayout = oldLayout;
     barrier.newLayout = newLayout;
 
@@ -85,15 +106,11 @@ void Image::TransitionImageLayout(VkDevice device, const CommandPool& commandPoo
     barrier.image = m_VkImage;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.levelCount = m_MipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
 
-
-    VkPipelineStageFlags sourceStage{};
-    VkPipelineStageFlags destinationStage{};
-
-    if (newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+    if (IsDepthFormat(format))
     {
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
 
@@ -102,89 +119,54 @@ void Image::TransitionImageLayout(VkDevice device, const CommandPool& commandPoo
             barrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
         }
     }
-    else
-    {
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    }
 
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    VkDependencyInfo dependencyInfo{};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependencyInfo.imageMemoryBarrierCount = 1;
+    dependencyInfo.pImageMemoryBarriers = &barrier;
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
-    {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    queue.SubmitImmediate(device, [&](VkCommandBuffer commandBuffer)
+        {
+            DeviceFunctions::Get().CmdPipelineBarrier2(commandBuffer, dependencyInfo);
+        });
+}
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
+void Image::CopyBufferToImage(VkDevice device, const DataBuffer& buffer, Queue& queue)
+{
+    VkBufferImageCopy region{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+
+    region.imageOffset = { 0, 0, 0 };
+    region.imageExtent =
     {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        m_Width,
+        m_Heigth,
+        1
+    };
 
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    }
-    else throw std::invalid_argument{ "unsupported layout transition!" };
-
-    vkCmdPipelineBarrier
-    (
-        commandBuffer.GetVkCommandBuffer(),
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    commandBuffer.EndRecording();
-
-    commandBuffer.Submit(queue, VK_NULL_HANDLE);
-    commandBuffer.Destroy(device, commandPool);
+    CopyBufferToImage(device, buffer, queue, { region });
 }
 
-void Image::CopyBufferToImage(VkDevice device, const DataBuffer& buffer, const CommandPool& commandPool, VkQueue queue)
+void Image::CopyBufferToImage(VkDevice device, const DataBuffer& buffer, Queue& queue, const std::vector<VkBufferImageCopy>& regions)
 {
-    CommandBuffer commandBuffer{ commandPool.CreateCommandBuffer(device) };
-    commandBuffer.BeginRecording();
-    {
-        VkBufferImageCopy region{};
-        region.bufferOffset = 0;
-        region.bufferRowLength = 0;
-        region.bufferImageHeight = 0;
-
-        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        region.imageSubresource.mipLevel = 0;
-        region.imageSubresource.baseArrayLayer = 0;
-        region.imageSubresource.layerCount = 1;
-
-        region.imageOffset = { 0, 0, 0 };
-        region.imageExtent =
+    queue.SubmitImmediate(device, [&](VkCommandBuffer commandBuffer)
         {
-            m_Width,
-            m_Heigth,
-            1
-        };
-
-        vkCmdCopyBufferToImage(
-            commandBuffer.GetVkCommandBuffer(),
-            buffer.GetVkBuffer(),
-            m_VkImage,
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-            1,
-            &region
-        );
-    }
-    commandBuffer.EndRecording();
-
-    commandBuffer.Submit(queue, VK_NULL_HANDLE);
-    commandBuffer.Destroy(device, commandPool);
+            vkCmdCopyBufferToImage(
+                commandBuffer,
+                buffer.GetVkBuffer(),
+                m_VkImage,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                static_cast<uint32_t>(regions.size()),
+                regions.data()
+            );
+        });
 }
 
 bool Image::HasStencilComponent(VkFormat format)
@@ -192,6 +174,11 @@ bool Image::HasStencilComponent(VkFormat format)
     return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
 }
 
+bool Image::IsDepthFormat(VkFormat format)
+{
+    return format == VK_FORMAT_D32_SFLOAT || format == VK_FORMAT_D16_UNORM || HasStencilComponent(format);
+}
+
 const VkImage& Image::GetVkImage() const
 {
 	return m_VkImage;
@@ -212,6 +199,56 @@ uint32_t Image::GetHeight() const
     return m_Heigth;
 }
 
+uint32_t Image::GetMipLevels() const
+{
+    return m_MipLevels;
+}
+
+void Image::GetLayoutStageAccess(VkImageLayout layout, VkPipelineStageFlags2& stage, VkAccessFlags2& access)
+{
+    // Stages and accesses that use or produce an image in the given layout
+    switch (layout)
+    {
+    case VK_IMAGE_LAYOUT_UNDEFINED:
+    case VK_IMAGE_LAYOUT_PREINITIALIZED:
+        stage = VK_PIPELINE_STAGE_2_NONE;
+        access = VK_ACCESS_2_NONE;
+        break;
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        access = VK_ACCESS_2_TRANSFER_READ_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+        access = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        access = VK_ACCESS_2_SHADER_READ_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+        access = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+        access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        stage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+        access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+        break;
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+        stage = VK_PIPELINE_STAGE_2_NONE;
+        access = VK_ACCESS_2_NONE;
+        break;
+    default: // VK_IMAGE_LAYOUT_GENERAL and anything else
+        stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+        break;
+    }
+}
+
 uint32_t Image::FindMemoryType(VkPhysicalDevice physDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
 {
     VkPhysicalDeviceMemoryProperties memProperties{};
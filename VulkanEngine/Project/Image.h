@@ -1,10 +1,12 @@
 #ifndef IMAGE_H
 #define IMAGE_H
 
+#include <vector>
+
 #include <vulkan/vulkan.h>
 
-class CommandPool;
 class DataBuffer;
+class Queue;
 
 class Image final
 {
@@ -13,18 +15,24 @@ public:
 	Image();
 	~Image() = default;
 
-	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags prop);
+	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags prop, uint32_t mipLevels = 1);
 	void Destroy(VkDevice device);
+	void DeferDestroy();
 
 	const VkImage& GetVkImage() const;
 	const VkDeviceMemory& GetVkDeviceMemory() const;
 	uint32_t GetWidth() const;
 	uint32_t GetHeight() const;
+	uint32_t GetMipLevels() const;
 
-	void TransitionImageLayout(VkDevice device, const CommandPool& commandPool, VkQueue queue, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-	void CopyBufferToImage(VkDevice device, const DataBuffer& buffer, const CommandPool& commandPool, VkQueue queue);
+	// Submitted on the queue without waiting, later submissions on the same queue are ordered after them
+	void TransitionImageLayout(VkDevice device, Queue& queue, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
+	void CopyBufferToImage(VkDevice device, const DataBuffer& buffer, Queue& queue);
+	void CopyBufferToImage(VkDevice device, const DataBuffer& buffer, Queue& queue, const std::vector<VkBufferImageCopy>& regions);
 
 	static bool HasStencilComponent(VkFormat format);
+	static bool IsDepthFormat(VkFormat format);
+	static void GetLayoutStageAccess(VkImageLayout layout, VkPipelineStageFlags2& stage, VkAccessFlags2& access);
 
 private:
 
@@ -34,6 +42,7 @@ private:
 
 	uint32_t m_Width;
 	uint32_t m_Heigth;
+	uint32_t m_MipLevels;
 	VkImage m_VkImage;
 	VkDeviceMemory m_VkImageMemory;
 
@@ -2,7 +2,7 @@
 
 #include "ImageView.h"
 
-void ImageView::Initialize(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags)
+void ImageView::Initialize(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
 {
     VkImageViewCreateInfo viewInfo{};
     viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -11,7 +11,7 @@ void ImageView::Initialize(VkDevice device, VkImage image, VkFormat format, VkIm
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = aspectFlags;
     viewInfo.subresourceRange.baseMipLevel = 0;
-    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.levelCount = mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
 
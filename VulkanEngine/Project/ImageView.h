@@ -10,7 +10,7 @@ public:
 	ImageView() = default;
 	~ImageView() = default;
 
-	void Initialize(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT);
+	void Initialize(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags = VK_IMAGE_ASPECT_COLOR_BIT, uint32_t mipLevels = 1);
 	void Destroy(VkDevice device);
 
 	const VkImageView& GetVkImageView() const;
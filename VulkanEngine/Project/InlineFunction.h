@@ -0,0 +1,116 @@
+#ifndef INLINEFUNCTION_H
+#define INLINEFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, size_t StorageSize = 64>
+class InlineFunction;
+
+// Move only callable like std::function, but the callable is always stored inside the object and never on the heap.
+// A callable that does not fit the storage is a compile error instead of a hidden allocation.
+template<typename Return, typename... Args, size_t StorageSize>
+class InlineFunction<Return(Args...), StorageSize> final
+{
+public:
+
+	InlineFunction() = default;
+
+	template<typename Function>
+		requires (!std::is_same_v<std::decay_t<Function>, InlineFunction> && std::is_invocable_r_v<Return, const std::decay_t<Function>&, Args...>)
+	InlineFunction(Function&& function)
+	{
+		using Stored = std::decay_t<Function>;
+		static_assert(sizeof(Stored) <= StorageSize, "Callable does not fit the inline storage, capture less or pass a pointer to the data");
+		static_assert(alignof(Stored) <= alignof(std::max_align_t), "Callable is over aligned for the inline storage");
+		static_assert(std::is_nothrow_move_constructible_v<Stored>, "Callable has to be nothrow move constructible");
+
+		new (m_Storage) Stored(std::forward<Function>(function));
+
+		m_pInvoke = [](const void* pStorage, Args... args) -> Return
+		{
+			return (*static_cast<const Stored*>(pStorage))(std::forward<Args>(args)...);
+		};
+		m_pMove = [](void* pDestination, void* pSource) noexcept
+		{
+			new (pDestination) Stored(std::move(*static_cast<Stored*>(pSource)));
+			static_cast<Stored*>(pSource)->~Stored();
+		};
+		m_pDestroy = [](void* pStorage) noexcept
+		{
+			static_cast<Stored*>(pStorage)->~Stored();
+		};
+	}
+
+	~InlineFunction()
+	{
+		Reset();
+	}
+
+	InlineFunction(const InlineFunction& other) = delete;
+	InlineFunction& operator=(const InlineFunction& other) = delete;
+
+	InlineFunction(InlineFunction&& other) noexcept
+	{
+		MoveFrom(other);
+	}
+
+	InlineFunction& operator=(InlineFunction&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			MoveFrom(other);
+		}
+		return *this;
+	}
+
+	Return operator()(Args... args) const
+	{
+		return m_pInvoke(m_Storage, std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const
+	{
+		return m_pInvoke != nullptr;
+	}
+
+private:
+
+	void MoveFrom(InlineFunction& other) noexcept
+	{
+		if (!other.m_pInvoke) return;
+
+		other.m_pMove(m_Storage, other.m_Storage);
+		m_pInvoke = other.m_pInvoke;
+		m_pMove = other.m_pMove;
+		m_pDestroy = other.m_pDestroy;
+
+		other.m_pInvoke = nullptr;
+		other.m_pMove = nullptr;
+		other.m_pDestroy = nullptr;
+	}
+
+	void Reset() noexcept
+	{
+		if (!m_pInvoke) return;
+
+		m_pDestroy(m_Storage);
+		m_pInvoke = nullptr;
+		m_pMove = nullptr;
+		m_pDestroy = nullptr;
+	}
+
+private:
+
+	alignas(std::max_align_t) std::byte m_Storage[StorageSize]{};
+
+	Return(*m_pInvoke)(const void* pStorage, Args... args){ nullptr };
+	void(*m_pMove)(void* pDestination, void* pSource) noexcept { nullptr };
+	void(*m_pDestroy)(void* pStorage) noexcept { nullptr };
+
+};
+
+#endif // !INLINEFUNCTION_H
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <bit>
+
+#include "InstanceStream.h"
+#include "VulkanInstance.h"
+
+namespace
+{
+	constexpr uint32_t s_MinCapacity{ 64 };
+}
+
+InstanceStream::InstanceStream()
+	: m_FrameBuffers{}
+{
+}
+
+void InstanceStream::Initialize(uint32_t framesInFlight)
+{
+	// Buffers are created by the first upload that needs them
+	m_FrameBuffers.resize(framesInFlight);
+}
+
+void InstanceStream::Destroy(VkDevice device)
+{
+	for (FrameBuffer& frameBuffer : m_FrameBuffers)
+	{
+		if (frameBuffer.capacity > 0) frameBuffer.buffer.Destroy(device);
+	}
+	m_FrameBuffers.clear();
+}
+
+bool InstanceStream::Upload(const VulkanInstance& instance, uint32_t currentFrame, std::span<const InstanceData> instances)
+{
+	if (instances.empty()) return false;
+
+	FrameBuffer& frameBuffer{ m_FrameBuffers[currentFrame] };
+	const uint32_t instanceCount{ static_cast<uint32_t>(instances.size()) };
+
+	bool replaced{ false };
+	if (instanceCount > frameBuffer.capacity)
+	{
+		// Recorded command buffers of this frame slot may still reference the old buffer
+		if (frameBuffer.capacity > 0) frameBuffer.buffer.DeferDestroy();
+
+		constexpr VkBufferUsageFlags usage{ VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+		constexpr VkMemoryPropertyFlags properties{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+
+		frameBuffer.capacity = std::bit_ceil(std::max(instanceCount, s_MinCapacity));
+		frameBuffer.buffer.Initialize(instance.GetVkDevice(), instance.GetVkPhysicalDevice(), properties, sizeof(InstanceData) * frameBuffer.capacity, usage);
+		replaced = true;
+	}
+
+	frameBuffer.buffer.Upload(instance.GetVkDevice(), instances.size_bytes(), instances.data());
+	return replaced;
+}
+
+void InstanceStream::Bind(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t binding) const
+{
+	const FrameBuffer& frameBuffer{ m_FrameBuffers[currentFrame] };
+	if (frameBuffer.capacity > 0) frameBuffer.buffer.BindAsVertexBuffer(commandBuffer, binding);
+}
\ No newline at end of file
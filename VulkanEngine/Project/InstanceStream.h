@@ -0,0 +1,47 @@
+#ifndef INSTANCESTREAM_H
+#define INSTANCESTREAM_H
+
+#include <vector>
+#include <span>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanStructs.h"
+#include "DataBuffer.h"
+
+class VulkanInstance;
+
+// Host visible per instance vertex buffer that is refilled every frame, with one buffer per frame in flight
+// so the cpu never writes a buffer the gpu may still be reading. Buffers grow to the next power of two.
+class InstanceStream final
+{
+public:
+
+	InstanceStream();
+	~InstanceStream() = default;
+
+	InstanceStream(const InstanceStream& other) = delete;
+	InstanceStream(InstanceStream&& other) noexcept = delete;
+	InstanceStream& operator=(const InstanceStream& other) = delete;
+	InstanceStream& operator=(InstanceStream&& other) noexcept = delete;
+
+	void Initialize(uint32_t framesInFlight);
+	void Destroy(VkDevice device);
+
+	// Returns true when the frame's buffer was replaced, command buffers that bound the old one have to be re-recorded
+	bool Upload(const VulkanInstance& instance, uint32_t currentFrame, std::span<const InstanceData> instances);
+	void Bind(VkCommandBuffer commandBuffer, uint32_t currentFrame, uint32_t binding) const;
+
+private:
+
+	struct FrameBuffer
+	{
+		DataBuffer buffer{};
+		uint32_t capacity{};
+	};
+
+	std::vector<FrameBuffer> m_FrameBuffers;
+
+};
+
+#endif // !INSTANCESTREAM_H
\ No newline at end of file
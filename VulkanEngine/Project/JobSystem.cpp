@@ -0,0 +1,301 @@
+#include <stdexcept>
+#include <algorithm>
+#include <iostream>
+
+#include "JobSystem.h"
+
+namespace
+{
+	// Index of the calling thread in the job system that owns it, threads the system does not know use the queue of thread 0
+	thread_local const JobSystem* s_pThreadJobSystem{ nullptr };
+	thread_local uint32_t s_ThreadIndex{};
+}
+
+// JOB COUNTER //
+
+JobCounter::JobCounter()
+	: m_Value{}
+	, m_Mutex{}
+	, m_Continuations{}
+	, m_Exception{}
+{
+}
+
+bool JobCounter::IsDone() const
+{
+	return m_Value.load(std::memory_order_acquire) == 0;
+}
+
+// JOB SYSTEM //
+
+JobSystem::JobSystem()
+	: m_Workers{}
+	, m_Queues{}
+	, m_QueuedJobCount{}
+	, m_WakeMutex{}
+	, m_WakeCondition{}
+	, m_Stopping{ false }
+	, m_ExceptionMutex{}
+	, m_UncountedException{}
+{
+}
+
+void JobSystem::Initialize(uint32_t threadCount)
+{
+	if (!m_Queues.empty()) throw std::runtime_error{ "JobSystem already initialized!" };
+	if (threadCount == 0) throw std::runtime_error{ "JobSystem needs at least one thread!" };
+
+	m_Stopping = false;
+
+	m_Queues.reserve(threadCount);
+	for (uint32_t threadIdx{}; threadIdx < threadCount; ++threadIdx)
+	{
+		m_Queues.emplace_back(std::make_unique<WorkerQueue>());
+		m_Queues.back()->jobs.resize(s_QueueCapacity);
+	}
+
+	s_pThreadJobSystem = this;
+	s_ThreadIndex = 0;
+
+	m_Workers.reserve(threadCount - 1);
+	for (uint32_t threadIdx{ 1 }; threadIdx < threadCount; ++threadIdx)
+	{
+		m_Workers.emplace_back(&JobSystem::WorkerLoop, this, threadIdx);
+	}
+}
+
+void JobSystem::Destroy()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_WakeMutex };
+		m_Stopping = true;
+	}
+	m_WakeCondition.notify_all();
+
+	for (std::thread& worker : m_Workers)
+	{
+		if (worker.joinable()) worker.join();
+	}
+	m_Workers.clear();
+	m_Queues.clear();
+
+	if (s_pThreadJobSystem == this) s_pThreadJobSystem = nullptr;
+
+	// Teardown has to reach the device and window cleanup, so a failure nobody polled is only reported
+	if (m_UncountedException)
+	{
+		try
+		{
+			std::rethrow_exception(m_UncountedException);
+		}
+		catch (const std::exception& exception)
+		{
+			std::cerr << "job system: unreported job exception: " << exception.what() << "\n";
+		}
+		catch (...)
+		{
+			std::cerr << "job system: unreported job exception\n";
+		}
+		m_UncountedException = nullptr;
+	}
+}
+
+void JobSystem::Schedule(JobFunction function, JobCounter* pCounter, JobCounter* pDependency)
+{
+	if (pCounter) pCounter->m_Value.fetch_add(1, std::memory_order_relaxed);
+
+	Job job{ std::move(function), pCounter };
+
+	if (pDependency)
+	{
+		// The dependency's last job drains the continuations under the same lock, so the job is either parked or runs now
+		std::lock_guard<std::mutex> lock{ pDependency->m_Mutex };
+		if (!pDependency->IsDone())
+		{
+			pDependency->m_Continuations.emplace_back(std::move(job));
+			return;
+		}
+	}
+
+	Push(std::move(job));
+}
+
+void JobSystem::Schedule(JobEntry entry, void* pData, uint32_t index, JobCounter* pCounter)
+{
+	Schedule([entry, pData, index]() { entry(pData, index); }, pCounter);
+}
+
+void JobSystem::Wait(JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!TryExecuteJob()) std::this_thread::yield();
+	}
+
+	{
+		// The last job may still be releasing the counter's lock
+		std::lock_guard<std::mutex> lock{ counter.m_Mutex };
+		if (counter.m_Exception)
+		{
+			std::exception_ptr exception{};
+			std::swap(exception, counter.m_Exception);
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+bool JobSystem::TryExecuteJob()
+{
+	Job job{};
+	if (!TryPop(job)) return false;
+
+	Execute(job);
+	return true;
+}
+
+uint32_t JobSystem::GetThreadCount() const
+{
+	return static_cast<uint32_t>(m_Queues.size());
+}
+
+uint32_t JobSystem::GetDefaultThreadCount()
+{
+	return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void JobSystem::WorkerLoop(uint32_t threadIdx)
+{
+	s_pThreadJobSystem = this;
+	s_ThreadIndex = threadIdx;
+
+	while (true)
+	{
+		Job job{};
+		if (TryPop(job))
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{ m_WakeMutex };
+		m_WakeCondition.wait(lock, [this]() { return m_Stopping || m_QueuedJobCount.load(std::memory_order_acquire) > 0; });
+		if (m_Stopping && m_QueuedJobCount.load(std::memory_order_acquire) == 0) return;
+	}
+}
+
+void JobSystem::Push(Job&& job)
+{
+	if (m_Queues.empty()) throw std::runtime_error{ "JobSystem not initialized!" };
+
+	WorkerQueue& queue{ *m_Queues[GetCurrentThreadIndex()] };
+	bool isQueued{ false };
+	{
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (queue.count < s_QueueCapacity)
+		{
+			queue.jobs[(queue.first + queue.count) % s_QueueCapacity] = std::move(job);
+			++queue.count;
+			isQueued = true;
+		}
+	}
+
+	// Growing the ring would allocate, a full ring has enough work queued for the other threads anyway
+	if (!isQueued)
+	{
+		Execute(job);
+		return;
+	}
+
+	m_QueuedJobCount.fetch_add(1, std::memory_order_release);
+
+	// Taking the lock orders the push before a worker that is about to sleep re-checks the job count
+	{
+		std::lock_guard<std::mutex> lock{ m_WakeMutex };
+	}
+	m_WakeCondition.notify_one();
+}
+
+bool JobSystem::TryPop(Job& job)
+{
+	const uint32_t threadCount{ GetThreadCount() };
+	const uint32_t threadIdx{ GetCurrentThreadIndex() };
+
+	// Own queue from the back (most recent, still in cache), other queues from the front (oldest, largest chunks of work)
+	for (uint32_t offset{}; offset < threadCount; ++offset)
+	{
+		WorkerQueue& queue{ *m_Queues[(threadIdx + offset) % threadCount] };
+
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (queue.count == 0) continue;
+
+		if (offset == 0)
+		{
+			job = std::move(queue.jobs[(queue.first + queue.count - 1) % s_QueueCapacity]);
+		}
+		else
+		{
+			job = std::move(queue.jobs[queue.first]);
+			queue.first = (queue.first + 1) % s_QueueCapacity;
+		}
+		--queue.count;
+
+		m_QueuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Execute(Job& job)
+{
+	try
+	{
+		job.function();
+	}
+	catch (...)
+	{
+		// Jobs without a counter report to the next PollUncountedException, escaping a worker thread would terminate the program
+		if (!job.pCounter)
+		{
+			std::lock_guard<std::mutex> lock{ m_ExceptionMutex };
+			if (!m_UncountedException) m_UncountedException = std::current_exception();
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock{ job.pCounter->m_Mutex };
+			if (!job.pCounter->m_Exception) job.pCounter->m_Exception = std::current_exception();
+		}
+	}
+
+	Finish(job.pCounter);
+}
+
+void JobSystem::PollUncountedException()
+{
+	std::exception_ptr exception{};
+	{
+		std::lock_guard<std::mutex> lock{ m_ExceptionMutex };
+		std::swap(exception, m_UncountedException);
+	}
+	if (exception) std::rethrow_exception(exception);
+}
+
+void JobSystem::Finish(JobCounter* pCounter)
+{
+	if (!pCounter) return;
+
+	std::vector<Job> continuations{};
+	{
+		std::lock_guard<std::mutex> lock{ pCounter->m_Mutex };
+		if (pCounter->m_Value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			continuations.swap(pCounter->m_Continuations);
+		}
+	}
+
+	for (Job& continuation : continuations) Push(std::move(continuation));
+}
+
+uint32_t JobSystem::GetCurrentThreadIndex() const
+{
+	return s_pThreadJobSystem == this ? s_ThreadIndex : 0;
+}
\ No newline at end of file
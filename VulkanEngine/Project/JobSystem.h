@@ -0,0 +1,145 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+#include <exception>
+#include <memory>
+
+#include "InlineFunction.h"
+
+class JobCounter;
+
+// Stored inline, so scheduling a job never allocates
+using JobFunction = InlineFunction<void()>;
+using JobEntry = void(*)(void* pData, uint32_t index);
+
+struct Job
+{
+	JobFunction function{};
+	JobCounter* pCounter{ nullptr };
+};
+
+// Tracks the unfinished jobs scheduled with it. Jobs that depend on a counter start once it reaches zero.
+class JobCounter final
+{
+public:
+
+	JobCounter();
+	~JobCounter() = default;
+
+	JobCounter(const JobCounter& other) = delete;
+	JobCounter(JobCounter&& other) noexcept = delete;
+	JobCounter& operator=(const JobCounter& other) = delete;
+	JobCounter& operator=(JobCounter&& other) noexcept = delete;
+
+	bool IsDone() const;
+
+private:
+
+	friend class JobSystem;
+
+	std::atomic<uint32_t> m_Value;
+
+	std::mutex m_Mutex;
+	std::vector<Job> m_Continuations;
+	std::exception_ptr m_Exception;
+
+};
+
+// Work stealing job system. Every thread owns a fixed size ring of jobs, it pushes and pops its own jobs at the back
+// and steals from the front of the others when it runs dry. The thread that initialized the system
+// counts as thread 0 and executes jobs while it waits on a counter. A job pushed to a full ring runs right away.
+class JobSystem final
+{
+public:
+
+	JobSystem();
+	~JobSystem() = default;
+
+	JobSystem(const JobSystem& other) = delete;
+	JobSystem(JobSystem&& other) noexcept = delete;
+	JobSystem& operator=(const JobSystem& other) = delete;
+	JobSystem& operator=(JobSystem&& other) noexcept = delete;
+
+	// Spawns threadCount - 1 workers
+	void Initialize(uint32_t threadCount);
+	// Joins the workers, an exception of a job without counter that was never polled is logged
+	void Destroy();
+
+	// The counter is incremented right away and decremented when the job finished.
+	// With a dependency the job is held back until that counter reached zero.
+	void Schedule(JobFunction function, JobCounter* pCounter = nullptr, JobCounter* pDependency = nullptr);
+	// Calls entry(pData, index), for callers that identify their work by an index into their own data
+	void Schedule(JobEntry entry, void* pData, uint32_t index, JobCounter* pCounter = nullptr);
+
+	// Runs the function over [0, count) in ranges of at most grainSize elements and returns once every range finished
+	template<typename Function>
+	void ParallelFor(uint32_t count, uint32_t grainSize, const Function& function)
+	{
+		if (count == 0) return;
+		grainSize = std::max(grainSize, 1u);
+
+		JobCounter counter{};
+		for (uint32_t begin{}; begin < count; begin += grainSize)
+		{
+			const uint32_t end{ std::min(count - begin, grainSize) + begin };
+			Schedule([&function, begin, end]() { function(begin, end); }, &counter);
+		}
+		Wait(counter);
+	}
+
+	// Executes jobs until the counter reached zero, rethrows the first exception thrown by one of its jobs
+	void Wait(JobCounter& counter);
+	// Rethrows the first exception of a job scheduled without counter, called once per frame by the owner
+	void PollUncountedException();
+
+	// Executes one queued job if there is any, for threads that wait on something other than a counter
+	bool TryExecuteJob();
+
+	uint32_t GetThreadCount() const;
+
+	static uint32_t GetDefaultThreadCount();
+
+private:
+
+	// Ring buffer with room for s_QueueCapacity jobs, allocated once
+	struct WorkerQueue
+	{
+		std::vector<Job> jobs{};
+		uint32_t first{};
+		uint32_t count{};
+		std::mutex mutex{};
+	};
+
+	void WorkerLoop(uint32_t threadIdx);
+
+	void Push(Job&& job);
+	bool TryPop(Job& job);
+	void Execute(Job& job);
+	void Finish(JobCounter* pCounter);
+	uint32_t GetCurrentThreadIndex() const;
+
+private:
+
+	std::vector<std::thread> m_Workers;
+	std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+
+	std::atomic<uint32_t> m_QueuedJobCount;
+	std::mutex m_WakeMutex;
+	std::condition_variable m_WakeCondition;
+	bool m_Stopping;
+
+	static constexpr uint32_t s_QueueCapacity{ 1024 };
+
+	// First exception of a job without counter, kept until the next Wait or Destroy
+	std::mutex m_ExceptionMutex;
+	std::exception_ptr m_UncountedException;
+
+};
+
+#endif // !JOBSYSTEM_H
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include <stdexcept>
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+
+#include "Ktx2File.h"
+
+namespace
+{
+	constexpr uint8_t s_Ktx2Identifier[12]{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	struct Ktx2Header
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+	static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must be 80 bytes");
+
+	struct Ktx2LevelIndex
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+	static_assert(sizeof(Ktx2LevelIndex) == 24, "KTX2 level index entry must be 24 bytes");
+}
+
+Ktx2File::Ktx2File()
+	: m_VkFormat{ VK_FORMAT_UNDEFINED }
+	, m_Width{}
+	, m_Height{}
+	, m_Levels{}
+	, m_Data{}
+{
+}
+
+void Ktx2File::LoadFromFile(const std::string& filePath)
+{
+	std::ifstream file{ filePath, std::ios::ate | std::ios::binary };
+	if (!file.is_open())
+	{
+		throw std::runtime_error{ "failed to open ktx2 file: " + filePath };
+	}
+
+	const size_t fileSize{ static_cast<size_t>(file.tellg()) };
+	m_Data.resize(fileSize);
+
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(m_Data.data()), fileSize);
+	file.close();
+
+	if (fileSize < sizeof(Ktx2Header))
+	{
+		throw std::runtime_error{ "ktx2 file is too small: " + filePath };
+	}
+
+	Ktx2Header header{};
+	std::memcpy(&header, m_Data.data(), sizeof(Ktx2Header));
+
+	if (std::memcmp(header.identifier, s_Ktx2Identifier, sizeof(s_Ktx2Identifier)) != 0)
+	{
+		throw std::runtime_error{ "invalid ktx2 identifier: " + filePath };
+	}
+	if (header.vkFormat == VK_FORMAT_UNDEFINED || header.supercompressionScheme != 0)
+	{
+		throw std::runtime_error{ "unsupported ktx2 format or supercompression: " + filePath };
+	}
+	if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+	{
+		throw std::runtime_error{ "only single layer 2D ktx2 textures are supported: " + filePath };
+	}
+
+	m_VkFormat = static_cast<VkFormat>(header.vkFormat);
+	m_Width = header.pixelWidth;
+	m_Height = header.pixelHeight;
+
+	const uint32_t levelCount{ std::max(header.levelCount, 1u) };
+	if (sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex) > fileSize)
+	{
+		throw std::runtime_error{ "ktx2 level index out of range: " + filePath };
+	}
+
+	m_Levels.resize(levelCount);
+	for (uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx)
+	{
+		Ktx2LevelIndex levelIndex{};
+		std::memcpy(&levelIndex, m_Data.data() + sizeof(Ktx2Header) + levelIdx * sizeof(Ktx2LevelIndex), sizeof(Ktx2LevelIndex));
+
+		if (levelIndex.byteOffset + levelIndex.byteLength > fileSize)
+		{
+			throw std::runtime_error{ "ktx2 level data out of range: " + filePath };
+		}
+
+		m_Levels[levelIdx] = Level{ levelIndex.byteOffset, levelIndex.byteLength };
+	}
+}
+
+VkFormat Ktx2File::GetVkFormat() const
+{
+	return m_VkFormat;
+}
+
+uint32_t Ktx2File::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t Ktx2File::GetHeight() const
+{
+	return m_Height;
+}
+
+uint32_t Ktx2File::GetLevelCount() const
+{
+	return static_cast<uint32_t>(m_Levels.size());
+}
+
+const Ktx2File::Level& Ktx2File::GetLevel(uint32_t level) const
+{
+	return m_Levels.at(level);
+}
+
+const std::vector<uint8_t>& Ktx2File::GetData() const
+{
+	return m_Data;
+}
+
+bool Ktx2File::IsKtx2File(const std::string& filePath)
+{
+	std::ifstream file{ filePath, std::ios::binary };
+	if (!file.is_open()) return false;
+
+	uint8_t identifier[sizeof(s_Ktx2Identifier)]{};
+	file.read(reinterpret_cast<char*>(identifier), sizeof(identifier));
+
+	return file.gcount() == sizeof(identifier) && std::memcmp(identifier, s_Ktx2Identifier, sizeof(identifier)) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef KTX2FILE_H
+#define KTX2FILE_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+// Minimal KTX2 reader for the block compressed textures produced by the TextureCooker.
+// Only single layer, single face, non supercompressed 2D textures are supported.
+class Ktx2File final
+{
+public:
+
+	struct Level
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+	};
+
+	Ktx2File();
+	~Ktx2File() = default;
+
+	void LoadFromFile(const std::string& filePath);
+
+	VkFormat GetVkFormat() const;
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	uint32_t GetLevelCount() const;
+	const Level& GetLevel(uint32_t level) const;
+	const std::vector<uint8_t>& GetData() const;
+
+	static bool IsKtx2File(const std::string& filePath);
+
+private:
+
+	VkFormat m_VkFormat;
+	uint32_t m_Width;
+	uint32_t m_Height;
+	std::vector<Level> m_Levels;
+	std::vector<uint8_t> m_Data;
+
+};
+
+#endif // !KTX2FILE_H
\ No newline at end of file
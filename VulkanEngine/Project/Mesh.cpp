@@ -0,0 +1,212 @@
+#include <stdexcept>
+#include <unordered_map>
+#include <atomic>
+
+#include <tiny_obj_loader.h>
+
+#include "Mesh.h"
+#include "VulkanInstance.h"
+
+namespace
+{
+	std::atomic<uint32_t> s_NextMeshId{};
+
+	template<typename VertexType>
+	void LoadObjFile(const std::string& filePath, std::vector<VertexType>& vertices, std::vector<uint32_t>& indices)
+	{
+		tinyobj::attrib_t attrib{};
+		std::vector<tinyobj::shape_t> shapes{};
+		std::vector<tinyobj::material_t> materials{};
+		std::string warn{};
+		std::string err{};
+		if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str()))
+		{
+			throw std::runtime_error{ warn + err };
+		}
+
+		std::unordered_map<VertexType, uint32_t> uniqueVertices{};
+
+		for (const auto& shape : shapes)
+		{
+			for (const auto& index : shape.mesh.indices)
+			{
+				VertexType vertex{};
+
+				// Position
+				vertex.pos =
+				{
+					attrib.vertices[3 * index.vertex_index + 0],
+					attrib.vertices[3 * index.vertex_index + 1],
+					attrib.vertices[3 * index.vertex_index + 2]
+				};
+
+				// Texture coordinates
+				if (index.texcoord_index >= 0)
+				{
+					vertex.texCoord =
+					{
+						attrib.texcoords[2 * index.texcoord_index + 0],
+						1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
+					};
+				}
+
+				// Colors
+				if (!attrib.colors.empty())
+				{
+					vertex.color =
+					{
+						attrib.colors[3 * index.vertex_index + 0],
+						attrib.colors[3 * index.vertex_index + 1],
+						attrib.colors[3 * index.vertex_index + 2]
+					};
+				}
+				else vertex.color = { 1.0f, 1.0f, 1.0f }; // Default white if no color data
+
+				// Add vertex to the list
+				if (uniqueVertices.count(vertex) == 0)
+				{
+					uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
+					vertices.emplace_back(vertex);
+				}
+
+				indices.emplace_back(uniqueVertices[vertex]);
+			}
+		}
+	}
+}
+
+Mesh::Mesh()
+	: m_NrIndices{}
+	, m_VertexBuffer{}
+	, m_IndexBuffer{}
+	, m_Bounds{}
+	, m_Id{}
+{
+}
+
+void Mesh::Initialize(const VulkanInstance& instance, [[maybe_unused]] const CommandPool& commandPool, const void* vertexData, VkDeviceSize vertexDataSize, const std::vector<uint32_t>& indices, const AABB& bounds)
+{
+	const VkDevice& device{ instance.GetVkDevice() };
+	const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
+	Queue& graphicsQueue{ instance.GetQueue(QueueType::Graphics) };
+	Queue& transferQueue{ instance.GetQueue(QueueType::Transfer) };
+
+	constexpr VkBufferUsageFlags stagingBufferUsage{ VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+	constexpr VkMemoryPropertyFlags stagingBufferProperties{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+	constexpr VkMemoryPropertyFlags bufferProperties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+
+	m_NrIndices = static_cast<uint32_t>(indices.size());
+	m_Bounds = bounds;
+	m_Id = s_NextMeshId++;
+
+	/////// Vertex Buffer ///////
+	constexpr VkBufferUsageFlags vertexBufferUsage{ VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+
+	DataBuffer stagingVBuffer{};
+	stagingVBuffer.Initialize(device, phyDevice, stagingBufferProperties, vertexDataSize, stagingBufferUsage);
+	stagingVBuffer.Upload(device, vertexDataSize, vertexData);
+
+	m_VertexBuffer.Initialize(device, phyDevice, bufferProperties, vertexDataSize, vertexBufferUsage);
+
+	/////// Index Buffer ///////
+	const VkDeviceSize indexBufferSize{ sizeof(indices[0]) * indices.size() };
+	constexpr VkBufferUsageFlags indexBufferUsage{ VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+
+	DataBuffer stagingIBuffer{};
+	stagingIBuffer.Initialize(device, phyDevice, stagingBufferProperties, indexBufferSize, stagingBufferUsage);
+	stagingIBuffer.Upload(device, indexBufferSize, indices.data());
+
+	m_IndexBuffer.Initialize(device, phyDevice, bufferProperties, indexBufferSize, indexBufferUsage);
+
+	/////// Upload ///////
+	if (&transferQueue == &graphicsQueue)
+	{
+		// No separate transfer queue on this device
+		DataBuffer::CopyBuffer(graphicsQueue, device, stagingVBuffer, m_VertexBuffer, vertexDataSize);
+		DataBuffer::CopyBuffer(graphicsQueue, device, stagingIBuffer, m_IndexBuffer, indexBufferSize);
+	}
+	else
+	{
+		const uint32_t transferFamily{ transferQueue.GetFamilyIndex() };
+		const uint32_t graphicsFamily{ graphicsQueue.GetFamilyIndex() };
+		const bool transferOwnership{ transferFamily != graphicsFamily };
+
+		const QueueSubmission upload{ transferQueue.SubmitImmediate(device, [&](VkCommandBuffer commandBuffer)
+			{
+				VkBufferCopy vertexRegion{};
+				vertexRegion.size = vertexDataSize;
+				vkCmdCopyBuffer(commandBuffer, stagingVBuffer.GetVkBuffer(), m_VertexBuffer.GetVkBuffer(), 1, &vertexRegion);
+
+				VkBufferCopy indexRegion{};
+				indexRegion.size = indexBufferSize;
+				vkCmdCopyBuffer(commandBuffer, stagingIBuffer.GetVkBuffer(), m_IndexBuffer.GetVkBuffer(), 1, &indexRegion);
+
+				if (!transferOwnership) return;
+				Queue::ReleaseBufferOwnership(commandBuffer, m_VertexBuffer.GetVkBuffer(), transferFamily, graphicsFamily, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+				Queue::ReleaseBufferOwnership(commandBuffer, m_IndexBuffer.GetVkBuffer(), transferFamily, graphicsFamily, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+			}) };
+
+		// Nothing waits on the cpu, the graphics queue waits on the upload before vertex input of this and every later submission.
+		// Buffers with exclusive sharing mode also have to be acquired by the graphics family before use.
+		graphicsQueue.SubmitImmediate(device, [&](VkCommandBuffer commandBuffer)
+			{
+				if (!transferOwnership) return;
+				Queue::AcquireBufferOwnership(commandBuffer, m_VertexBuffer.GetVkBuffer(), transferFamily, graphicsFamily, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+				Queue::AcquireBufferOwnership(commandBuffer, m_IndexBuffer.GetVkBuffer(), transferFamily, graphicsFamily, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+			}, { transferQueue.GetWait(upload, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT) });
+	}
+
+	// Staging buffers are retired on the graphics queue, which is the last to wait on the copies //
+	stagingVBuffer.DeferDestroy();
+	stagingIBuffer.DeferDestroy();
+}
+
+void Mesh::Destroy(VkDevice device)
+{
+	m_VertexBuffer.Destroy(device);
+	m_IndexBuffer.Destroy(device);
+	m_NrIndices = 0;
+}
+
+void Mesh::DeferDestroy()
+{
+	m_VertexBuffer.DeferDestroy();
+	m_IndexBuffer.DeferDestroy();
+	m_NrIndices = 0;
+}
+
+void Mesh::Bind(VkCommandBuffer commandBuffer) const
+{
+	m_VertexBuffer.BindAsVertexBuffer(commandBuffer);
+	m_IndexBuffer.BindAsIndexBuffer(commandBuffer);
+}
+
+uint32_t Mesh::GetIndexCount() const
+{
+	return m_NrIndices;
+}
+
+VkDeviceSize Mesh::GetSizeInBytes() const
+{
+	return m_VertexBuffer.GetSizeInBytes() + m_IndexBuffer.GetSizeInBytes();
+}
+
+const AABB& Mesh::GetBounds() const
+{
+	return m_Bounds;
+}
+
+uint32_t Mesh::GetId() const
+{
+	return m_Id;
+}
+
+void Mesh::LoadFromFile(const std::string& filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices)
+{
+	LoadObjFile(filePath, vertices, indices);
+}
+
+void Mesh::LoadFromFile(const std::string& filePath, std::vector<Vertex3DIR>& vertices, std::vector<uint32_t>& indices)
+{
+	LoadObjFile(filePath, vertices, indices);
+}
\ No newline at end of file
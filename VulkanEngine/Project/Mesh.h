@@ -0,0 +1,50 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "DataBuffer.h"
+#include "Vertex.h"
+#include "Bounds.h"
+
+class CommandPool;
+class VulkanInstance;
+
+// GPU resident vertex and index data, shared between models through the AssetRegistry
+class Mesh final
+{
+public:
+
+	Mesh();
+	~Mesh() = default;
+
+	void Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const void* vertexData, VkDeviceSize vertexDataSize, const std::vector<uint32_t>& indices, const AABB& bounds);
+	void Destroy(VkDevice device);
+	void DeferDestroy();
+
+	void Bind(VkCommandBuffer commandBuffer) const;
+
+	uint32_t GetIndexCount() const;
+	VkDeviceSize GetSizeInBytes() const;
+	// Object space bounds of the vertex positions
+	const AABB& GetBounds() const;
+	// Unique per created mesh, used to group draws of the same mesh
+	uint32_t GetId() const;
+
+	static void LoadFromFile(const std::string& filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices);
+	static void LoadFromFile(const std::string& filePath, std::vector<Vertex3DIR>& vertices, std::vector<uint32_t>& indices);
+
+private:
+
+	uint32_t m_NrIndices;
+	DataBuffer m_VertexBuffer;
+	DataBuffer m_IndexBuffer;
+	AABB m_Bounds;
+	uint32_t m_Id;
+
+};
+
+#endif // !MESH_H
\ No newline at end of file
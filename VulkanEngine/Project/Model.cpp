@@ -5,9 +5,11 @@
 #include <tiny_obj_loader.h>
 
 #include "Model.h"
+#include "AssetRegistry.h"
 #include "VulkanUtils.h"
 #include "Camera.h"
 #include "VulkanInstance.h"
+#include "EngineSettings.h"
 
 // MODEL 2D //
 Model2D::Model2D()
@@ -19,21 +21,21 @@ Model2D::Model2D()
 {
 }
 
-void Model2D::Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::string& modelFilePath)
+void Model2D::Initialize(const VulkanInstance& instance, [[maybe_unused]] const CommandPool& cmndP, const std::string& modelFilePath)
 {
     m_NrIndices = 0;
     std::vector<Vertex2D> vertices{};
     std::vector<uint32_t> indices{};
 
     LoadModelFromFile(modelFilePath, vertices, indices);
-    InitDataBuffers(instance, cmndP, vertices, indices);
+    InitDataBuffers(instance, vertices, indices);
     UpdateModelMatrix();
 }
 
-void Model2D::Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices)
+void Model2D::Initialize(const VulkanInstance& instance, [[maybe_unused]] const CommandPool& cmndP, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices)
 {
     m_NrIndices = static_cast<uint32_t>(indices.size());
-    InitDataBuffers(instance, cmndP, vertices, indices);
+    InitDataBuffers(instance, vertices, indices);
     UpdateModelMatrix();
 }
 
@@ -43,6 +45,13 @@ void Model2D::Destroy(VkDevice device)
     m_IndexBuffer.Destroy(device);
 }
 
+void Model2D::DeferDestroy()
+{
+    m_VertexBuffer.DeferDestroy();
+    m_IndexBuffer.DeferDestroy();
+    m_NrIndices = 0;
+}
+
 void Model2D::SetPosition(const glm::vec2& pos)
 {
     m_Transform.position = pos;
@@ -118,11 +127,11 @@ void Model2D::LoadModelFromFile(const std::string& filePath, std::vector<Vertex2
     m_NrIndices = static_cast<uint32_t>(indices.size());
 }
 
-void Model2D::InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices)
+void Model2D::InitDataBuffers(const VulkanInstance& instance, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices)
 {
     const VkDevice& device{ instance.GetVkDevice() };
     const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
-    const VkQueue& graphQ{ instance.GetGraphicsQueue() };
+    Queue& graphicsQueue{ instance.GetQueue(QueueType::Graphics) };
 
     constexpr VkBufferUsageFlags stagingBufferUsage{ VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
     constexpr VkMemoryPropertyFlags stagingBufferProperties{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
@@ -137,7 +146,7 @@ void Model2D::InitDataBuffers(const VulkanInstance& instance, const CommandPool&
     stagingVBuffer.Upload(device, vertexBufferSize, vertices.data());
 
     m_VertexBuffer.Initialize(device, phyDevice, bufferProperties, vertexBufferSize, vertexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingVBuffer, m_VertexBuffer, vertexBufferSize);
+    DataBuffer::CopyBuffer(graphicsQueue, device, stagingVBuffer, m_VertexBuffer, vertexBufferSize);
 
     /////// Index Buffer ///////
     const VkDeviceSize indexBufferSize{ sizeof(indices[0]) * indices.size() };
@@ -148,11 +157,11 @@ void Model2D::InitDataBuffers(const VulkanInstance& instance, const CommandPool&
     stagingIBuffer.Upload(device, indexBufferSize, indices.data());
 
     m_IndexBuffer.Initialize(device, phyDevice, bufferProperties, indexBufferSize, indexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingIBuffer, m_IndexBuffer, indexBufferSize);
+    DataBuffer::CopyBuffer(graphicsQueue, device, stagingIBuffer, m_IndexBuffer, indexBufferSize);
 
-    // Destroy Staging Buffers //
-    stagingVBuffer.Destroy(device);
-    stagingIBuffer.Destroy(device);
+    // Destroy Staging Buffers once the copies are done //
+    stagingVBuffer.DeferDestroy();
+    stagingIBuffer.DeferDestroy();
 }
 
 void Model2D::UpdateModelMatrix()
@@ -164,34 +173,30 @@ void Model2D::UpdateModelMatrix()
 Model3D::Model3D()
     : m_Transform{}
     , m_ModelMatrix{}
-    , m_NrIndices{}
-    , m_VertexBuffer{}
-    , m_IndexBuffer{}
+    , m_pMesh{ nullptr }
+    , m_FilePath{}
+    , m_IsStatic{ false }
+    , m_Material{}
 {
 }
 
 void Model3D::Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& modelFilePath)
 {
-    m_NrIndices = 0;
-    std::vector<Vertex3D> vertices{};
-    std::vector<uint32_t> indices{};
-
-    LoadModelFromFile(modelFilePath, vertices, indices);
-    InitDataBuffers(instance, commandPool, vertices, indices);
+    m_pMesh = AssetRegistry::Get().AcquireMesh(instance, commandPool, modelFilePath, VertexType::Vertex3D);
+    m_FilePath = modelFilePath;
     UpdateModelMatrix();
 }
 
 void Model3D::Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices)
 {
-    m_NrIndices = static_cast<uint32_t>(indices.size());
-    InitDataBuffers(instance, cmndP, vertices, indices);
+    m_pMesh = AssetRegistry::Get().AcquireMesh(instance, cmndP, vertices, indices);
     UpdateModelMatrix();
 }
 
-void Model3D::Destroy(VkDevice device)
+void Model3D::Destroy([[maybe_unused]] VkDevice device)
 {
-    m_VertexBuffer.Destroy(device);
-    m_IndexBuffer.Destroy(device);
+    AssetRegistry::Get().ReleaseMesh(m_pMesh);
+    m_pMesh = nullptr;
 }
 
 void Model3D::SetPosition(const glm::vec3& position)
@@ -223,126 +228,67 @@ void Model3D::SetTranform(const Transform3D& transform)
     UpdateModelMatrix();
 }
 
-void Model3D::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
+void Model3D::SetModelMatrix(const glm::mat4& modelMatrix)
 {
-    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ModelUBO), &m_ModelMatrix);
-
-    m_VertexBuffer.BindAsVertexBuffer(commandBuffer);
-    m_IndexBuffer.BindAsIndexBuffer(commandBuffer);
-
-    vkCmdDrawIndexed(commandBuffer, m_NrIndices, 1, 0, 0, 0);
+    m_ModelMatrix.model = modelMatrix;
 }
 
-void Model3D::LoadModelFromFile(const std::string& filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices)
+void Model3D::SetStatic(bool isStatic)
 {
-    tinyobj::attrib_t attrib{};
-    std::vector<tinyobj::shape_t> shapes{};
-    std::vector<tinyobj::material_t> materials{};
-    std::string warn{};
-    std::string err{};
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str()))
-    {
-        throw std::runtime_error{ warn + err };
-    }
-
-    std::unordered_map<Vertex3D, uint32_t> uniqueVertices{};
-
-    for (const auto& shape : shapes)
-    {
-        for (const auto& index : shape.mesh.indices)
-        {
-            Vertex3D vertex{};
-
-            // Position
-            vertex.pos =
-            {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
-
-            // Texture coordinates
-            if (index.texcoord_index >= 0)
-            {
-                vertex.texCoord =
-                {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-                };
-            }
-
-            //// Normals
-            //if (index.normal_index >= 0)
-            //{
-            //    vertex.normal =
-            //    {
-            //        attrib.normals[3 * index.normal_index + 0],
-            //        attrib.normals[3 * index.normal_index + 1],
-            //        attrib.normals[3 * index.normal_index + 2]
-            //    };
-            //}
-
-            // Colors
-            if (!attrib.colors.empty())
-            {
-                vertex.color =
-                {
-                    attrib.colors[3 * index.vertex_index + 0],
-                    attrib.colors[3 * index.vertex_index + 1],
-                    attrib.colors[3 * index.vertex_index + 2]
-                };
-            }
-            else vertex.color = { 1.0f, 1.0f, 1.0f }; // Default white if no color data
-
-            // Add vertex to the list
-            if (uniqueVertices.count(vertex) == 0)
-            {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.emplace_back(vertex);
-            }
-
-            indices.emplace_back(uniqueVertices[vertex]);
-        }
-    }
+    m_IsStatic = isStatic;
+}
 
-    m_NrIndices = static_cast<uint32_t>(indices.size());
+void Model3D::SetMaterial(uint32_t material)
+{
+    m_Material = material;
 }
 
-void Model3D::InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices)
+bool Model3D::IsStatic() const
 {
-    const VkDevice& device{ instance.GetVkDevice() };
-    const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
-    const VkQueue& graphQ{ instance.GetGraphicsQueue() };
+    return m_IsStatic;
+}
 
-    constexpr VkBufferUsageFlags stagingBufferUsage{ VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
-    constexpr VkMemoryPropertyFlags stagingBufferProperties{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
-    constexpr VkMemoryPropertyFlags bufferProperties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+uint32_t Model3D::GetMaterial() const
+{
+    return m_Material;
+}
 
-    /////// Vertex Buffer ///////
-    const VkDeviceSize vertexBufferSize{ sizeof(vertices[0]) * vertices.size() };
-    constexpr VkBufferUsageFlags vertexBufferUsage{ VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT };
+const std::string& Model3D::GetFilePath() const
+{
+    return m_FilePath;
+}
 
-    DataBuffer stagingVBuffer{};
-    stagingVBuffer.Initialize(device, phyDevice, stagingBufferProperties, vertexBufferSize, stagingBufferUsage);
-    stagingVBuffer.Upload(device, vertexBufferSize, vertices.data());
+const Transform3D& Model3D::GetTransform() const
+{
+    return m_Transform;
+}
 
-    m_VertexBuffer.Initialize(device, phyDevice, bufferProperties, vertexBufferSize, vertexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingVBuffer, m_VertexBuffer, vertexBufferSize);
+const ModelUBO& Model3D::GetModelMatrix() const
+{
+    return m_ModelMatrix;
+}
 
-    /////// Index Buffer ///////
-    const VkDeviceSize indexBufferSize{ sizeof(indices[0]) * indices.size() };
-    constexpr VkBufferUsageFlags indexBufferUsage{ VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT };
+AABB Model3D::GetWorldBounds() const
+{
+    return m_pMesh->GetBounds().Transform(m_ModelMatrix.model);
+}
 
-    DataBuffer stagingIBuffer{};
-    stagingIBuffer.Initialize(device, phyDevice, stagingBufferProperties, indexBufferSize, stagingBufferUsage);
-    stagingIBuffer.Upload(device, indexBufferSize, indices.data());
+const Mesh* Model3D::GetMesh() const
+{
+    return m_pMesh;
+}
 
-    m_IndexBuffer.Initialize(device, phyDevice, bufferProperties, indexBufferSize, indexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingIBuffer, m_IndexBuffer, indexBufferSize);
+void Model3D::DrawInstances(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance, DrawRecordState& state) const
+{
+    if (state.pMesh != m_pMesh)
+    {
+        m_pMesh->Bind(commandBuffer);
+        state.pMesh = m_pMesh;
+        ++state.stats.vertexBufferBinds;
+    }
 
-    // Destroy staging buffers //
-    stagingVBuffer.Destroy(device);
-    stagingIBuffer.Destroy(device);
+    vkCmdDrawIndexed(commandBuffer, m_pMesh->GetIndexCount(), instanceCount, 0, 0, firstInstance);
+    ++state.stats.drawCount;
 }
 
 void Model3D::UpdateModelMatrix()
@@ -355,11 +301,12 @@ void Model3D::UpdateModelMatrix()
 Model3DIR::Model3DIR()
     : m_Transforms{}
     , m_ModelMatrices{}
-    , m_NrIndices{}
     , m_InstanceCount{}
-    , m_VertexBuffer{}
-    , m_IndexBuffer{}
-    , m_InstanceBuffer{}
+    , m_Material{}
+    , m_pMesh{ nullptr }
+    , m_InstanceBuffers{}
+    , m_InstanceBufferVersions{}
+    , m_MatrixVersion{}
 {
 }
 
@@ -368,16 +315,11 @@ void Model3DIR::Initialize(const VulkanInstance& instance, const CommandPool& co
     if (instanceCount < 1) throw std::exception{ "Model: invalid instanceCount value!" };
 
     m_InstanceCount = instanceCount;
-    m_Transforms.resize(instanceCount);
-    m_ModelMatrices.resize(instanceCount);
-
-    m_NrIndices = 0;
-    std::vector<Vertex3DIR> vertices{};
-    std::vector<uint32_t> indices{};
+    m_Transforms.Resize(instanceCount);
+    m_ModelMatrices.resize(m_Transforms.GetPaddedCount());
 
-    LoadModelFromFile(modelFilePath, vertices, indices);
-    InitDataBuffers(instance, commandPool, vertices, indices);
-    UpdateModelBuffer(instance.GetVkDevice());
+    m_pMesh = AssetRegistry::Get().AcquireMesh(instance, commandPool, modelFilePath, VertexType::Vertex3DIR);
+    InitInstanceBuffers(instance);
 }
 
 void Model3DIR::Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices, uint32_t instanceCount)
@@ -385,32 +327,42 @@ void Model3DIR::Initialize(const VulkanInstance& instance, const CommandPool& cm
     if (instanceCount < 1) throw std::exception{ "Model: invalid instanceCount value!" };
 
     m_InstanceCount = instanceCount;
-    m_Transforms.resize(instanceCount);
-    m_ModelMatrices.resize(instanceCount);
+    m_Transforms.Resize(instanceCount);
+    m_ModelMatrices.resize(m_Transforms.GetPaddedCount());
 
-    m_NrIndices = static_cast<uint32_t>(indices.size());
-    InitDataBuffers(instance, cmndP, vertices, indices);
-    for (uint32_t instanceIdx{}; instanceIdx < instanceCount; ++instanceIdx)
-    {
-        UpdateModelMatrix(instanceIdx);
-    }
+    m_pMesh = AssetRegistry::Get().AcquireMesh(instance, cmndP, vertices, indices);
+    InitInstanceBuffers(instance);
 }
 
 void Model3DIR::Destroy(VkDevice device)
 {
-    // Destroy Vulkan buffers
-    m_VertexBuffer.Destroy(device);
-    m_IndexBuffer.Destroy(device);
-    m_InstanceBuffer.Destroy(device);
+    // Release shared mesh and destroy Vulkan buffers
+    AssetRegistry::Get().ReleaseMesh(m_pMesh);
+    m_pMesh = nullptr;
+    for (DataBuffer& instanceBuffer : m_InstanceBuffers) instanceBuffer.Destroy(device);
+    m_InstanceBuffers.clear();
+    m_InstanceBufferVersions.clear();
 
     // Clear model matrices and transforms
-    m_Transforms.clear();
+    m_Transforms.Clear();
+    m_ModelMatrices.clear();
+}
+
+void Model3DIR::DeferDestroy()
+{
+    AssetRegistry::Get().ReleaseMesh(m_pMesh);
+    m_pMesh = nullptr;
+    for (DataBuffer& instanceBuffer : m_InstanceBuffers) instanceBuffer.DeferDestroy();
+    m_InstanceBuffers.clear();
+    m_InstanceBufferVersions.clear();
+
+    m_Transforms.Clear();
     m_ModelMatrices.clear();
 }
 
 void Model3DIR::SetPosition(const glm::vec3& position)
 {
-    for (size_t idx{}; idx < m_ModelMatrices.size(); ++idx)
+    for (size_t idx{}; idx < m_Transforms.GetCount(); ++idx)
     {
         SetPosition(static_cast<uint32_t>(idx), position);
     }
@@ -418,16 +370,15 @@ void Model3DIR::SetPosition(const glm::vec3& position)
 
 void Model3DIR::SetPosition(uint32_t instanceIndex, const glm::vec3& position)
 {
-    if (instanceIndex < m_Transforms.size())
+    if (instanceIndex < m_Transforms.GetCount())
     {
-        m_Transforms[instanceIndex].position = position;
-        UpdateModelMatrix(instanceIndex);
+        m_Transforms.SetPosition(instanceIndex, position);
     }
 }
 
 void Model3DIR::SetRotation(const glm::vec3& rotation)
 {
-    for (size_t idx{}; idx < m_ModelMatrices.size(); ++idx)
+    for (size_t idx{}; idx < m_Transforms.GetCount(); ++idx)
     {
         SetRotation(static_cast<uint32_t>(idx), rotation);
     }
@@ -435,16 +386,15 @@ void Model3DIR::SetRotation(const glm::vec3& rotation)
 
 void Model3DIR::SetRotation(uint32_t instanceIndex, const glm::vec3& rotation)
 {
-    if (instanceIndex < m_Transforms.size())
+    if (instanceIndex < m_Transforms.GetCount())
     {
-        m_Transforms[instanceIndex].rotation = glm::quat{ rotation };
-        UpdateModelMatrix(instanceIndex);
+        m_Transforms.SetRotation(instanceIndex, glm::quat{ rotation });
     }
 }
 
 void Model3DIR::SetScale(const glm::vec3& scale)
 {
-    for (size_t idx{}; idx < m_ModelMatrices.size(); ++idx)
+    for (size_t idx{}; idx < m_Transforms.GetCount(); ++idx)
     {
         SetScale(static_cast<uint32_t>(idx), scale);
     }
@@ -452,7 +402,7 @@ void Model3DIR::SetScale(const glm::vec3& scale)
 
 void Model3DIR::SetScale(float scale)
 {
-    for (size_t idx{}; idx < m_ModelMatrices.size(); ++idx)
+    for (size_t idx{}; idx < m_Transforms.GetCount(); ++idx)
     {
         SetScale(static_cast<uint32_t>(idx), scale);
     }
@@ -460,10 +410,9 @@ void Model3DIR::SetScale(float scale)
 
 void Model3DIR::SetScale(uint32_t instanceIndex, const glm::vec3& scale)
 {
-    if (instanceIndex < m_Transforms.size())
+    if (instanceIndex < m_Transforms.GetCount())
     {
-        m_Transforms[instanceIndex].scale = scale;
-        UpdateModelMatrix(instanceIndex);
+        m_Transforms.SetScale(instanceIndex, scale);
     }
 }
 
@@ -474,167 +423,94 @@ void Model3DIR::SetScale(uint32_t instanceIndex, float scale)
 
 void Model3DIR::SetTransform(uint32_t instanceIndex, const Transform3D& transform)
 {
-    if (instanceIndex < m_Transforms.size())
+    if (instanceIndex < m_Transforms.GetCount())
     {
-        m_Transforms[instanceIndex] = transform;
-        UpdateModelMatrix(instanceIndex);
+        m_Transforms.SetTransform(instanceIndex, transform);
     }
 }
 
+void Model3DIR::SetMaterial(uint32_t material)
+{
+    m_Material = material;
+}
+
 uint32_t Model3DIR::GetInstanceCount() const
 {
     return m_InstanceCount;
 }
 
-void Model3DIR::Update(VkDevice device)
+uint32_t Model3DIR::GetMaterial() const
 {
-    UpdateModelBuffer(device);
+    return m_Material;
 }
 
-void Model3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
+AABB Model3DIR::GetInstanceBounds(uint32_t instanceIndex) const
 {
-    m_VertexBuffer.BindAsVertexBuffer(commandBuffer);
-    m_InstanceBuffer.BindAsVertexBuffer(commandBuffer, 1);
+    return m_pMesh->GetBounds().Transform(m_ModelMatrices[instanceIndex].model);
+}
 
-    m_IndexBuffer.BindAsIndexBuffer(commandBuffer);
+bool Model3DIR::Update(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame)
+{
+    const bool changed{ m_Transforms.UpdateMatrices(m_ModelMatrices, &jobSystem) };
+    if (changed) ++m_MatrixVersion;
 
-    vkCmdDrawIndexed(commandBuffer, m_NrIndices, m_InstanceCount, 0, 0, 0);
+    // The other frames' buffers catch up when their frame slot comes around
+    if (m_InstanceBufferVersions[currentFrame] != m_MatrixVersion) UpdateModelBuffer(device, currentFrame);
+    return changed;
 }
 
-void Model3DIR::LoadModelFromFile(const std::string& filePath, std::vector<Vertex3DIR>& vertices, std::vector<uint32_t>& indices)
+void Model3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const
 {
-    tinyobj::attrib_t attrib{};
-    std::vector<tinyobj::shape_t> shapes{};
-    std::vector<tinyobj::material_t> materials{};
-    std::string warn{};
-    std::string err{};
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filePath.c_str()))
-    {
-        throw std::runtime_error{ warn + err };
-    }
-
-    std::unordered_map<Vertex3DIR, uint32_t> uniqueVertices{};
+    DrawRecordState state{};
+    Draw(commandBuffer, pipelineLayout, currentFrame, state);
+}
 
-    for (const auto& shape : shapes)
+void Model3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, DrawRecordState& state) const
+{
+    if (state.pMesh != m_pMesh)
     {
-        for (const auto& index : shape.mesh.indices)
-        {
-            Vertex3DIR vertex{};
+        m_pMesh->Bind(commandBuffer);
+        state.pMesh = m_pMesh;
+        ++state.stats.vertexBufferBinds;
+    }
 
-            // Position
-            vertex.pos =
-            {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
+    m_InstanceBuffers[currentFrame].BindAsVertexBuffer(commandBuffer, 1);
+    ++state.stats.vertexBufferBinds;
 
-            // Texture coordinates
-            if (index.texcoord_index >= 0)
-            {
-                vertex.texCoord =
-                {
-                    attrib.texcoords[2 * index.texcoord_index + 0],
-                    1.0f - attrib.texcoords[2 * index.texcoord_index + 1]
-                };
-            }
+    vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(m_Material), &m_Material);
 
-            //// Normals
-            //if (index.normal_index >= 0)
-            //{
-            //    vertex.normal =
-            //    {
-            //        attrib.normals[3 * index.normal_index + 0],
-            //        attrib.normals[3 * index.normal_index + 1],
-            //        attrib.normals[3 * index.normal_index + 2]
-            //    };
-            //}
-
-            // Colors
-            if (!attrib.colors.empty())
-            {
-                vertex.color =
-                {
-                    attrib.colors[3 * index.vertex_index + 0],
-                    attrib.colors[3 * index.vertex_index + 1],
-                    attrib.colors[3 * index.vertex_index + 2]
-                };
-            }
-            else vertex.color = { 1.0f, 1.0f, 1.0f }; // Default white if no color data
-
-            // Add vertex to the list
-            if (uniqueVertices.count(vertex) == 0)
-            {
-                uniqueVertices[vertex] = static_cast<uint32_t>(vertices.size());
-                vertices.emplace_back(vertex);
-            }
-
-            indices.emplace_back(uniqueVertices[vertex]);
-        }
-    }
+    vkCmdDrawIndexed(commandBuffer, m_pMesh->GetIndexCount(), m_InstanceCount, 0, 0, 0);
+    ++state.stats.drawCount;
+}
 
-    m_NrIndices = static_cast<uint32_t>(indices.size());
+const Mesh* Model3DIR::GetMesh() const
+{
+    return m_pMesh;
 }
 
-void Model3DIR::InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices)
+void Model3DIR::InitInstanceBuffers(const VulkanInstance& instance)
 {
     const VkDevice& device = instance.GetVkDevice();
     const VkPhysicalDevice& phyDevice = instance.GetVkPhysicalDevice();
-    const VkQueue& graphQ = instance.GetGraphicsQueue();
-
-    constexpr VkBufferUsageFlags stagingBufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    constexpr VkMemoryPropertyFlags stagingBufferProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    constexpr VkMemoryPropertyFlags bufferProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-    // Vertex Buffer
-    VkDeviceSize vertexBufferSize = sizeof(vertices[0]) * vertices.size();
-    constexpr VkBufferUsageFlags vertexBufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    const uint32_t framesInFlight{ EngineSettings::Get().GetMaxFramesInFlight() };
 
-    DataBuffer stagingVBuffer{};
-    stagingVBuffer.Initialize(device, phyDevice, stagingBufferProperties, vertexBufferSize, stagingBufferUsage);
-    stagingVBuffer.Upload(device, vertexBufferSize, vertices.data());
+    // Written by the cpu every time the instances move, so the buffers stay host visible and need no staging copy
+    const VkDeviceSize instanceBufferSize = sizeof(ModelUBO) * m_InstanceCount;
+    constexpr VkBufferUsageFlags instanceBufferUsage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    constexpr VkMemoryPropertyFlags instanceBufferProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
 
-    m_VertexBuffer.Initialize(device, phyDevice, bufferProperties, vertexBufferSize, vertexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingVBuffer, m_VertexBuffer, vertexBufferSize);
-
-    // Index Buffer
-    VkDeviceSize indexBufferSize = sizeof(indices[0]) * indices.size();
-    constexpr VkBufferUsageFlags indexBufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-
-    DataBuffer stagingIBuffer{};
-    stagingIBuffer.Initialize(device, phyDevice, stagingBufferProperties, indexBufferSize, stagingBufferUsage);
-    stagingIBuffer.Upload(device, indexBufferSize, indices.data());
-
-    m_IndexBuffer.Initialize(device, phyDevice, bufferProperties, indexBufferSize, indexBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingIBuffer, m_IndexBuffer, indexBufferSize);
-
-    // Instance Buffer
-    VkDeviceSize instanceBufferSize = sizeof(ModelUBO) * m_InstanceCount;
-    constexpr VkBufferUsageFlags instanceBufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-
-    DataBuffer stagingInstanceBuffer{};
-    stagingInstanceBuffer.Initialize(device, phyDevice, stagingBufferProperties, instanceBufferSize, stagingBufferUsage);
-    stagingInstanceBuffer.Upload(device, instanceBufferSize, m_ModelMatrices.data());
-
-    m_InstanceBuffer.Initialize(device, phyDevice, stagingBufferProperties, instanceBufferSize, instanceBufferUsage);
-    DataBuffer::CopyBuffer(graphQ, device, commandPool, stagingInstanceBuffer, m_InstanceBuffer, instanceBufferSize);
-
-    // Destroy staging buffers
-    stagingVBuffer.Destroy(device);
-    stagingIBuffer.Destroy(device);
-    stagingInstanceBuffer.Destroy(device);
-}
-
-void Model3DIR::UpdateModelMatrix(uint32_t instanceIndex)
-{
-    if (instanceIndex < m_ModelMatrices.size())
+    m_InstanceBuffers.resize(framesInFlight);
+    for (DataBuffer& instanceBuffer : m_InstanceBuffers)
     {
-        m_ModelMatrices[instanceIndex].model = m_Transforms[instanceIndex].GetModelMatrix();
+        instanceBuffer.Initialize(device, phyDevice, instanceBufferProperties, instanceBufferSize, instanceBufferUsage);
+        instanceBuffer.Upload(device, instanceBufferSize, m_ModelMatrices.data());
     }
+    m_InstanceBufferVersions.assign(framesInFlight, m_MatrixVersion);
 }
 
-void Model3DIR::UpdateModelBuffer(VkDevice device) const
+void Model3DIR::UpdateModelBuffer(VkDevice device, uint32_t currentFrame)
 {
-    const VkDeviceSize& bufferSize{ m_InstanceBuffer.GetSizeInBytes() };
-    m_InstanceBuffer.Upload(device, bufferSize, m_ModelMatrices.data());
+    DataBuffer& instanceBuffer{ m_InstanceBuffers[currentFrame] };
+    instanceBuffer.Upload(device, instanceBuffer.GetSizeInBytes(), m_ModelMatrices.data());
+    m_InstanceBufferVersions[currentFrame] = m_MatrixVersion;
 }
\ No newline at end of file
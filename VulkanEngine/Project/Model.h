@@ -9,11 +9,15 @@
 #include "VulkanStructs.h"
 #include "DataBuffer.h"
 #include "Texture.h"
+#include "Mesh.h"
+#include "TransformSoA.h"
 
 #include "Vertex.h"
+#include "DrawList.h"
 
 class Camera;
 class VulkanInstance;
+class JobSystem;
 
 class Model2D final
 {
@@ -25,6 +29,7 @@ public:
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::string& modelFilePath);
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices);
 	void Destroy(VkDevice device);
+	void DeferDestroy();
 
 	void SetPosition(const glm::vec2& pos);
 	void SetRotation(float angle);
@@ -36,7 +41,7 @@ public:
 private:
 
 	void LoadModelFromFile(const std::string& filePath, std::vector<Vertex2D>& vertices, std::vector<uint32_t>& indices);
-	void InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices);
+	void InitDataBuffers(const VulkanInstance& instance, const std::vector<Vertex2D>& vertices, const std::vector<uint32_t>& indices);
 
 	void UpdateModelMatrix();
 
@@ -59,6 +64,7 @@ public:
 
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::string& modelFilePath);
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices);
+	// The mesh is released to the AssetRegistry, which defers its destruction once it is no longer referenced
 	void Destroy(VkDevice device);
 
 	void SetPosition(const glm::vec3& position);
@@ -66,23 +72,39 @@ public:
 	void SetScale(const glm::vec3& scale);
 	void SetScale(float scale);
 	void SetTranform(const Transform3D& transform);
-
-	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+	// Overrides the matrix of the local transform, used for the world matrices of a scene graph
+	void SetModelMatrix(const glm::mat4& modelMatrix);
+	// Static models never move, the scene merges them into its static batch instead of drawing them one by one
+	void SetStatic(bool isStatic);
+	// Slot of the model's texture in the texture table
+	void SetMaterial(uint32_t material);
+
+	bool IsStatic() const;
+	uint32_t GetMaterial() const;
+	// Empty when the model was created from vertices
+	const std::string& GetFilePath() const;
+
+	const Transform3D& GetTransform() const;
+	const ModelUBO& GetModelMatrix() const;
+	AABB GetWorldBounds() const;
+	const Mesh* GetMesh() const;
+
+	// Draws the mesh for a range of the bound instance stream, the mesh bind is skipped when the previous draw already bound it
+	void DrawInstances(VkCommandBuffer commandBuffer, uint32_t instanceCount, uint32_t firstInstance, DrawRecordState& state) const;
 
 private:
 
-	void LoadModelFromFile(const std::string& filePath, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices);
-	void InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3D>& vertices, const std::vector<uint32_t>& indices);
-
 	void UpdateModelMatrix();
 
 private:
 
 	Transform3D m_Transform;
 	ModelUBO m_ModelMatrix;
-	uint32_t m_NrIndices;
-	DataBuffer m_VertexBuffer;
-	DataBuffer m_IndexBuffer;
+	const Mesh* m_pMesh;
+
+	std::string m_FilePath;
+	bool m_IsStatic;
+	uint32_t m_Material;
 
 };
 
@@ -96,6 +118,7 @@ public:
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::string& modelFilePath, uint32_t instanceCount);
 	void Initialize(const VulkanInstance& instance, const CommandPool& cmndP, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices, uint32_t instanceCount);
 	void Destroy(VkDevice device);
+	void DeferDestroy();
 
 	void SetPosition(const glm::vec3& position);
 	void SetPosition(uint32_t instanceIndex, const glm::vec3& position);
@@ -109,30 +132,42 @@ public:
 	void SetScale(uint32_t instanceIndex, float scale);
 
 	void SetTransform(uint32_t instanceIndex, const Transform3D& transform);
+	// Slot of the texture in the texture table, shared by every instance
+	void SetMaterial(uint32_t material);
 
 	uint32_t GetInstanceCount() const;
+	uint32_t GetMaterial() const;
+	// Valid once the Update after the last change of the instance ran
+	AABB GetInstanceBounds(uint32_t instanceIndex) const;
 
-	void Update(VkDevice device);
-	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+	// Recomposes the matrices of the changed instances, returns false when nothing changed.
+	// The instance buffer of the frame is only uploaded when it is behind the matrices, so call it once the frame slot is free.
+	bool Update(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame);
+	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const;
+	// Skips the mesh bind when the previous draw already bound the same mesh, the instance buffer and material are always set
+	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, DrawRecordState& state) const;
+
+	const Mesh* GetMesh() const;
 
 private:
 
-	void LoadModelFromFile(const std::string& filePath, std::vector<Vertex3DIR>& vertices, std::vector<uint32_t>& indices);
-	void InitDataBuffers(const VulkanInstance& instance, const CommandPool& commandPool, const std::vector<Vertex3DIR>& vertices, const std::vector<uint32_t>& indices);
-	void UpdateModelMatrix(uint32_t instanceIndex);
-	void UpdateModelBuffer(VkDevice device) const;
+	void InitInstanceBuffers(const VulkanInstance& instance);
+	void UpdateModelBuffer(VkDevice device, uint32_t currentFrame);
 
 private:
 
-	std::vector<Transform3D> m_Transforms;
-	std::vector<ModelUBO> m_ModelMatrices;
+	TransformSoA m_Transforms;
+	std::vector<ModelUBO> m_ModelMatrices; // Padded to whole transform blocks, only the first m_InstanceCount are uploaded
 
 	uint32_t m_InstanceCount;
-	uint32_t m_NrIndices;
+	uint32_t m_Material;
 
-	DataBuffer m_VertexBuffer;
-	DataBuffer m_IndexBuffer;
-	DataBuffer m_InstanceBuffer;
+	const Mesh* m_pMesh;
+
+	// Host visible, one per frame in flight so the cpu never writes a buffer the gpu may still be reading
+	std::vector<DataBuffer> m_InstanceBuffers;
+	std::vector<uint64_t> m_InstanceBufferVersions; // Matrix version every instance buffer holds
+	uint64_t m_MatrixVersion;
 
 };
 #endif // !MODEL_H
@@ -0,0 +1,114 @@
+#include <stdexcept>
+
+#include "ParallelCommandRecorder.h"
+#include "VulkanInstance.h"
+#include "JobSystem.h"
+
+ParallelCommandRecorder::ParallelCommandRecorder()
+	: m_WorkerContexts{}
+	, m_FrameRecordings{}
+{
+}
+
+void ParallelCommandRecorder::Initialize(const VulkanInstance& instance, uint32_t workerCount, uint32_t framesInFlight)
+{
+	if (workerCount == 0) throw std::runtime_error{ "ParallelCommandRecorder needs at least one worker!" };
+
+	m_WorkerContexts.resize(framesInFlight);
+	m_FrameRecordings.resize(framesInFlight);
+	for (std::vector<WorkerContext>& frameContexts : m_WorkerContexts)
+	{
+		frameContexts.resize(workerCount);
+		for (WorkerContext& context : frameContexts)
+		{
+			// Pools are reset as a whole when a frame is re-recorded, individual buffers are never reset
+			context.commandPool.Initialize(instance, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+		}
+	}
+}
+
+void ParallelCommandRecorder::Destroy(VkDevice device)
+{
+	for (std::vector<WorkerContext>& frameContexts : m_WorkerContexts)
+	{
+		for (WorkerContext& context : frameContexts)
+		{
+			// Destroying the pool frees its command buffers
+			context.commandPool.Destroy(device);
+			context.commandBuffers.clear();
+		}
+	}
+	m_WorkerContexts.clear();
+	m_FrameRecordings.clear();
+}
+
+bool ParallelCommandRecorder::IsUpToDate(uint32_t currentFrame, uint64_t contentVersion) const
+{
+	const FrameRecording& frameRecording{ m_FrameRecordings[currentFrame] };
+	return frameRecording.isRecorded && frameRecording.contentVersion == contentVersion;
+}
+
+const std::vector<VkCommandBuffer>& ParallelCommandRecorder::Record(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame,
+	const VkCommandBufferInheritanceInfo& inheritanceInfo, std::span<const RecordJob> jobs, uint64_t contentVersion)
+{
+	std::vector<WorkerContext>& frameContexts{ m_WorkerContexts[currentFrame] };
+	const uint32_t workerCount{ static_cast<uint32_t>(frameContexts.size()) };
+
+	FrameRecording& frameRecording{ m_FrameRecordings[currentFrame] };
+
+	// The last graphics submission of this frame slot has been waited on, so its buffers are no longer in use
+	for (const WorkerContext& context : frameContexts)
+	{
+		context.commandPool.Reset(device);
+	}
+	frameRecording.isRecorded = false;
+
+	std::vector<VkCommandBuffer>& recordedBuffers{ frameRecording.commandBuffers };
+	recordedBuffers.assign(jobs.size(), VK_NULL_HANDLE);
+
+	// A context is only used by its own job, so it does not matter which thread ends up running it
+	JobCounter workerJobs{};
+	for (uint32_t workerIdx{}; workerIdx < workerCount && workerIdx < jobs.size(); ++workerIdx)
+	{
+		WorkerContext& context{ frameContexts[workerIdx] };
+		jobSystem.Schedule([&, workerIdx]()
+			{
+				RecordWorkerJobs(device, context, workerIdx, inheritanceInfo, jobs, recordedBuffers);
+			}, &workerJobs);
+	}
+	jobSystem.Wait(workerJobs);
+
+	frameRecording.contentVersion = contentVersion;
+	frameRecording.isRecorded = true;
+
+	return recordedBuffers;
+}
+
+const std::vector<VkCommandBuffer>& ParallelCommandRecorder::GetRecorded(uint32_t currentFrame) const
+{
+	return m_FrameRecordings[currentFrame].commandBuffers;
+}
+
+void ParallelCommandRecorder::RecordWorkerJobs(VkDevice device, WorkerContext& context, uint32_t workerIdx, const VkCommandBufferInheritanceInfo& inheritanceInfo,
+	std::span<const RecordJob> jobs, std::vector<VkCommandBuffer>& recordedBuffers) const
+{
+	const size_t workerCount{ m_WorkerContexts.front().size() };
+
+	// Jobs are dealt out round robin so large scenes split into chunks spread evenly over the workers
+	size_t bufferIdx{};
+	for (size_t jobIdx{ workerIdx }; jobIdx < jobs.size(); jobIdx += workerCount, ++bufferIdx)
+	{
+		if (bufferIdx == context.commandBuffers.size())
+		{
+			context.commandBuffers.emplace_back(context.commandPool.CreateCommandBuffer(device, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+		}
+
+		// Buffers are replayed every frame until the content changes, so they are not one time submit
+		const CommandBuffer& commandBuffer{ context.commandBuffers[bufferIdx] };
+		commandBuffer.BeginRecording(inheritanceInfo, VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT);
+		jobs[jobIdx](commandBuffer.GetVkCommandBuffer());
+		commandBuffer.EndRecording();
+
+		recordedBuffers[jobIdx] = commandBuffer.GetVkCommandBuffer();
+	}
+}
\ No newline at end of file
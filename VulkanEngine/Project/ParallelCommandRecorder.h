@@ -0,0 +1,70 @@
+#ifndef PARALLELCOMMANDRECORDER_H
+#define PARALLELCOMMANDRECORDER_H
+
+#include <vector>
+#include <span>
+#include <vulkan/vulkan.h>
+
+#include "CommandPool.h"
+#include "CommandBuffer.h"
+#include "InlineFunction.h"
+
+class VulkanInstance;
+class JobSystem;
+
+// Stored inline, so building the job list of a frame only allocates in the frame arena
+using RecordJob = InlineFunction<void(VkCommandBuffer)>;
+
+// Records secondary command buffers on the job system and keeps them per frame in flight until their content changes.
+// Every worker slot owns one command pool per frame in flight, so a pool is never touched by two threads at once.
+class ParallelCommandRecorder final
+{
+public:
+
+	ParallelCommandRecorder();
+	~ParallelCommandRecorder() = default;
+
+	ParallelCommandRecorder(const ParallelCommandRecorder& other) = delete;
+	ParallelCommandRecorder(ParallelCommandRecorder&& other) noexcept = delete;
+	ParallelCommandRecorder& operator=(const ParallelCommandRecorder& other) = delete;
+	ParallelCommandRecorder& operator=(ParallelCommandRecorder&& other) noexcept = delete;
+
+	void Initialize(const VulkanInstance& instance, uint32_t workerCount, uint32_t framesInFlight);
+	void Destroy(VkDevice device);
+
+	// True when the cached buffers of this frame were recorded for the given content version
+	bool IsUpToDate(uint32_t currentFrame, uint64_t contentVersion) const;
+
+	// Every job is recorded into its own secondary command buffer, the returned buffers keep the order of the jobs
+	const std::vector<VkCommandBuffer>& Record(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame,
+		const VkCommandBufferInheritanceInfo& inheritanceInfo, std::span<const RecordJob> jobs, uint64_t contentVersion);
+
+	const std::vector<VkCommandBuffer>& GetRecorded(uint32_t currentFrame) const;
+
+private:
+
+	struct WorkerContext
+	{
+		CommandPool commandPool{};
+		std::vector<CommandBuffer> commandBuffers{};
+	};
+
+	void RecordWorkerJobs(VkDevice device, WorkerContext& context, uint32_t workerIdx, const VkCommandBufferInheritanceInfo& inheritanceInfo,
+		std::span<const RecordJob> jobs, std::vector<VkCommandBuffer>& recordedBuffers) const;
+
+private:
+
+	struct FrameRecording
+	{
+		std::vector<VkCommandBuffer> commandBuffers{};
+		uint64_t contentVersion{};
+		bool isRecorded{ false };
+	};
+
+	// [frame][worker]
+	std::vector<std::vector<WorkerContext>> m_WorkerContexts;
+	std::vector<FrameRecording> m_FrameRecordings;
+
+};
+
+#endif // !PARALLELCOMMANDRECORDER_H
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include <functional>
+
+#include "PipelineBuilder.h"
+
+namespace
+{
+	template<typename ValueType>
+	void HashCombine(size_t& seed, const ValueType& value)
+	{
+		seed ^= std::hash<ValueType>{}(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+
+	bool IsShaderConfigEqual(const ShaderConfig& left, const ShaderConfig& right)
+	{
+		return left.filePath == right.filePath && left.entryPoint == right.entryPoint && left.stage == right.stage;
+	}
+}
+
+// DESCRIPTOR BINDING //
+
+bool DescriptorBindingDesc::operator==(const DescriptorBindingDesc& other) const
+{
+	return binding == other.binding && type == other.type && stages == other.stages;
+}
+
+// PIPELINE DESC //
+
+PipelineDesc PipelineDesc::GetWireframeVariant() const
+{
+	PipelineDesc variant{ *this };
+	variant.polygonMode = VK_POLYGON_MODE_LINE;
+	variant.cullMode = VK_CULL_MODE_NONE;
+	return variant;
+}
+
+PipelineDesc PipelineDesc::GetDepthOnlyVariant() const
+{
+	PipelineDesc variant{ *this };
+	variant.shaders.fragShaderConfig = ShaderConfig{};
+	variant.depthTestEnable = true;
+	variant.depthWriteEnable = true;
+	variant.blendEnable = false;
+	variant.colorWriteMask = 0;
+	return variant;
+}
+
+size_t PipelineDesc::GetHash() const
+{
+	size_t seed{ GetLayoutHash() };
+
+	HashCombine(seed, shaders.vertShaderConfig.filePath);
+	HashCombine(seed, shaders.vertShaderConfig.entryPoint);
+	HashCombine(seed, shaders.fragShaderConfig.filePath);
+	HashCombine(seed, shaders.fragShaderConfig.entryPoint);
+	HashCombine(seed, static_cast<int>(vertexType));
+	HashCombine(seed, static_cast<int>(topology));
+	HashCombine(seed, static_cast<int>(polygonMode));
+	HashCombine(seed, cullMode);
+	HashCombine(seed, static_cast<int>(frontFace));
+	HashCombine(seed, depthTestEnable);
+	HashCombine(seed, depthWriteEnable);
+	HashCombine(seed, static_cast<int>(depthCompareOp));
+	HashCombine(seed, blendEnable);
+	HashCombine(seed, colorWriteMask);
+	HashCombine(seed, renderPass);
+	HashCombine(seed, subpass);
+	HashCombine(seed, static_cast<int>(colorFormat));
+	HashCombine(seed, static_cast<int>(depthFormat));
+
+	return seed;
+}
+
+size_t PipelineDesc::GetLayoutHash() const
+{
+	size_t seed{};
+
+	for (const DescriptorBindingDesc& descriptorBinding : descriptorBindings)
+	{
+		HashCombine(seed, descriptorBinding.binding);
+		HashCombine(seed, static_cast<int>(descriptorBinding.type));
+		HashCombine(seed, descriptorBinding.stages);
+	}
+	for (VkDescriptorSetLayout setLayout : externalSetLayouts)
+	{
+		HashCombine(seed, setLayout);
+	}
+	HashCombine(seed, pushConstantStages);
+	HashCombine(seed, pushConstantSize);
+
+	return seed;
+}
+
+bool PipelineDesc::operator==(const PipelineDesc& other) const
+{
+	return IsLayoutEqual(other) &&
+		IsShaderConfigEqual(shaders.vertShaderConfig, other.shaders.vertShaderConfig) &&
+		IsShaderConfigEqual(shaders.fragShaderConfig, other.shaders.fragShaderConfig) &&
+		vertexType == other.vertexType &&
+		topology == other.topology &&
+		polygonMode == other.polygonMode &&
+		cullMode == other.cullMode &&
+		frontFace == other.frontFace &&
+		depthTestEnable == other.depthTestEnable &&
+		depthWriteEnable == other.depthWriteEnable &&
+		depthCompareOp == other.depthCompareOp &&
+		blendEnable == other.blendEnable &&
+		colorWriteMask == other.colorWriteMask &&
+		renderPass == other.renderPass &&
+		subpass == other.subpass &&
+		colorFormat == other.colorFormat &&
+		depthFormat == other.depthFormat;
+}
+
+bool PipelineDesc::IsLayoutEqual(const PipelineDesc& other) const
+{
+	return descriptorBindings == other.descriptorBindings &&
+		externalSetLayouts == other.externalSetLayouts &&
+		pushConstantStages == other.pushConstantStages &&
+		pushConstantSize == other.pushConstantSize;
+}
+
+// PIPELINE BUILDER //
+
+PipelineBuilder& PipelineBuilder::SetShaders(const ShadersConfigs& shaders)
+{
+	m_Desc.shaders = shaders;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetVertexInput(VertexType vertexType, VkPrimitiveTopology topology)
+{
+	m_Desc.vertexType = vertexType;
+	m_Desc.topology = topology;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetRasterizer(VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace)
+{
+	m_Desc.polygonMode = polygonMode;
+	m_Desc.cullMode = cullMode;
+	m_Desc.frontFace = frontFace;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetDepthState(bool testEnable, bool writeEnable, VkCompareOp compareOp)
+{
+	m_Desc.depthTestEnable = testEnable;
+	m_Desc.depthWriteEnable = writeEnable;
+	m_Desc.depthCompareOp = compareOp;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetBlending(bool blendEnable)
+{
+	m_Desc.blendEnable = blendEnable;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::AddDescriptorBinding(uint32_t binding, VkDescriptorType type, VkShaderStageFlags stages)
+{
+	m_Desc.descriptorBindings.emplace_back(DescriptorBindingDesc{ binding, type, stages });
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::AddDescriptorSetLayout(VkDescriptorSetLayout setLayout)
+{
+	m_Desc.externalSetLayouts.emplace_back(setLayout);
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetPushConstant(VkShaderStageFlags stages, uint32_t size)
+{
+	m_Desc.pushConstantStages = stages;
+	m_Desc.pushConstantSize = size;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetRenderPass(VkRenderPass renderPass, uint32_t subpass)
+{
+	m_Desc.renderPass = renderPass;
+	m_Desc.subpass = subpass;
+	return *this;
+}
+
+PipelineBuilder& PipelineBuilder::SetAttachmentFormats(VkFormat colorFormat, VkFormat depthFormat)
+{
+	m_Desc.colorFormat = colorFormat;
+	m_Desc.depthFormat = depthFormat;
+	return *this;
+}
+
+const PipelineDesc& PipelineBuilder::GetDesc() const
+{
+	return m_Desc;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef PIPELINEBUILDER_H
+#define PIPELINEBUILDER_H
+
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "VulkanStructs.h"
+#include "Vertex.h"
+
+struct DescriptorBindingDesc
+{
+	uint32_t binding{};
+	VkDescriptorType type{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER };
+	VkShaderStageFlags stages{};
+
+	bool operator==(const DescriptorBindingDesc& other) const;
+};
+
+// Hashable description of all fixed function and shader state of a graphics pipeline.
+// Viewport and scissor are always dynamic so the description does not depend on the swapchain extent.
+struct PipelineDesc
+{
+	ShadersConfigs shaders{};
+	VertexType vertexType{ VertexType::Vertex3D };
+	VkPrimitiveTopology topology{ VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST };
+
+	// Rasterizer
+	VkPolygonMode polygonMode{ VK_POLYGON_MODE_FILL };
+	VkCullModeFlags cullMode{ VK_CULL_MODE_BACK_BIT };
+	VkFrontFace frontFace{ VK_FRONT_FACE_COUNTER_CLOCKWISE };
+
+	// Depth
+	bool depthTestEnable{ true };
+	bool depthWriteEnable{ true };
+	VkCompareOp depthCompareOp{ VK_COMPARE_OP_LESS };
+
+	// Blend
+	bool blendEnable{ false };
+	VkColorComponentFlags colorWriteMask{ VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT };
+
+	// Layout
+	std::vector<DescriptorBindingDesc> descriptorBindings{};
+	std::vector<VkDescriptorSetLayout> externalSetLayouts{}; // Sets 1 and up, owned outside the cache
+	VkShaderStageFlags pushConstantStages{};
+	uint32_t pushConstantSize{};
+
+	VkRenderPass renderPass{ VK_NULL_HANDLE };
+	uint32_t subpass{};
+
+	// Dynamic rendering, used when no render pass is set
+	VkFormat colorFormat{ VK_FORMAT_UNDEFINED };
+	VkFormat depthFormat{ VK_FORMAT_UNDEFINED };
+
+	PipelineDesc GetWireframeVariant() const;
+	PipelineDesc GetDepthOnlyVariant() const;
+
+	size_t GetHash() const;
+	size_t GetLayoutHash() const;
+
+	bool operator==(const PipelineDesc& other) const;
+	bool IsLayoutEqual(const PipelineDesc& other) const;
+};
+
+class PipelineBuilder final
+{
+public:
+
+	PipelineBuilder() = default;
+	~PipelineBuilder() = default;
+
+	PipelineBuilder& SetShaders(const ShadersConfigs& shaders);
+	PipelineBuilder& SetVertexInput(VertexType vertexType, VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+	PipelineBuilder& SetRasterizer(VkPolygonMode polygonMode, VkCullModeFlags cullMode, VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	PipelineBuilder& SetDepthState(bool testEnable, bool writeEnable, VkCompareOp compareOp = VK_COMPARE_OP_LESS);
+	PipelineBuilder& SetBlending(bool blendEnable);
+	PipelineBuilder& AddDescriptorBinding(uint32_t binding, VkDescriptorType type, VkShaderStageFlags stages);
+	PipelineBuilder& AddDescriptorSetLayout(VkDescriptorSetLayout setLayout);
+	PipelineBuilder& SetPushConstant(VkShaderStageFlags stages, uint32_t size);
+	PipelineBuilder& SetRenderPass(VkRenderPass renderPass, uint32_t subpass = 0);
+	PipelineBuilder& SetAttachmentFormats(VkFormat colorFormat, VkFormat depthFormat);
+
+	const PipelineDesc& GetDesc() const;
+
+private:
+
+	PipelineDesc m_Desc;
+
+};
+
+#endif // !PIPELINEBUILDER_H
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+#include "PipelineCache.h"
+
+namespace
+{
+	// Prefix written in front of the driver blob, the Vulkan cache header itself has no driver version
+	struct PipelineCacheFileHeader
+	{
+		uint32_t magic;
+		uint32_t driverVersion;
+		uint64_t dataSize;
+	};
+
+	constexpr uint32_t s_PipelineCacheMagic{ 0x43504556 }; // "VEPC"
+}
+
+PipelineCache::PipelineCache()
+	: m_VkPipelineCache{ VK_NULL_HANDLE }
+	, m_DeviceProperties{}
+	, m_FilePath{}
+	, m_IsWarm{ false }
+{
+}
+
+void PipelineCache::Initialize(VkDevice device, VkPhysicalDevice phyDevice, const std::string& filePath)
+{
+	m_FilePath = filePath;
+	vkGetPhysicalDeviceProperties(phyDevice, &m_DeviceProperties);
+
+	const std::vector<uint8_t> cacheData{ LoadCacheData() };
+	m_IsWarm = !cacheData.empty();
+
+	VkPipelineCacheCreateInfo cacheInfo{};
+	cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	cacheInfo.initialDataSize = cacheData.size();
+	cacheInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+	if (vkCreatePipelineCache(device, &cacheInfo, nullptr, &m_VkPipelineCache) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create pipeline cache!" };
+	}
+}
+
+void PipelineCache::Destroy(VkDevice device)
+{
+	if (m_VkPipelineCache != VK_NULL_HANDLE)
+	{
+		Save(device);
+
+		vkDestroyPipelineCache(device, m_VkPipelineCache, nullptr);
+		m_VkPipelineCache = VK_NULL_HANDLE;
+	}
+}
+
+void PipelineCache::Save(VkDevice device) const
+{
+	size_t dataSize{};
+	if (vkGetPipelineCacheData(device, m_VkPipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) return;
+
+	std::vector<uint8_t> cacheData(dataSize);
+	if (vkGetPipelineCacheData(device, m_VkPipelineCache, &dataSize, cacheData.data()) != VK_SUCCESS) return;
+
+	const PipelineCacheFileHeader fileHeader{ s_PipelineCacheMagic, m_DeviceProperties.driverVersion, dataSize };
+
+	std::ofstream file{ m_FilePath, std::ios::binary | std::ios::trunc };
+	if (!file.is_open())
+	{
+		std::cout << "Failed to write pipeline cache: " << m_FilePath << "\n";
+		return;
+	}
+
+	file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+	file.write(reinterpret_cast<const char*>(cacheData.data()), static_cast<std::streamsize>(dataSize));
+}
+
+const VkPipelineCache& PipelineCache::GetVkPipelineCache() const
+{
+	return m_VkPipelineCache;
+}
+
+bool PipelineCache::IsWarm() const
+{
+	return m_IsWarm;
+}
+
+std::vector<uint8_t> PipelineCache::LoadCacheData() const
+{
+	std::ifstream file{ m_FilePath, std::ios::ate | std::ios::binary };
+	if (!file.is_open()) return {};
+
+	const size_t fileSize{ static_cast<size_t>(file.tellg()) };
+	if (fileSize < sizeof(PipelineCacheFileHeader)) return {};
+
+	PipelineCacheFileHeader fileHeader{};
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+
+	if (fileHeader.magic != s_PipelineCacheMagic ||
+		fileHeader.driverVersion != m_DeviceProperties.driverVersion ||
+		fileHeader.dataSize != fileSize - sizeof(PipelineCacheFileHeader))
+	{
+		std::cout << "Discarding stale pipeline cache: " << m_FilePath << "\n";
+		return {};
+	}
+
+	std::vector<uint8_t> cacheData(static_cast<size_t>(fileHeader.dataSize));
+	file.read(reinterpret_cast<char*>(cacheData.data()), static_cast<std::streamsize>(cacheData.size()));
+
+	if (!IsCacheDataValid(cacheData))
+	{
+		std::cout << "Discarding pipeline cache from a different device: " << m_FilePath << "\n";
+		return {};
+	}
+
+	return cacheData;
+}
+
+bool PipelineCache::IsCacheDataValid(const std::vector<uint8_t>& cacheData) const
+{
+	if (cacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne)) return false;
+
+	VkPipelineCacheHeaderVersionOne header{};
+	std::memcpy(&header, cacheData.data(), sizeof(header));
+
+	return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne) &&
+		header.headerSize <= cacheData.size() &&
+		header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+		header.vendorID == m_DeviceProperties.vendorID &&
+		header.deviceID == m_DeviceProperties.deviceID &&
+		std::memcmp(header.pipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef PIPELINECACHE_H
+#define PIPELINECACHE_H
+
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+// VkPipelineCache that is seeded from and written back to disk.
+// Cache data is only reused when it was produced by the same device and driver.
+class PipelineCache final
+{
+public:
+
+	PipelineCache();
+	~PipelineCache() = default;
+
+	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, const std::string& filePath);
+	void Destroy(VkDevice device);
+
+	void Save(VkDevice device) const;
+
+	const VkPipelineCache& GetVkPipelineCache() const;
+	bool IsWarm() const;
+
+private:
+
+	std::vector<uint8_t> LoadCacheData() const;
+	bool IsCacheDataValid(const std::vector<uint8_t>& cacheData) const;
+
+private:
+
+	VkPipelineCache m_VkPipelineCache;
+	VkPhysicalDeviceProperties m_DeviceProperties;
+	std::string m_FilePath;
+	bool m_IsWarm;
+
+};
+
+#endif // !PIPELINECACHE_H
\ No newline at end of file
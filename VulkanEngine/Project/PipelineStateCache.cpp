@@ -0,0 +1,335 @@
+#include <stdexcept>
+#include <array>
+#include <functional>
+
+#include "PipelineStateCache.h"
+#include "ShaderCache.h"
+#include "Shader.h"
+#include "Vertex.h"
+
+namespace
+{
+	struct VertexInputDescriptions
+	{
+		std::vector<VkVertexInputBindingDescription> bindings{};
+		std::vector<VkVertexInputAttributeDescription> attributes{};
+	};
+
+	template<typename BindingArray, typename AttributeArray>
+	VertexInputDescriptions MakeVertexInputDescriptions(const BindingArray& bindings, const AttributeArray& attributes)
+	{
+		return VertexInputDescriptions
+		{
+			std::vector<VkVertexInputBindingDescription>{ bindings.begin(), bindings.end() },
+			std::vector<VkVertexInputAttributeDescription>{ attributes.begin(), attributes.end() }
+		};
+	}
+
+	VertexInputDescriptions GetVertexInputDescriptions(VertexType vertexType)
+	{
+		switch (vertexType)
+		{
+		case VertexType::Vertex2D:
+			return MakeVertexInputDescriptions(Descriptions::Get2DBindingDescriptions(), Descriptions::Get2DAttributeDescriptions());
+		case VertexType::Vertex3D:
+			return MakeVertexInputDescriptions(Descriptions::Get3DBindingDescriptions(), Descriptions::Get3DAttributeDescriptions());
+		case VertexType::Vertex3DIR:
+			return MakeVertexInputDescriptions(Descriptions::Get3DIRBindingDescriptions(), Descriptions::Get3DIRAttributeDescriptions());
+		}
+		throw std::runtime_error{ "unknown vertex type!" };
+	}
+}
+
+PipelineStateCache::PipelineStateCache()
+	: m_VkPipelineCache{ VK_NULL_HANDLE }
+	, m_pShaderCache{ nullptr }
+	, m_FillModeNonSolidSupported{ false }
+	, m_SetLayouts{}
+	, m_PipelineLayouts{}
+	, m_Pipelines{}
+	, m_CacheMutex{}
+{
+}
+
+void PipelineStateCache::Initialize(VkPhysicalDevice phyDevice, VkPipelineCache pipelineCache, ShaderCache& shaderCache)
+{
+	m_VkPipelineCache = pipelineCache;
+	m_pShaderCache = &shaderCache;
+
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(phyDevice, &supportedFeatures);
+	m_FillModeNonSolidSupported = supportedFeatures.fillModeNonSolid == VK_TRUE;
+}
+
+void PipelineStateCache::Destroy(VkDevice device)
+{
+	std::lock_guard<std::mutex> lock{ m_CacheMutex };
+
+	for (auto& [hash, entry] : m_Pipelines)
+	{
+		vkDestroyPipeline(device, entry.pipeline, nullptr);
+	}
+	m_Pipelines.clear();
+
+	for (auto& [hash, entry] : m_PipelineLayouts)
+	{
+		vkDestroyPipelineLayout(device, entry.pipelineLayout, nullptr);
+	}
+	m_PipelineLayouts.clear();
+
+	for (auto& [hash, entry] : m_SetLayouts)
+	{
+		vkDestroyDescriptorSetLayout(device, entry.setLayout, nullptr);
+	}
+	m_SetLayouts.clear();
+}
+
+VkDescriptorSetLayout PipelineStateCache::GetDescriptorSetLayout(VkDevice device, const std::vector<DescriptorBindingDesc>& bindings)
+{
+	const size_t hash{ HashBindings(bindings) };
+
+	std::lock_guard<std::mutex> lock{ m_CacheMutex };
+
+	const auto [begin, end] { m_SetLayouts.equal_range(hash) };
+	for (auto it{ begin }; it != end; ++it)
+	{
+		if (it->second.bindings == bindings) return it->second.setLayout;
+	}
+
+	std::vector<VkDescriptorSetLayoutBinding> layoutBindings{};
+	layoutBindings.reserve(bindings.size());
+	for (const DescriptorBindingDesc& binding : bindings)
+	{
+		VkDescriptorSetLayoutBinding layoutBinding{};
+		layoutBinding.binding = binding.binding;
+		layoutBinding.descriptorCount = 1;
+		layoutBinding.descriptorType = binding.type;
+		layoutBinding.pImmutableSamplers = VK_NULL_HANDLE;
+		layoutBinding.stageFlags = binding.stages;
+		layoutBindings.emplace_back(layoutBinding);
+	}
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
+	layoutInfo.pBindings = layoutBindings.data();
+
+	VkDescriptorSetLayout setLayout{ VK_NULL_HANDLE };
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &setLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create descriptor set layout!" };
+	}
+
+	m_SetLayouts.emplace(hash, SetLayoutEntry{ bindings, setLayout });
+	return setLayout;
+}
+
+VkPipelineLayout PipelineStateCache::GetPipelineLayout(VkDevice device, const PipelineDesc& desc)
+{
+	const VkDescriptorSetLayout setLayout{ GetDescriptorSetLayout(device, desc.descriptorBindings) };
+	const size_t hash{ desc.GetLayoutHash() };
+
+	std::lock_guard<std::mutex> lock{ m_CacheMutex };
+
+	const auto [begin, end] { m_PipelineLayouts.equal_range(hash) };
+	for (auto it{ begin }; it != end; ++it)
+	{
+		if (it->second.desc.IsLayoutEqual(desc)) return it->second.pipelineLayout;
+	}
+
+	VkPushConstantRange pushConstantRange{};
+	pushConstantRange.stageFlags = desc.pushConstantStages;
+	pushConstantRange.offset = 0;
+	pushConstantRange.size = desc.pushConstantSize;
+
+	std::vector<VkDescriptorSetLayout> setLayouts{ setLayout };
+	setLayouts.insert(setLayouts.end(), desc.externalSetLayouts.begin(), desc.externalSetLayouts.end());
+
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+	pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+	pipelineLayoutInfo.pushConstantRangeCount = desc.pushConstantSize > 0 ? 1 : 0;
+	pipelineLayoutInfo.pPushConstantRanges = desc.pushConstantSize > 0 ? &pushConstantRange : VK_NULL_HANDLE;
+
+	VkPipelineLayout pipelineLayout{ VK_NULL_HANDLE };
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, VK_NULL_HANDLE, &pipelineLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create pipeline layout!" };
+	}
+
+	m_PipelineLayouts.emplace(hash, PipelineLayoutEntry{ desc, pipelineLayout });
+	return pipelineLayout;
+}
+
+VkPipeline PipelineStateCache::GetPipeline(VkDevice device, const PipelineDesc& requestedDesc)
+{
+	// Devices without fillModeNonSolid get the filled pipeline for wireframe requests
+	PipelineDesc desc{ requestedDesc };
+	if (desc.polygonMode != VK_POLYGON_MODE_FILL && !m_FillModeNonSolidSupported)
+	{
+		desc.polygonMode = VK_POLYGON_MODE_FILL;
+	}
+
+	const size_t hash{ desc.GetHash() };
+
+	{
+		std::lock_guard<std::mutex> lock{ m_CacheMutex };
+
+		const auto [begin, end] { m_Pipelines.equal_range(hash) };
+		for (auto it{ begin }; it != end; ++it)
+		{
+			if (it->second.desc == desc) return it->second.pipeline;
+		}
+	}
+
+	// Compiling happens outside the lock so different pipelines can be built in parallel
+	const VkPipelineLayout pipelineLayout{ GetPipelineLayout(device, desc) };
+	const VkPipeline pipeline{ CreatePipeline(device, desc, pipelineLayout) };
+
+	std::lock_guard<std::mutex> lock{ m_CacheMutex };
+
+	const auto [begin, end] { m_Pipelines.equal_range(hash) };
+	for (auto it{ begin }; it != end; ++it)
+	{
+		if (it->second.desc == desc)
+		{
+			// Another thread built the same pipeline in the meantime
+			vkDestroyPipeline(device, pipeline, nullptr);
+			return it->second.pipeline;
+		}
+	}
+
+	m_Pipelines.emplace(hash, PipelineEntry{ desc, pipeline });
+	return pipeline;
+}
+
+uint32_t PipelineStateCache::GetPipelineCount() const
+{
+	std::lock_guard<std::mutex> lock{ m_CacheMutex };
+	return static_cast<uint32_t>(m_Pipelines.size());
+}
+
+VkPipeline PipelineStateCache::CreatePipeline(VkDevice device, const PipelineDesc& desc, VkPipelineLayout pipelineLayout) const
+{
+	std::vector<VkPipelineShaderStageCreateInfo> shaderStages{};
+	shaderStages.emplace_back(m_pShaderCache->GetShader(device, desc.shaders.vertShaderConfig).GetPipelineShaderStageInfo());
+	if (!desc.shaders.fragShaderConfig.filePath.empty())
+	{
+		shaderStages.emplace_back(m_pShaderCache->GetShader(device, desc.shaders.fragShaderConfig).GetPipelineShaderStageInfo());
+	}
+
+	const VertexInputDescriptions vertexInput{ GetVertexInputDescriptions(desc.vertexType) };
+
+	VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+	vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexInput.bindings.size());
+	vertexInputInfo.pVertexBindingDescriptions = vertexInput.bindings.data();
+	vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInput.attributes.size());
+	vertexInputInfo.pVertexAttributeDescriptions = vertexInput.attributes.data();
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssembly{ Shader::GetInputAssemblyStateInfo() };
+	inputAssembly.topology = desc.topology;
+
+	std::array<VkDynamicState, 2> dynamicStates
+	{
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR
+	};
+	VkPipelineDynamicStateCreateInfo dynamicState{};
+	dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+	dynamicState.pDynamicStates = dynamicStates.data();
+
+	VkPipelineViewportStateCreateInfo viewportState{};
+	viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount = 1;
+	viewportState.scissorCount = 1;
+
+	VkPipelineRasterizationStateCreateInfo rasterizer{};
+	rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizer.depthClampEnable = VK_FALSE;
+	rasterizer.rasterizerDiscardEnable = VK_FALSE;
+	rasterizer.polygonMode = desc.polygonMode;
+	rasterizer.lineWidth = 1.0f;
+	rasterizer.cullMode = desc.cullMode;
+	rasterizer.frontFace = desc.frontFace;
+	rasterizer.depthBiasEnable = VK_FALSE;
+
+	VkPipelineMultisampleStateCreateInfo multisampling{};
+	multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampling.sampleShadingEnable = VK_FALSE;
+	multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+	multisampling.minSampleShading = 1.f;
+
+	VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+	colorBlendAttachment.colorWriteMask = desc.colorWriteMask;
+	colorBlendAttachment.blendEnable = desc.blendEnable ? VK_TRUE : VK_FALSE;
+	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+	colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo colorBlending{};
+	colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	colorBlending.logicOpEnable = VK_FALSE;
+	colorBlending.logicOp = VK_LOGIC_OP_COPY;
+	colorBlending.attachmentCount = 1;
+	colorBlending.pAttachments = &colorBlendAttachment;
+
+	VkPipelineDepthStencilStateCreateInfo depthStencil{};
+	depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+	depthStencil.depthTestEnable = desc.depthTestEnable ? VK_TRUE : VK_FALSE;
+	depthStencil.depthWriteEnable = desc.depthWriteEnable ? VK_TRUE : VK_FALSE;
+	depthStencil.depthCompareOp = desc.depthCompareOp;
+	depthStencil.depthBoundsTestEnable = VK_FALSE;
+	depthStencil.minDepthBounds = 0.0f;
+	depthStencil.maxDepthBounds = 1.0f;
+	depthStencil.stencilTestEnable = VK_FALSE;
+
+	// Without a render pass the pipeline is created against the attachment formats of vkCmdBeginRendering
+	VkPipelineRenderingCreateInfo renderingInfo{};
+	renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+	renderingInfo.colorAttachmentCount = desc.colorFormat != VK_FORMAT_UNDEFINED ? 1 : 0;
+	renderingInfo.pColorAttachmentFormats = &desc.colorFormat;
+	renderingInfo.depthAttachmentFormat = desc.depthFormat;
+
+	VkGraphicsPipelineCreateInfo pipelineInfo{};
+	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	pipelineInfo.pNext = desc.renderPass == VK_NULL_HANDLE ? &renderingInfo : nullptr;
+	pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+	pipelineInfo.pStages = shaderStages.data();
+	pipelineInfo.pVertexInputState = &vertexInputInfo;
+	pipelineInfo.pInputAssemblyState = &inputAssembly;
+	pipelineInfo.pViewportState = &viewportState;
+	pipelineInfo.pRasterizationState = &rasterizer;
+	pipelineInfo.pMultisampleState = &multisampling;
+	pipelineInfo.pColorBlendState = &colorBlending;
+	pipelineInfo.pDepthStencilState = &depthStencil;
+	pipelineInfo.pDynamicState = &dynamicState;
+	pipelineInfo.layout = pipelineLayout;
+	pipelineInfo.renderPass = desc.renderPass;
+	pipelineInfo.subpass = desc.subpass;
+	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+	pipelineInfo.basePipelineIndex = -1;
+
+	VkPipeline pipeline{ VK_NULL_HANDLE };
+	if (vkCreateGraphicsPipelines(device, m_VkPipelineCache, 1, &pipelineInfo, VK_NULL_HANDLE, &pipeline) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create graphics pipeline!" };
+	}
+	return pipeline;
+}
+
+size_t PipelineStateCache::HashBindings(const std::vector<DescriptorBindingDesc>& bindings)
+{
+	size_t seed{};
+	for (const DescriptorBindingDesc& binding : bindings)
+	{
+		const size_t bindingHash{ std::hash<uint64_t>{}((uint64_t{ binding.binding } << 32) | (uint64_t{ static_cast<uint32_t>(binding.type) } << 16) | binding.stages) };
+		seed ^= bindingHash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	}
+	return seed;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef PIPELINESTATECACHE_H
+#define PIPELINESTATECACHE_H
+
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "PipelineBuilder.h"
+
+class ShaderCache;
+
+// Central owner of pipelines, pipeline layouts and descriptor set layouts.
+// Identical descriptions resolve to the same Vulkan object, so new variants only cost a lookup once built.
+class PipelineStateCache final
+{
+public:
+
+	PipelineStateCache();
+	~PipelineStateCache() = default;
+
+	PipelineStateCache(const PipelineStateCache& other) = delete;
+	PipelineStateCache(PipelineStateCache&& other) noexcept = delete;
+	PipelineStateCache& operator=(const PipelineStateCache& other) = delete;
+	PipelineStateCache& operator=(PipelineStateCache&& other) noexcept = delete;
+
+	void Initialize(VkPhysicalDevice phyDevice, VkPipelineCache pipelineCache, ShaderCache& shaderCache);
+	void Destroy(VkDevice device);
+
+	VkDescriptorSetLayout GetDescriptorSetLayout(VkDevice device, const std::vector<DescriptorBindingDesc>& bindings);
+	VkPipelineLayout GetPipelineLayout(VkDevice device, const PipelineDesc& desc);
+	VkPipeline GetPipeline(VkDevice device, const PipelineDesc& desc);
+
+	uint32_t GetPipelineCount() const;
+
+private:
+
+	struct SetLayoutEntry
+	{
+		std::vector<DescriptorBindingDesc> bindings;
+		VkDescriptorSetLayout setLayout;
+	};
+
+	struct PipelineLayoutEntry
+	{
+		PipelineDesc desc;
+		VkPipelineLayout pipelineLayout;
+	};
+
+	struct PipelineEntry
+	{
+		PipelineDesc desc;
+		VkPipeline pipeline;
+	};
+
+	VkPipeline CreatePipeline(VkDevice device, const PipelineDesc& desc, VkPipelineLayout pipelineLayout) const;
+
+	static size_t HashBindings(const std::vector<DescriptorBindingDesc>& bindings);
+
+private:
+
+	VkPipelineCache m_VkPipelineCache;
+	ShaderCache* m_pShaderCache;
+	bool m_FillModeNonSolidSupported;
+
+	std::unordered_multimap<size_t, SetLayoutEntry> m_SetLayouts;
+	std::unordered_multimap<size_t, PipelineLayoutEntry> m_PipelineLayouts;
+	std::unordered_multimap<size_t, PipelineEntry> m_Pipelines;
+
+	mutable std::mutex m_CacheMutex;
+
+};
+
+#endif // !PIPELINESTATECACHE_H
\ No newline at end of file
@@ -0,0 +1,331 @@
+#include <stdexcept>
+
+#include "Queue.h"
+
+Queue::Queue()
+	: m_VkQueue{ VK_NULL_HANDLE }
+	, m_FamilyIndex{}
+	, m_QueueIndex{}
+	, m_TimelineSemaphore{ VK_NULL_HANDLE }
+	, m_LastSubmittedValue{}
+	, m_ImmediateCommandPool{ VK_NULL_HANDLE }
+	, m_ImmediateSubmissions{}
+	, m_WaitSemaphores{}
+	, m_WaitValues{}
+	, m_WaitStages{}
+	, m_SignalSemaphores{}
+	, m_SignalValues{}
+	, m_QueueMutex{}
+{
+}
+
+void Queue::Initialize(VkDevice device, uint32_t familyIndex, uint32_t queueIndex)
+{
+	m_FamilyIndex = familyIndex;
+	m_QueueIndex = queueIndex;
+	vkGetDeviceQueue(device, familyIndex, queueIndex, &m_VkQueue);
+
+	VkSemaphoreTypeCreateInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+	timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+	timelineInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreInfo{};
+	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+	semaphoreInfo.pNext = &timelineInfo;
+
+	if (vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &m_TimelineSemaphore) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create queue timeline semaphore!" };
+	}
+	m_LastSubmittedValue = 0;
+
+	VkCommandPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolInfo.queueFamilyIndex = familyIndex;
+
+	if (vkCreateCommandPool(device, &poolInfo, VK_NULL_HANDLE, &m_ImmediateCommandPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create queue command pool!" };
+	}
+}
+
+void Queue::Destroy(VkDevice device)
+{
+	WaitIdle();
+
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+
+	CollectCompleted(device);
+
+	if (m_ImmediateCommandPool != VK_NULL_HANDLE)
+	{
+		vkDestroyCommandPool(device, m_ImmediateCommandPool, VK_NULL_HANDLE);
+		m_ImmediateCommandPool = VK_NULL_HANDLE;
+	}
+
+	if (m_TimelineSemaphore != VK_NULL_HANDLE)
+	{
+		vkDestroySemaphore(device, m_TimelineSemaphore, VK_NULL_HANDLE);
+		m_TimelineSemaphore = VK_NULL_HANDLE;
+	}
+	m_VkQueue = VK_NULL_HANDLE;
+}
+
+QueueSubmission Queue::Submit(VkDevice device, std::span<const VkCommandBuffer> commandBuffers, std::span<const QueueWait> waits, std::span<const VkSemaphore> binarySignals)
+{
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+
+	CollectCompleted(device);
+	return SubmitLocked(commandBuffers, waits, binarySignals);
+}
+
+QueueSubmission Queue::SubmitImmediate(VkDevice device, const std::function<void(VkCommandBuffer)>& recordCommands, const std::vector<QueueWait>& waits)
+{
+	// The command pool is externally synchronized, so recording happens under the queue lock as well
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+
+	CollectCompleted(device);
+
+	VkCommandBufferAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocInfo.commandPool = m_ImmediateCommandPool;
+	allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocInfo.commandBufferCount = 1;
+
+	VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+	if (vkAllocateCommandBuffers(device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to allocate queue command buffer!" };
+	}
+
+	VkCommandBufferBeginInfo beginInfo{};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to begin recording queue command buffer!" };
+	}
+
+	recordCommands(commandBuffer);
+
+	if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to record queue command buffer!" };
+	}
+
+	const QueueSubmission submission{ SubmitLocked({ &commandBuffer, 1 }, waits, {}) };
+	m_ImmediateSubmissions.emplace_back(ImmediateSubmission{ submission.timelineValue, commandBuffer });
+	return submission;
+}
+
+VkResult Queue::Present(const VkPresentInfoKHR& presentInfo)
+{
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+	return vkQueuePresentKHR(m_VkQueue, &presentInfo);
+}
+
+void Queue::Wait(VkDevice device, const QueueSubmission& submission) const
+{
+	VkSemaphoreWaitInfo waitInfo{};
+	waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &m_TimelineSemaphore;
+	waitInfo.pValues = &submission.timelineValue;
+
+	if (vkWaitSemaphores(device, &waitInfo, UINT64_MAX) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to wait for queue submission!" };
+	}
+}
+
+bool Queue::IsComplete(VkDevice device, const QueueSubmission& submission) const
+{
+	return GetCompletedValue(device) >= submission.timelineValue;
+}
+
+uint64_t Queue::GetCompletedValue(VkDevice device) const
+{
+	uint64_t completedValue{};
+	vkGetSemaphoreCounterValue(device, m_TimelineSemaphore, &completedValue);
+	return completedValue;
+}
+
+QueueSubmission Queue::GetLastSubmission() const
+{
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+	return QueueSubmission{ m_LastSubmittedValue };
+}
+
+void Queue::WaitIdle()
+{
+	std::lock_guard<std::mutex> lock{ m_QueueMutex };
+	if (m_VkQueue != VK_NULL_HANDLE) vkQueueWaitIdle(m_VkQueue);
+}
+
+QueueWait Queue::GetWait(const QueueSubmission& submission, VkPipelineStageFlags stage) const
+{
+	return QueueWait{ m_TimelineSemaphore, submission.timelineValue, stage };
+}
+
+const VkQueue& Queue::GetVkQueue() const
+{
+	return m_VkQueue;
+}
+
+const VkSemaphore& Queue::GetTimelineSemaphore() const
+{
+	return m_TimelineSemaphore;
+}
+
+uint32_t Queue::GetFamilyIndex() const
+{
+	return m_FamilyIndex;
+}
+
+uint32_t Queue::GetQueueIndex() const
+{
+	return m_QueueIndex;
+}
+
+void Queue::ReleaseBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess)
+{
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = 0; // Ignored for a release
+	barrier.srcQueueFamilyIndex = srcFamily;
+	barrier.dstQueueFamilyIndex = dstFamily;
+	barrier.buffer = buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_NULL_HANDLE, 1, &barrier, 0, VK_NULL_HANDLE);
+}
+
+void Queue::AcquireBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	VkBufferMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0; // Ignored for an acquire
+	barrier.dstAccessMask = dstAccess;
+	barrier.srcQueueFamilyIndex = srcFamily;
+	barrier.dstQueueFamilyIndex = dstFamily;
+	barrier.buffer = buffer;
+	barrier.offset = 0;
+	barrier.size = VK_WHOLE_SIZE;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage, 0, 0, VK_NULL_HANDLE, 1, &barrier, 0, VK_NULL_HANDLE);
+}
+
+void Queue::ReleaseImageOwnership(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+	uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess)
+{
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = srcAccess;
+	barrier.dstAccessMask = 0; // Ignored for a release
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = srcFamily;
+	barrier.dstQueueFamilyIndex = dstFamily;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = aspect;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+	vkCmdPipelineBarrier(commandBuffer, srcStage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &barrier);
+}
+
+void Queue::AcquireImageOwnership(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+	uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess)
+{
+	// The layout transition has to match the one of the release barrier
+	VkImageMemoryBarrier barrier{};
+	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask = 0; // Ignored for an acquire
+	barrier.dstAccessMask = dstAccess;
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = srcFamily;
+	barrier.dstQueueFamilyIndex = dstFamily;
+	barrier.image = image;
+	barrier.subresourceRange.aspectMask = aspect;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage, 0, 0, VK_NULL_HANDLE, 0, VK_NULL_HANDLE, 1, &barrier);
+}
+
+QueueSubmission Queue::SubmitLocked(std::span<const VkCommandBuffer> commandBuffers, std::span<const QueueWait> waits, std::span<const VkSemaphore> binarySignals)
+{
+	std::vector<VkSemaphore>& waitSemaphores{ m_WaitSemaphores };
+	std::vector<uint64_t>& waitValues{ m_WaitValues };
+	std::vector<VkPipelineStageFlags>& waitStages{ m_WaitStages };
+	waitSemaphores.clear();
+	waitValues.clear();
+	waitStages.clear();
+	for (const QueueWait& wait : waits)
+	{
+		waitSemaphores.emplace_back(wait.semaphore);
+		waitValues.emplace_back(wait.value);
+		waitStages.emplace_back(wait.stage);
+	}
+
+	const QueueSubmission submission{ m_LastSubmittedValue + 1 };
+
+	// The timeline semaphore is signaled first, the values of the binary semaphores after it are ignored
+	std::vector<VkSemaphore>& signalSemaphores{ m_SignalSemaphores };
+	signalSemaphores.assign(1, m_TimelineSemaphore);
+	signalSemaphores.insert(signalSemaphores.end(), binarySignals.begin(), binarySignals.end());
+	std::vector<uint64_t>& signalValues{ m_SignalValues };
+	signalValues.assign(signalSemaphores.size(), 0);
+	signalValues[0] = submission.timelineValue;
+
+	VkTimelineSemaphoreSubmitInfo timelineInfo{};
+	timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+	timelineInfo.waitSemaphoreValueCount = static_cast<uint32_t>(waitValues.size());
+	timelineInfo.pWaitSemaphoreValues = waitValues.data();
+	timelineInfo.signalSemaphoreValueCount = static_cast<uint32_t>(signalValues.size());
+	timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+	VkSubmitInfo submitInfo{};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.pNext = &timelineInfo;
+	submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+	submitInfo.pWaitSemaphores = waitSemaphores.data();
+	submitInfo.pWaitDstStageMask = waitStages.data();
+	submitInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+	submitInfo.pCommandBuffers = commandBuffers.data();
+	submitInfo.signalSemaphoreCount = static_cast<uint32_t>(signalSemaphores.size());
+	submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+	if (vkQueueSubmit(m_VkQueue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to submit to queue!" };
+	}
+
+	m_LastSubmittedValue = submission.timelineValue;
+	return submission;
+}
+
+void Queue::CollectCompleted(VkDevice device)
+{
+	if (m_ImmediateSubmissions.empty()) return;
+
+	const uint64_t completedValue{ GetCompletedValue(device) };
+
+	// Submissions are stored in timeline order
+	auto submissionIt{ m_ImmediateSubmissions.begin() };
+	for (; submissionIt != m_ImmediateSubmissions.end() && submissionIt->timelineValue <= completedValue; ++submissionIt)
+	{
+		vkFreeCommandBuffers(device, m_ImmediateCommandPool, 1, &submissionIt->commandBuffer);
+	}
+	m_ImmediateSubmissions.erase(m_ImmediateSubmissions.begin(), submissionIt);
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <vector>
+#include <span>
+#include <mutex>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+enum class QueueType
+{
+	Graphics,
+	Present,
+	Transfer,
+	Compute
+};
+
+struct QueueSubmission
+{
+	uint64_t timelineValue{};
+};
+
+struct QueueWait
+{
+	VkSemaphore semaphore{ VK_NULL_HANDLE };
+	uint64_t value{}; // Ignored for binary semaphores
+	VkPipelineStageFlags stage{ VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+};
+
+// Thread safe wrapper around a VkQueue. Every submission signals the next value of the queue's timeline semaphore,
+// which the cpu and other queues wait on instead of per submission fences.
+class Queue final
+{
+public:
+
+	Queue();
+	~Queue() = default;
+
+	Queue(const Queue& other) = delete;
+	Queue(Queue&& other) noexcept = delete;
+	Queue& operator=(const Queue& other) = delete;
+	Queue& operator=(Queue&& other) noexcept = delete;
+
+	void Initialize(VkDevice device, uint32_t familyIndex, uint32_t queueIndex);
+	void Destroy(VkDevice device);
+
+	// Binary signal semaphores are only needed for presentation
+	QueueSubmission Submit(VkDevice device, std::span<const VkCommandBuffer> commandBuffers, std::span<const QueueWait> waits = {}, std::span<const VkSemaphore> binarySignals = {});
+
+	// Records a one time command buffer from the queue's own command pool and submits it
+	QueueSubmission SubmitImmediate(VkDevice device, const std::function<void(VkCommandBuffer)>& recordCommands, const std::vector<QueueWait>& waits = {});
+
+	VkResult Present(const VkPresentInfoKHR& presentInfo);
+
+	void Wait(VkDevice device, const QueueSubmission& submission) const;
+	bool IsComplete(VkDevice device, const QueueSubmission& submission) const;
+	uint64_t GetCompletedValue(VkDevice device) const;
+	QueueSubmission GetLastSubmission() const;
+	void WaitIdle();
+
+	// Lets a submission on another queue wait on this one on the gpu
+	QueueWait GetWait(const QueueSubmission& submission, VkPipelineStageFlags stage) const;
+
+	const VkQueue& GetVkQueue() const;
+	const VkSemaphore& GetTimelineSemaphore() const;
+	uint32_t GetFamilyIndex() const;
+	uint32_t GetQueueIndex() const;
+
+	// Queue family ownership transfer, the release is recorded on the source queue and the matching acquire on the destination queue
+	static void ReleaseBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess);
+	static void AcquireBufferOwnership(VkCommandBuffer commandBuffer, VkBuffer buffer, uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+	static void ReleaseImageOwnership(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+		uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags srcStage, VkAccessFlags srcAccess);
+	static void AcquireImageOwnership(VkCommandBuffer commandBuffer, VkImage image, VkImageAspectFlags aspect, VkImageLayout oldLayout, VkImageLayout newLayout,
+		uint32_t srcFamily, uint32_t dstFamily, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess);
+
+private:
+
+	struct ImmediateSubmission
+	{
+		uint64_t timelineValue{};
+		VkCommandBuffer commandBuffer{ VK_NULL_HANDLE };
+	};
+
+	QueueSubmission SubmitLocked(std::span<const VkCommandBuffer> commandBuffers, std::span<const QueueWait> waits, std::span<const VkSemaphore> binarySignals);
+
+	// Frees the command buffers of every finished immediate submission
+	void CollectCompleted(VkDevice device);
+
+private:
+
+	VkQueue m_VkQueue;
+	uint32_t m_FamilyIndex;
+	uint32_t m_QueueIndex;
+
+	VkSemaphore m_TimelineSemaphore;
+	uint64_t m_LastSubmittedValue;
+
+	VkCommandPool m_ImmediateCommandPool;
+	std::vector<ImmediateSubmission> m_ImmediateSubmissions;
+
+	// Reused by every submission so submitting does not allocate once their capacity settled
+	std::vector<VkSemaphore> m_WaitSemaphores;
+	std::vector<uint64_t> m_WaitValues;
+	std::vector<VkPipelineStageFlags> m_WaitStages;
+	std::vector<VkSemaphore> m_SignalSemaphores;
+	std::vector<uint64_t> m_SignalValues;
+
+	mutable std::mutex m_QueueMutex;
+
+};
+
+#endif // !QUEUE_H
\ No newline at end of file
@@ -0,0 +1,628 @@
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+#include "RenderGraph.h"
+#include "DeviceFunctions.h"
+
+RenderGraphPass::RenderGraphPass(const std::string& name)
+	: m_Name{ name }
+	, m_Uses{}
+	, m_Execute{}
+	, m_HasSideEffects{ false }
+{
+}
+
+RenderGraphPass& RenderGraphPass::Read(RenderGraphResource resource, RenderGraphAccess access)
+{
+	m_Uses.emplace_back(ResourceUse{ resource, access, false });
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::Write(RenderGraphResource resource, RenderGraphAccess access)
+{
+	m_Uses.emplace_back(ResourceUse{ resource, access, true });
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::SetSideEffects()
+{
+	m_HasSideEffects = true;
+	return *this;
+}
+
+RenderGraphPass& RenderGraphPass::SetExecute(const ExecuteFunction& execute)
+{
+	m_Execute = execute;
+	return *this;
+}
+
+RenderGraph::RenderGraph()
+	: m_Resources{}
+	, m_Passes{}
+	, m_CompiledPasses{}
+	, m_FinalBarriers{}
+	, m_MemoryBlocks{}
+	, m_ImageBarriers{}
+	, m_BufferBarriers{}
+	, m_IsCompiled{ false }
+{
+}
+
+void RenderGraph::Destroy(VkDevice device)
+{
+	for (Resource& resource : m_Resources)
+	{
+		if (resource.type != ResourceType::TransientImage) continue;
+
+		if (resource.imageView != VK_NULL_HANDLE) vkDestroyImageView(device, resource.imageView, VK_NULL_HANDLE);
+		if (resource.image != VK_NULL_HANDLE) vkDestroyImage(device, resource.image, VK_NULL_HANDLE);
+	}
+
+	for (MemoryBlock& memoryBlock : m_MemoryBlocks)
+	{
+		if (memoryBlock.memory != VK_NULL_HANDLE) vkFreeMemory(device, memoryBlock.memory, VK_NULL_HANDLE);
+	}
+
+	m_Resources.clear();
+	m_Passes.clear();
+	m_CompiledPasses.clear();
+	m_FinalBarriers.clear();
+	m_MemoryBlocks.clear();
+	m_ImageBarriers.clear();
+	m_BufferBarriers.clear();
+	m_IsCompiled = false;
+}
+
+RenderGraphResource RenderGraph::ImportImage(const std::string& name, VkImageAspectFlags aspect, VkImageLayout initialLayout, VkImageLayout finalLayout)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.type = ResourceType::ImportedImage;
+	resource.aspect = aspect;
+	resource.initialLayout = initialLayout;
+	resource.finalLayout = finalLayout;
+
+	m_Resources.emplace_back(resource);
+	return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(const std::string& name)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.type = ResourceType::ImportedBuffer;
+
+	m_Resources.emplace_back(resource);
+	return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::CreateTransientImage(const std::string& name, const TransientImageDesc& desc)
+{
+	Resource resource{};
+	resource.name = name;
+	resource.type = ResourceType::TransientImage;
+	resource.aspect = desc.aspect;
+	resource.transientDesc = desc;
+
+	m_Resources.emplace_back(resource);
+	return static_cast<RenderGraphResource>(m_Resources.size() - 1);
+}
+
+void RenderGraph::SetImportedImage(RenderGraphResource resource, VkImage image, VkImageView imageView)
+{
+	if (m_Resources[resource].type != ResourceType::ImportedImage) throw std::invalid_argument{ "RenderGraph resource is not an imported image: " + m_Resources[resource].name };
+
+	m_Resources[resource].image = image;
+	m_Resources[resource].imageView = imageView;
+}
+
+void RenderGraph::SetImportedBuffer(RenderGraphResource resource, VkBuffer buffer)
+{
+	if (m_Resources[resource].type != ResourceType::ImportedBuffer) throw std::invalid_argument{ "RenderGraph resource is not an imported buffer: " + m_Resources[resource].name };
+
+	m_Resources[resource].buffer = buffer;
+}
+
+RenderGraphPass& RenderGraph::AddPass(const std::string& name)
+{
+	if (m_IsCompiled) throw std::runtime_error{ "RenderGraph is already compiled, passes can not be added anymore!" };
+
+	m_Passes.emplace_back(RenderGraphPass{ name });
+	return m_Passes.back();
+}
+
+void RenderGraph::Compile(VkDevice device, VkPhysicalDevice phyDevice)
+{
+	if (m_IsCompiled) throw std::runtime_error{ "RenderGraph is already compiled!" };
+
+	std::vector<bool> passAlive(m_Passes.size(), false);
+	CullPasses(passAlive);
+
+	m_CompiledPasses.clear();
+	for (uint32_t passIdx{}; passIdx < m_Passes.size(); ++passIdx)
+	{
+		if (!passAlive[passIdx]) continue;
+
+		const uint32_t compiledIdx{ static_cast<uint32_t>(m_CompiledPasses.size()) };
+		m_CompiledPasses.emplace_back(CompiledPass{ passIdx, {} });
+
+		// Lifetimes are measured in executed passes
+		for (const RenderGraphPass::ResourceUse& use : m_Passes[passIdx].m_Uses)
+		{
+			Resource& resource{ m_Resources[use.resource] };
+			resource.firstPass = std::min(resource.firstPass, compiledIdx);
+			resource.lastPass = std::max(resource.lastPass, compiledIdx);
+		}
+	}
+
+	AllocateTransientImages(device, phyDevice);
+	BuildBarriers();
+
+	m_IsCompiled = true;
+}
+
+void RenderGraph::Execute(VkCommandBuffer commandBuffer) const
+{
+	if (!m_IsCompiled) throw std::runtime_error{ "RenderGraph has to be compiled before it is executed!" };
+
+	for (const CompiledPass& compiledPass : m_CompiledPasses)
+	{
+		RecordBarriers(commandBuffer, compiledPass.barriers);
+
+		const RenderGraphPass& pass{ m_Passes[compiledPass.passIdx] };
+		if (pass.m_Execute) pass.m_Execute(commandBuffer);
+	}
+
+	RecordBarriers(commandBuffer, m_FinalBarriers);
+}
+
+const VkImage& RenderGraph::GetImage(RenderGraphResource resource) const
+{
+	return m_Resources[resource].image;
+}
+
+const VkImageView& RenderGraph::GetImageView(RenderGraphResource resource) const
+{
+	return m_Resources[resource].imageView;
+}
+
+const VkBuffer& RenderGraph::GetBuffer(RenderGraphResource resource) const
+{
+	return m_Resources[resource].buffer;
+}
+
+uint32_t RenderGraph::GetCulledPassCount() const
+{
+	return static_cast<uint32_t>(m_Passes.size() - m_CompiledPasses.size());
+}
+
+uint32_t RenderGraph::GetTransientMemoryBlockCount() const
+{
+	return static_cast<uint32_t>(m_MemoryBlocks.size());
+}
+
+void RenderGraph::CullPasses(std::vector<bool>& passAlive) const
+{
+	// Imported resources are the outputs of the graph, transient ones only matter when a live pass reads them
+	std::vector<bool> isNeeded(m_Resources.size(), false);
+	for (size_t resourceIdx{}; resourceIdx < m_Resources.size(); ++resourceIdx)
+	{
+		isNeeded[resourceIdx] = m_Resources[resourceIdx].type != ResourceType::TransientImage;
+	}
+
+	for (size_t passIdx{ m_Passes.size() }; passIdx-- > 0;)
+	{
+		const RenderGraphPass& pass{ m_Passes[passIdx] };
+
+		bool isAlive{ pass.m_HasSideEffects };
+		for (const RenderGraphPass::ResourceUse& use : pass.m_Uses)
+		{
+			if (use.isWrite && isNeeded[use.resource]) isAlive = true;
+		}
+		if (!isAlive) continue;
+
+		passAlive[passIdx] = true;
+		for (const RenderGraphPass::ResourceUse& use : pass.m_Uses)
+		{
+			if (!use.isWrite) isNeeded[use.resource] = true;
+		}
+	}
+}
+
+void RenderGraph::AllocateTransientImages(VkDevice device, VkPhysicalDevice phyDevice)
+{
+	std::vector<RenderGraphResource> transients{};
+	for (RenderGraphResource resourceIdx{}; resourceIdx < m_Resources.size(); ++resourceIdx)
+	{
+		const Resource& resource{ m_Resources[resourceIdx] };
+		if (resource.type == ResourceType::TransientImage && resource.firstPass != UINT32_MAX) transients.emplace_back(resourceIdx);
+	}
+
+	std::sort(transients.begin(), transients.end(), [this](RenderGraphResource lhs, RenderGraphResource rhs)
+		{
+			return m_Resources[lhs].firstPass < m_Resources[rhs].firstPass;
+		});
+
+	std::vector<VkMemoryRequirements> memRequirements(m_Resources.size());
+	for (const RenderGraphResource transient : transients)
+	{
+		Resource& resource{ m_Resources[transient] };
+		const TransientImageDesc& desc{ resource.transientDesc };
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent = { desc.extent.width, desc.extent.height, 1 };
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = desc.format;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = desc.usage;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateImage(device, &imageInfo, VK_NULL_HANDLE, &resource.image) != VK_SUCCESS)
+		{
+			throw std::runtime_error{ "failed to create render graph image: " + resource.name };
+		}
+		vkGetImageMemoryRequirements(device, resource.image, &memRequirements[transient]);
+
+		// Images are sorted on their first use, so a block is free once its last occupant finished before this image starts
+		const VkMemoryRequirements& requirements{ memRequirements[transient] };
+		const auto blockIt
+		{
+			std::find_if(m_MemoryBlocks.begin(), m_MemoryBlocks.end(), [&](const MemoryBlock& memoryBlock)
+				{
+					return (memoryBlock.memoryTypeBits & requirements.memoryTypeBits) != 0 && memoryBlock.lastPass < resource.firstPass;
+				})
+		};
+
+		const size_t blockIdx{ static_cast<size_t>(blockIt - m_MemoryBlocks.begin()) };
+		if (blockIt == m_MemoryBlocks.end()) m_MemoryBlocks.emplace_back(MemoryBlock{});
+		MemoryBlock& memoryBlock{ m_MemoryBlocks[blockIdx] };
+
+		memoryBlock.size = std::max(memoryBlock.size, requirements.size);
+		memoryBlock.alignment = std::max(memoryBlock.alignment, requirements.alignment);
+		memoryBlock.memoryTypeBits &= requirements.memoryTypeBits;
+		resource.aliasedPredecessor = memoryBlock.lastOccupant;
+		memoryBlock.lastPass = resource.lastPass;
+		memoryBlock.lastOccupant = transient;
+		resource.memoryBlock = static_cast<uint32_t>(blockIdx);
+	}
+
+	for (MemoryBlock& memoryBlock : m_MemoryBlocks)
+	{
+		VkMemoryAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = (memoryBlock.size + memoryBlock.alignment - 1) / memoryBlock.alignment * memoryBlock.alignment;
+		allocInfo.memoryTypeIndex = FindMemoryType(phyDevice, memoryBlock.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+		if (vkAllocateMemory(device, &allocInfo, VK_NULL_HANDLE, &memoryBlock.memory) != VK_SUCCESS)
+		{
+			throw std::runtime_error{ "failed to allocate render graph memory!" };
+		}
+	}
+
+	for (const RenderGraphResource transient : transients)
+	{
+		Resource& resource{ m_Resources[transient] };
+		vkBindImageMemory(device, resource.image, m_MemoryBlocks[resource.memoryBlock].memory, 0);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = resource.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = resource.transientDesc.format;
+		viewInfo.subresourceRange.aspectMask = resource.aspect;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+
+		if (vkCreateImageView(device, &viewInfo, VK_NULL_HANDLE, &resource.imageView) != VK_SUCCESS)
+		{
+			throw std::runtime_error{ "failed to create render graph image view: " + resource.name };
+		}
+	}
+}
+
+void RenderGraph::BuildBarriers()
+{
+	std::vector<AccessState> states(m_Resources.size());
+	std::vector<bool> isTouched(m_Resources.size(), false);
+
+	// First barriers of transient images that start a memory block, completed once the final states are known
+	std::vector<std::pair<size_t, size_t>> blockStartBarriers{};
+
+	for (size_t compiledIdx{}; compiledIdx < m_CompiledPasses.size(); ++compiledIdx)
+	{
+		CompiledPass& compiledPass{ m_CompiledPasses[compiledIdx] };
+
+		// Every resource gets a single state per pass, so a read and write of the same resource become one barrier
+		std::vector<RenderGraphResource> passResources{};
+		std::vector<AccessState> passStates{};
+		for (const RenderGraphPass::ResourceUse& use : m_Passes[compiledPass.passIdx].m_Uses)
+		{
+			const AccessState useState{ GetAccessState(use.access, use.isWrite) };
+
+			const auto resourceIt{ std::find(passResources.begin(), passResources.end(), use.resource) };
+			if (resourceIt == passResources.end())
+			{
+				passResources.emplace_back(use.resource);
+				passStates.emplace_back(useState);
+				continue;
+			}
+
+			AccessState& passState{ passStates[resourceIt - passResources.begin()] };
+			passState.stage |= useState.stage;
+			passState.access |= useState.access;
+			if (useState.isWrite) passState.layout = useState.layout;
+			passState.isWrite |= useState.isWrite;
+		}
+
+		for (size_t useIdx{}; useIdx < passResources.size(); ++useIdx)
+		{
+			const RenderGraphResource resourceIdx{ passResources[useIdx] };
+			const Resource& resource{ m_Resources[resourceIdx] };
+			const AccessState& next{ passStates[useIdx] };
+			AccessState& current{ states[resourceIdx] };
+
+			if (!isTouched[resourceIdx])
+			{
+				isTouched[resourceIdx] = true;
+
+				if (!IsImage(resource))
+				{
+					// Buffers are not shared between frames in flight, the queue timeline orders them across frames
+					current = next;
+					continue;
+				}
+
+				current = AccessState{};
+				if (resource.type == ResourceType::ImportedImage)
+				{
+					// Starting from the first use chains the barrier to a semaphore wait on that stage (swapchain acquire)
+					// and orders it after the same use in the previous frame
+					current.stage = next.stage;
+					current.access = next.access;
+					current.isWrite = next.isWrite;
+					current.layout = resource.initialLayout;
+				}
+				else if (resource.aliasedPredecessor != UINT32_MAX)
+				{
+					// The previous image in this memory has to be done before its memory is overwritten
+					current.stage = states[resource.aliasedPredecessor].stage;
+					current.access = states[resource.aliasedPredecessor].access;
+					current.isWrite = true;
+				}
+				else
+				{
+					blockStartBarriers.emplace_back(compiledIdx, compiledPass.barriers.size());
+				}
+
+				compiledPass.barriers.emplace_back(Barrier{ resourceIdx, current, next });
+				current = next;
+				continue;
+			}
+
+			const bool isLayoutChange{ IsImage(resource) && current.layout != next.layout };
+			if (!isLayoutChange && !current.isWrite && !next.isWrite)
+			{
+				// Reads after reads only need to be known by a later write
+				current.stage |= next.stage;
+				current.access |= next.access;
+				continue;
+			}
+
+			compiledPass.barriers.emplace_back(Barrier{ resourceIdx, current, next });
+			current = next;
+		}
+	}
+
+	// The transient images share their memory with the previous frame, which may still run on the gpu.
+	// The first image of a block waits on the block's last occupant, it was the last to use the memory in the previous frame.
+	for (const auto& [compiledIdx, barrierIdx] : blockStartBarriers)
+	{
+		Barrier& barrier{ m_CompiledPasses[compiledIdx].barriers[barrierIdx] };
+		const AccessState& lastOccupantState{ states[m_MemoryBlocks[m_Resources[barrier.resource].memoryBlock].lastOccupant] };
+
+		barrier.src.stage = lastOccupantState.stage;
+		barrier.src.access = lastOccupantState.access;
+		barrier.src.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.src.isWrite = true;
+	}
+
+#ifndef NDEBUG
+	ValidateTransientFirstUses();
+#endif
+
+	m_FinalBarriers.clear();
+	for (RenderGraphResource resourceIdx{}; resourceIdx < m_Resources.size(); ++resourceIdx)
+	{
+		const Resource& resource{ m_Resources[resourceIdx] };
+		if (resource.type != ResourceType::ImportedImage || !isTouched[resourceIdx]) continue;
+		if (resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED || resource.finalLayout == states[resourceIdx].layout) continue;
+
+		AccessState finalState{};
+		finalState.layout = resource.finalLayout;
+		m_FinalBarriers.emplace_back(Barrier{ resourceIdx, states[resourceIdx], finalState });
+	}
+
+	size_t maxBarrierCount{ m_FinalBarriers.size() };
+	for (const CompiledPass& compiledPass : m_CompiledPasses) maxBarrierCount = std::max(maxBarrierCount, compiledPass.barriers.size());
+	m_ImageBarriers.reserve(maxBarrierCount);
+	m_BufferBarriers.reserve(maxBarrierCount);
+}
+
+#ifndef NDEBUG
+void RenderGraph::ValidateTransientFirstUses() const
+{
+	// Without a source stage the first use of a transient image would not wait for the previous user of its memory
+	std::vector<bool> isChecked(m_Resources.size(), false);
+	for (const CompiledPass& compiledPass : m_CompiledPasses)
+	{
+		for (const Barrier& barrier : compiledPass.barriers)
+		{
+			if (m_Resources[barrier.resource].type != ResourceType::TransientImage || isChecked[barrier.resource]) continue;
+			isChecked[barrier.resource] = true;
+
+			if (barrier.src.stage == VK_PIPELINE_STAGE_2_NONE || barrier.src.layout != VK_IMAGE_LAYOUT_UNDEFINED)
+			{
+				throw std::runtime_error{ "render graph: first use of " + m_Resources[barrier.resource].name + " is not ordered after the previous user of its memory!" };
+			}
+		}
+	}
+}
+#endif
+
+void RenderGraph::RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers) const
+{
+	if (barriers.empty()) return;
+
+	m_ImageBarriers.clear();
+	m_BufferBarriers.clear();
+
+	for (const Barrier& barrier : barriers)
+	{
+		const Resource& resource{ m_Resources[barrier.resource] };
+
+		// Only writes have to be made available, earlier reads just need an execution dependency
+		const VkAccessFlags2 srcAccess{ barrier.src.isWrite ? barrier.src.access : VK_ACCESS_2_NONE };
+
+		if (IsImage(resource))
+		{
+			VkImageMemoryBarrier2 imageBarrier{};
+			imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+			imageBarrier.srcStageMask = barrier.src.stage;
+			imageBarrier.srcAccessMask = srcAccess;
+			imageBarrier.dstStageMask = barrier.dst.stage;
+			imageBarrier.dstAccessMask = barrier.dst.access;
+			imageBarrier.oldLayout = barrier.src.layout;
+			imageBarrier.newLayout = barrier.dst.layout;
+			imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			imageBarrier.image = resource.image;
+			imageBarrier.subresourceRange.aspectMask = resource.aspect;
+			imageBarrier.subresourceRange.baseMipLevel = 0;
+			imageBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+			imageBarrier.subresourceRange.baseArrayLayer = 0;
+			imageBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+			m_ImageBarriers.emplace_back(imageBarrier);
+		}
+		else
+		{
+			VkBufferMemoryBarrier2 bufferBarrier{};
+			bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+			bufferBarrier.srcStageMask = barrier.src.stage;
+			bufferBarrier.srcAccessMask = srcAccess;
+			bufferBarrier.dstStageMask = barrier.dst.stage;
+			bufferBarrier.dstAccessMask = barrier.dst.access;
+			bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			bufferBarrier.buffer = resource.buffer;
+			bufferBarrier.offset = 0;
+			bufferBarrier.size = VK_WHOLE_SIZE;
+			m_BufferBarriers.emplace_back(bufferBarrier);
+		}
+	}
+
+	VkDependencyInfo dependencyInfo{};
+	dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+	dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(m_ImageBarriers.size());
+	dependencyInfo.pImageMemoryBarriers = m_ImageBarriers.data();
+	dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(m_BufferBarriers.size());
+	dependencyInfo.pBufferMemoryBarriers = m_BufferBarriers.data();
+
+	DeviceFunctions::Get().CmdPipelineBarrier2(commandBuffer, dependencyInfo);
+}
+
+RenderGraph::AccessState RenderGraph::GetAccessState(RenderGraphAccess access, bool isWrite)
+{
+	AccessState state{};
+	state.isWrite = isWrite;
+
+	switch (access)
+	{
+	case RenderGraphAccess::ColorAttachmentWrite:
+		state.stage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+		state.access = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+		state.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		break;
+	case RenderGraphAccess::DepthAttachmentWrite:
+		state.stage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+		state.access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		state.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		break;
+	case RenderGraphAccess::DepthAttachmentRead:
+		state.stage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+		state.access = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		state.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+		break;
+	case RenderGraphAccess::ShaderSampledRead:
+		state.stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		state.access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+		state.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		break;
+	case RenderGraphAccess::StorageRead:
+		state.stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		state.access = VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+		state.layout = VK_IMAGE_LAYOUT_GENERAL;
+		break;
+	case RenderGraphAccess::StorageWrite:
+		state.stage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		state.access = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+		state.layout = VK_IMAGE_LAYOUT_GENERAL;
+		break;
+	case RenderGraphAccess::TransferRead:
+		state.stage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+		state.access = VK_ACCESS_2_TRANSFER_READ_BIT;
+		state.layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		break;
+	case RenderGraphAccess::TransferWrite:
+		state.stage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+		state.access = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+		state.layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		break;
+	case RenderGraphAccess::VertexBufferRead:
+		state.stage = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT;
+		state.access = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
+		break;
+	case RenderGraphAccess::IndexBufferRead:
+		state.stage = VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+		state.access = VK_ACCESS_2_INDEX_READ_BIT;
+		break;
+	case RenderGraphAccess::UniformRead:
+		state.stage = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+		state.access = VK_ACCESS_2_UNIFORM_READ_BIT;
+		break;
+	case RenderGraphAccess::IndirectRead:
+		state.stage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+		state.access = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+		break;
+	}
+
+	return state;
+}
+
+bool RenderGraph::IsImage(const Resource& resource)
+{
+	return resource.type != ResourceType::ImportedBuffer;
+}
+
+uint32_t RenderGraph::FindMemoryType(VkPhysicalDevice phyDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+	VkPhysicalDeviceMemoryProperties memProperties{};
+	vkGetPhysicalDeviceMemoryProperties(phyDevice, &memProperties);
+
+	for (uint32_t idx{}; idx < memProperties.memoryTypeCount; ++idx)
+	{
+		if ((typeFilter & (1 << idx)) && (memProperties.memoryTypes[idx].propertyFlags & properties) == properties)
+		{
+			return idx;
+		}
+	}
+
+	throw std::runtime_error{ "failed to find suitable memory type!" };
+}
\ No newline at end of file
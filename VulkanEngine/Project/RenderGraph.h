@@ -0,0 +1,200 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <vector>
+#include <string>
+#include <functional>
+
+#include <vulkan/vulkan.h>
+
+using RenderGraphResource = uint32_t;
+
+enum class RenderGraphAccess
+{
+	ColorAttachmentWrite,
+	DepthAttachmentWrite,
+	DepthAttachmentRead,
+	ShaderSampledRead,
+	StorageRead,
+	StorageWrite,
+	TransferRead,
+	TransferWrite,
+	VertexBufferRead,
+	IndexBufferRead,
+	UniformRead,
+	IndirectRead
+};
+
+struct TransientImageDesc
+{
+	VkFormat format{ VK_FORMAT_UNDEFINED };
+	VkExtent2D extent{};
+	VkImageUsageFlags usage{};
+	VkImageAspectFlags aspect{ VK_IMAGE_ASPECT_COLOR_BIT };
+};
+
+class RenderGraph;
+
+class RenderGraphPass final
+{
+public:
+
+	using ExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+	RenderGraphPass(const std::string& name);
+
+	// A pass that keeps the previous contents of a resource (load op LOAD, blending) has to declare a read as well
+	RenderGraphPass& Read(RenderGraphResource resource, RenderGraphAccess access);
+	RenderGraphPass& Write(RenderGraphResource resource, RenderGraphAccess access);
+
+	// Passes without side effects are culled when nothing reads their outputs
+	RenderGraphPass& SetSideEffects();
+	RenderGraphPass& SetExecute(const ExecuteFunction& execute);
+
+private:
+
+	friend class RenderGraph;
+
+	struct ResourceUse
+	{
+		RenderGraphResource resource{};
+		RenderGraphAccess access{};
+		bool isWrite{};
+	};
+
+	std::string m_Name;
+	std::vector<ResourceUse> m_Uses;
+	ExecuteFunction m_Execute;
+	bool m_HasSideEffects;
+
+};
+
+// Frame graph over the passes of a frame. Compile culls unused passes, aliases the memory of transient images
+// whose lifetimes do not overlap and precomputes the batched synchronization2 barriers between the passes.
+class RenderGraph final
+{
+public:
+
+	RenderGraph();
+	~RenderGraph() = default;
+
+	RenderGraph(const RenderGraph& other) = delete;
+	RenderGraph(RenderGraph&& other) noexcept = delete;
+	RenderGraph& operator=(const RenderGraph& other) = delete;
+	RenderGraph& operator=(RenderGraph&& other) noexcept = delete;
+
+	// Destroys the transient images and removes every pass and resource so the graph can be rebuilt
+	void Destroy(VkDevice device);
+
+	// The handles of imported resources can change every frame, their layouts at the start and the end of the graph can not.
+	// A final layout of VK_IMAGE_LAYOUT_UNDEFINED leaves the image in the layout of its last use.
+	RenderGraphResource ImportImage(const std::string& name, VkImageAspectFlags aspect, VkImageLayout initialLayout, VkImageLayout finalLayout);
+	RenderGraphResource ImportBuffer(const std::string& name);
+	RenderGraphResource CreateTransientImage(const std::string& name, const TransientImageDesc& desc);
+
+	void SetImportedImage(RenderGraphResource resource, VkImage image, VkImageView imageView);
+	void SetImportedBuffer(RenderGraphResource resource, VkBuffer buffer);
+
+	RenderGraphPass& AddPass(const std::string& name);
+
+	void Compile(VkDevice device, VkPhysicalDevice phyDevice);
+	void Execute(VkCommandBuffer commandBuffer) const;
+
+	const VkImage& GetImage(RenderGraphResource resource) const;
+	const VkImageView& GetImageView(RenderGraphResource resource) const;
+	const VkBuffer& GetBuffer(RenderGraphResource resource) const;
+
+	uint32_t GetCulledPassCount() const;
+	uint32_t GetTransientMemoryBlockCount() const;
+
+private:
+
+	enum class ResourceType
+	{
+		ImportedImage,
+		ImportedBuffer,
+		TransientImage
+	};
+
+	struct Resource
+	{
+		std::string name{};
+		ResourceType type{};
+		VkImageAspectFlags aspect{};
+		VkImageLayout initialLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+		VkImageLayout finalLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+		TransientImageDesc transientDesc{};
+
+		VkImage image{ VK_NULL_HANDLE };
+		VkImageView imageView{ VK_NULL_HANDLE };
+		VkBuffer buffer{ VK_NULL_HANDLE };
+
+		// Set during compilation
+		uint32_t firstPass{ UINT32_MAX };
+		uint32_t lastPass{};
+		uint32_t memoryBlock{ UINT32_MAX };
+		RenderGraphResource aliasedPredecessor{ UINT32_MAX };
+	};
+
+	struct AccessState
+	{
+		VkPipelineStageFlags2 stage{ VK_PIPELINE_STAGE_2_NONE };
+		VkAccessFlags2 access{ VK_ACCESS_2_NONE };
+		VkImageLayout layout{ VK_IMAGE_LAYOUT_UNDEFINED };
+		bool isWrite{};
+	};
+
+	struct Barrier
+	{
+		RenderGraphResource resource{};
+		AccessState src{};
+		AccessState dst{};
+	};
+
+	struct CompiledPass
+	{
+		uint32_t passIdx{};
+		std::vector<Barrier> barriers{};
+	};
+
+	struct MemoryBlock
+	{
+		VkDeviceMemory memory{ VK_NULL_HANDLE };
+		VkDeviceSize size{};
+		VkDeviceSize alignment{ 1 };
+		uint32_t memoryTypeBits{ UINT32_MAX };
+		uint32_t lastPass{};
+		RenderGraphResource lastOccupant{ UINT32_MAX };
+	};
+
+	void CullPasses(std::vector<bool>& passAlive) const;
+	void AllocateTransientImages(VkDevice device, VkPhysicalDevice phyDevice);
+	void BuildBarriers();
+#ifndef NDEBUG
+	void ValidateTransientFirstUses() const;
+#endif
+
+	void RecordBarriers(VkCommandBuffer commandBuffer, const std::vector<Barrier>& barriers) const;
+
+	static AccessState GetAccessState(RenderGraphAccess access, bool isWrite);
+	static bool IsImage(const Resource& resource);
+	static uint32_t FindMemoryType(VkPhysicalDevice phyDevice, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+private:
+
+	std::vector<Resource> m_Resources;
+	std::vector<RenderGraphPass> m_Passes;
+
+	std::vector<CompiledPass> m_CompiledPasses;
+	std::vector<Barrier> m_FinalBarriers;
+	std::vector<MemoryBlock> m_MemoryBlocks;
+
+	// Reused by every RecordBarriers call, reserved at compile time so recording does not allocate
+	mutable std::vector<VkImageMemoryBarrier2> m_ImageBarriers;
+	mutable std::vector<VkBufferMemoryBarrier2> m_BufferBarriers;
+
+	bool m_IsCompiled;
+
+};
+
+#endif // !RENDERGRAPH_H
\ No newline at end of file
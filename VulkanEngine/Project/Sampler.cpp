@@ -1,28 +1,37 @@
 #include <stdexcept>
 
 #include "Sampler.h"
+#include "VulkanStructs.h"
 
 Sampler::Sampler()
 	: m_VkSampler{ VK_NULL_HANDLE }
 {
 }
 
-void Sampler::Initialize(VkDevice device, VkPhysicalDevice phyDevice)
+void Sampler::Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t mipLevels)
+{
+	SamplerConfigs configs{};
+	configs.maxLod = static_cast<float>(mipLevels);
+
+	Initialize(device, phyDevice, configs);
+}
+
+void Sampler::Initialize(VkDevice device, VkPhysicalDevice phyDevice, const SamplerConfigs& configs)
 {
 	VkPhysicalDeviceProperties properties{};
 	vkGetPhysicalDeviceProperties(phyDevice, &properties);
 
 	VkSamplerCreateInfo samplerInfo{};
 	samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-	samplerInfo.magFilter = VK_FILTER_LINEAR;
-	samplerInfo.minFilter = VK_FILTER_LINEAR;
+	samplerInfo.magFilter = configs.filter;
+	samplerInfo.minFilter = configs.filter;
 
-	samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-	samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-	samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+	samplerInfo.addressModeU = configs.addressMode;
+	samplerInfo.addressModeV = configs.addressMode;
+	samplerInfo.addressModeW = configs.addressMode;
 
-	samplerInfo.anisotropyEnable = VK_TRUE;
-	samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
+	samplerInfo.anisotropyEnable = configs.anisotropyEnable ? VK_TRUE : VK_FALSE;
+	samplerInfo.maxAnisotropy = configs.anisotropyEnable ? properties.limits.maxSamplerAnisotropy : 1.0f;
 
 	/*samplerInfo.anisotropyEnable = VK_FALSE;
 	samplerInfo.maxAnisotropy = 1.0f;*/
@@ -37,7 +46,7 @@ void Sampler::Initialize(VkDevice device, VkPhysicalDevice phyDevice)
 	samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
 	samplerInfo.mipLodBias = 0.0f;
 	samplerInfo.minLod = 0.0f;
-	samplerInfo.maxLod = 0.0f;
+	samplerInfo.maxLod = configs.maxLod;
 
 	if (vkCreateSampler(device, &samplerInfo, nullptr, &m_VkSampler) != VK_SUCCESS)
 	{
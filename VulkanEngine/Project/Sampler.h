@@ -3,6 +3,8 @@
 
 #include <vulkan/vulkan.h>
 
+struct SamplerConfigs;
+
 class Sampler final
 {
 public:
@@ -10,7 +12,8 @@ public:
 	Sampler();
 	~Sampler() = default;
 
-	void Initialize(VkDevice device, VkPhysicalDevice phyDevice);
+	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, uint32_t mipLevels = 1);
+	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, const SamplerConfigs& configs);
 	void Destroy(VkDevice device);
 
 	const VkSampler& GetVkSampler() const;
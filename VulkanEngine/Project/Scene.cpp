@@ -1,8 +1,18 @@
 #include <fstream>
+#include <algorithm>
+#include <numeric>
 
 #include <nlohmann/json.hpp>
 
 #include "Scene.h"
+#include "JobSystem.h"
+#include "VulkanInstance.h"
+
+namespace
+{
+	// Draw items with this bit set are chunks of the static batch instead of models
+	constexpr uint32_t s_StaticChunkBit{ 1u << 31 };
+}
 
 // SCENE 2D //
 
@@ -27,12 +37,23 @@ void Scene2D::Destroy(VkDevice device)
 
 void Scene2D::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
 {
-	for (const auto& model : m_Models)
+	Draw(commandBuffer, pipelineLayout, 0, GetModelCount());
+}
+
+void Scene2D::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t firstModel, uint32_t modelCount) const
+{
+	const size_t lastModel{ std::min(size_t{ firstModel } + modelCount, m_Models.size()) };
+	for (size_t modelIdx{ firstModel }; modelIdx < lastModel; ++modelIdx)
 	{
-		model.Draw(commandBuffer, pipelineLayout);
+		m_Models[modelIdx].Draw(commandBuffer, pipelineLayout);
 	}
 }
 
+uint32_t Scene2D::GetModelCount() const
+{
+	return static_cast<uint32_t>(m_Models.size());
+}
+
 // SCENE 3D //
 
 void Scene3D::Initialize(const std::string& filePath)
@@ -40,9 +61,38 @@ void Scene3D::Initialize(const std::string& filePath)
 	// load models from file
 }
 
-void Scene3D::Initialize(std::vector<Model3D>&& models)
+void Scene3D::Initialize(const VulkanInstance& instance, const CommandPool& commandPool, std::vector<Model3D>&& models)
 {
+	// The static models only live on in the batch, their own meshes are released right away
+	const auto firstStatic{ std::stable_partition(models.begin(), models.end(), [](const Model3D& model) { return !model.IsStatic(); }) };
+	m_StaticBatch.Build(instance, commandPool, std::span<const Model3D>{ firstStatic, models.end() });
+	for (auto modelIt{ firstStatic }; modelIt != models.end(); ++modelIt) modelIt->Destroy(instance.GetVkDevice());
+	models.erase(firstStatic, models.end());
+
 	m_Models = std::move(models);
+
+	m_SceneGraph.Clear();
+	m_ModelNodes.clear();
+	m_NodeModels.clear();
+
+	for (uint32_t modelIdx{}; modelIdx < m_Models.size(); ++modelIdx)
+	{
+		const SceneNode node{ m_SceneGraph.CreateNode(SceneGraph::s_InvalidNode, m_Models[modelIdx].GetTransform()) };
+		m_ModelNodes.emplace_back(node);
+
+		if (node >= m_NodeModels.size()) m_NodeModels.resize(size_t{ node } + 1, UINT32_MAX);
+		m_NodeModels[node] = modelIdx;
+	}
+
+	m_ModelBounds.resize(m_Models.size());
+	UpdateModelMatrices();
+	m_BVH.Build(m_ModelBounds);
+
+	// Everything is visible until the first Cull
+	m_VisibleModels.resize(m_Models.size());
+	std::iota(m_VisibleModels.begin(), m_VisibleModels.end(), 0u);
+	m_VisibleChunks.resize(m_StaticBatch.GetChunkCount());
+	std::iota(m_VisibleChunks.begin(), m_VisibleChunks.end(), 0u);
 }
 
 void Scene3D::Destroy(VkDevice device)
@@ -52,17 +102,145 @@ void Scene3D::Destroy(VkDevice device)
 		model.Destroy(device);
 	}
 	m_Models.clear();
+
+	m_SceneGraph.Clear();
+	m_ModelNodes.clear();
+	m_NodeModels.clear();
+
+	m_BVH.Clear();
+	m_ModelBounds.clear();
+	m_VisibleModels.clear();
+
+	m_StaticBatch.Destroy(device);
+	m_VisibleChunks.clear();
+}
+
+bool Scene3D::Update()
+{
+	if (!UpdateModelMatrices()) return false;
+
+	m_BVH.Refit(m_ModelBounds);
+	return true;
+}
+
+void Scene3D::Cull(const Frustum& frustum)
+{
+	m_VisibleModels.clear();
+	m_BVH.QueryFrustum(frustum, m_VisibleModels);
+
+	m_VisibleChunks.clear();
+	m_StaticBatch.Cull(frustum, m_VisibleChunks);
+}
+
+void Scene3D::AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const
+{
+	// Materials are read per instance from the bindless texture table, so they do not split draws and stay out of the key
+	for (uint32_t modelIdx : m_VisibleModels)
+	{
+		const float viewDepth{ view.GetDepth(m_ModelBounds[modelIdx]) };
+		drawList.Add(DrawList::MakeKey(pipeline, 0, m_Models[modelIdx].GetMesh()->GetId(), viewDepth, view.farPlane), modelIdx);
+	}
+
+	// The chunks share the batch's mesh, so they end up next to each other ordered front to back
+	for (uint32_t chunkIdx : m_VisibleChunks)
+	{
+		const float viewDepth{ view.GetDepth(m_StaticBatch.GetChunkBounds(chunkIdx)) };
+		drawList.Add(DrawList::MakeKey(pipeline, 0, m_StaticBatch.GetMesh().GetId(), viewDepth, view.farPlane), chunkIdx | s_StaticChunkBit);
+	}
 }
 
-void Scene3D::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
+void Scene3D::GetInstances(std::span<const DrawItem> drawItems, std::vector<InstanceData>& instances) const
 {
-	for (const auto& model : m_Models)
+	instances.resize(drawItems.size());
+	for (size_t itemIdx{}; itemIdx < drawItems.size(); ++itemIdx)
 	{
-		model.Draw(commandBuffer, pipelineLayout);
+		const uint32_t index{ drawItems[itemIdx].index };
+		if (index & s_StaticChunkBit)
+		{
+			// The static chunks are already in world space
+			instances[itemIdx] = InstanceData{ glm::mat4{ 1.f }, m_StaticBatch.GetChunkMaterial(index & ~s_StaticChunkBit) };
+		}
+		else
+		{
+			const Model3D& model{ m_Models[index] };
+			instances[itemIdx] = InstanceData{ model.GetModelMatrix().model, model.GetMaterial() };
+		}
 	}
 }
 
-void Scene3DIR::Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath)
+uint32_t Scene3D::DrawInstances(VkCommandBuffer commandBuffer, std::span<const DrawItem> drawItems, uint32_t firstInstance, DrawRecordState& state) const
+{
+	const DrawItem& firstItem{ drawItems.front() };
+
+	// Every chunk is its own index range, so chunks are never instanced
+	if (firstItem.index & s_StaticChunkBit)
+	{
+		m_StaticBatch.DrawChunk(commandBuffer, firstItem.index & ~s_StaticChunkBit, firstInstance, state);
+		return 1;
+	}
+
+	const Model3D& model{ m_Models[firstItem.index] };
+
+	uint32_t instanceCount{ 1 };
+	while (instanceCount < drawItems.size())
+	{
+		const DrawItem& drawItem{ drawItems[instanceCount] };
+		if (drawItem.index & s_StaticChunkBit) break;
+		if (DrawList::GetPipeline(drawItem.key) != DrawList::GetPipeline(firstItem.key)) break;
+		if (DrawList::GetMaterial(drawItem.key) != DrawList::GetMaterial(firstItem.key)) break;
+		if (m_Models[drawItem.index].GetMesh() != model.GetMesh()) break;
+		++instanceCount;
+	}
+
+	model.DrawInstances(commandBuffer, instanceCount, firstInstance, state);
+	return instanceCount;
+}
+
+uint32_t Scene3D::GetModelCount() const
+{
+	return static_cast<uint32_t>(m_Models.size());
+}
+
+SceneGraph& Scene3D::GetSceneGraph()
+{
+	return m_SceneGraph;
+}
+
+SceneNode Scene3D::GetModelNode(uint32_t modelIdx) const
+{
+	return m_ModelNodes.at(modelIdx);
+}
+
+const BVH& Scene3D::GetBVH() const
+{
+	return m_BVH;
+}
+
+const std::vector<uint32_t>& Scene3D::GetVisibleModels() const
+{
+	return m_VisibleModels;
+}
+
+// Private Functions //
+bool Scene3D::UpdateModelMatrices()
+{
+	const std::vector<SceneNode>& changedNodes{ m_SceneGraph.Update() };
+
+	bool modelMoved{ false };
+	for (SceneNode node : changedNodes)
+	{
+		if (node >= m_NodeModels.size() || m_NodeModels[node] == UINT32_MAX) continue;
+
+		const uint32_t modelIdx{ m_NodeModels[node] };
+		m_Models[modelIdx].SetModelMatrix(m_SceneGraph.GetWorldMatrix(node));
+		m_ModelBounds[modelIdx] = m_Models[modelIdx].GetWorldBounds();
+		modelMoved = true;
+	}
+
+	return modelMoved;
+}
+
+void Scene3DIR::Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath, uint32_t material)
 {
 	if (!m_Models.empty()) throw std::runtime_error{ "Scene already initialized!" };
 
@@ -93,6 +271,7 @@ void Scene3DIR::Initialize(const VulkanInstance& instance, const CommandPool& co
 
 			Model3DIR model{};
 			model.Initialize(instance, commandPool, modelFilePath, static_cast<uint32_t>(positions.size()));
+			model.SetMaterial(material);
 
 			for (size_t modelInstanceIdx{}; modelInstanceIdx < positions.size(); ++modelInstanceIdx)
 			{
@@ -122,20 +301,137 @@ void Scene3DIR::Destroy(VkDevice device)
 		model.Destroy(device);
 	}
 	m_Models.clear();
+
+	m_BVH.Clear();
+	m_InstanceBounds.clear();
+	m_FirstInstances.clear();
+	m_ModelBounds.clear();
+	m_VisiblePrimitives.clear();
+	m_VisibleModels.clear();
+	m_IsModelVisible.clear();
 }
 
-void Scene3DIR::Update(VkDevice device)
+void Scene3DIR::Update(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame)
 {
-	for (auto& model : m_Models)
+	// The instance matrices only exist after the first update of the models, so that is where the BVH is built
+	const bool build{ m_FirstInstances.size() != m_Models.size() };
+	if (build)
 	{
-		model.Update(device);
+		m_FirstInstances.clear();
+		uint32_t instanceCount{};
+		for (const auto& model : m_Models)
+		{
+			m_FirstInstances.emplace_back(instanceCount);
+			instanceCount += model.GetInstanceCount();
+		}
+		m_InstanceBounds.resize(instanceCount);
+		m_ModelBounds.resize(m_Models.size());
 	}
+
+	bool instancesMoved{ false };
+	for (uint32_t modelIdx{}; modelIdx < m_Models.size(); ++modelIdx)
+	{
+		if (!m_Models[modelIdx].Update(device, jobSystem, currentFrame) && !build) continue;
+
+		UpdateInstanceBounds(modelIdx, jobSystem);
+		instancesMoved = true;
+	}
+
+	if (build) m_BVH.Build(m_InstanceBounds, &jobSystem);
+	else if (instancesMoved) m_BVH.Refit(m_InstanceBounds);
 }
 
-void Scene3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
+void Scene3DIR::Cull(const Frustum& frustum)
 {
-	for (const auto& model : m_Models)
+	for (uint32_t modelIdx : m_VisibleModels) m_IsModelVisible[modelIdx] = false;
+	m_VisibleModels.clear();
+
+	// The instance bounds only exist after the first Update
+	if (m_FirstInstances.size() != m_Models.size()) return;
+	m_IsModelVisible.resize(m_Models.size(), false);
+
+	m_VisiblePrimitives.clear();
+	m_BVH.QueryFrustum(frustum, m_VisiblePrimitives);
+
+	// Models are drawn with all their instances, so one visible instance is enough
+	for (uint32_t primitive : m_VisiblePrimitives)
+	{
+		uint32_t modelIdx{};
+		uint32_t instanceIdx{};
+		GetInstance(primitive, modelIdx, instanceIdx);
+
+		if (m_IsModelVisible[modelIdx]) continue;
+		m_IsModelVisible[modelIdx] = true;
+		m_VisibleModels.emplace_back(modelIdx);
+	}
+}
+
+void Scene3DIR::AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const
+{
+	for (uint32_t modelIdx : m_VisibleModels)
+	{
+		const Model3DIR& model{ m_Models[modelIdx] };
+
+		// The material is pushed per draw, grouping by it keeps the draws of one texture together
+		drawList.Add(DrawList::MakeKey(pipeline, model.GetMaterial(), model.GetMesh()->GetId(), view.GetDepth(m_ModelBounds[modelIdx]), view.farPlane), modelIdx);
+	}
+}
+
+void Scene3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const
+{
+	Draw(commandBuffer, pipelineLayout, currentFrame, 0, GetModelCount());
+}
+
+void Scene3DIR::Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, uint32_t firstModel, uint32_t modelCount) const
+{
+	const size_t lastModel{ std::min(size_t{ firstModel } + modelCount, m_Models.size()) };
+	for (size_t modelIdx{ firstModel }; modelIdx < lastModel; ++modelIdx)
+	{
+		m_Models[modelIdx].Draw(commandBuffer, pipelineLayout, currentFrame);
+	}
+}
+
+void Scene3DIR::DrawModel(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, uint32_t modelIdx, DrawRecordState& state) const
+{
+	m_Models[modelIdx].Draw(commandBuffer, pipelineLayout, currentFrame, state);
+}
+
+uint32_t Scene3DIR::GetModelCount() const
+{
+	return static_cast<uint32_t>(m_Models.size());
+}
+
+const BVH& Scene3DIR::GetBVH() const
+{
+	return m_BVH;
+}
+
+void Scene3DIR::GetInstance(uint32_t primitive, uint32_t& modelIdx, uint32_t& instanceIdx) const
+{
+	// The first instance after the primitive belongs to the next model
+	const auto modelIt{ std::upper_bound(m_FirstInstances.begin(), m_FirstInstances.end(), primitive) - 1 };
+	modelIdx = static_cast<uint32_t>(modelIt - m_FirstInstances.begin());
+	instanceIdx = primitive - *modelIt;
+}
+
+// Private Functions //
+void Scene3DIR::UpdateInstanceBounds(uint32_t modelIdx, JobSystem& jobSystem)
+{
+	const Model3DIR& model{ m_Models[modelIdx] };
+	AABB* pBounds{ m_InstanceBounds.data() + m_FirstInstances[modelIdx] };
+
+	jobSystem.ParallelFor(model.GetInstanceCount(), 1024, [&model, pBounds](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t instanceIdx{ begin }; instanceIdx < end; ++instanceIdx)
+		{
+			pBounds[instanceIdx] = model.GetInstanceBounds(instanceIdx);
+		}
+	});
+
+	AABB modelBounds{};
+	for (uint32_t instanceIdx{}; instanceIdx < model.GetInstanceCount(); ++instanceIdx)
 	{
-		model.Draw(commandBuffer, pipelineLayout);
+		modelBounds.Grow(pBounds[instanceIdx]);
 	}
+	m_ModelBounds[modelIdx] = modelBounds;
 }
\ No newline at end of file
@@ -3,14 +3,20 @@
 
 #include <vector>
 #include <string>
+#include <span>
+#include <cstdint>
 
 #include <vulkan/vulkan.h>
 
 #include "Model.h"
+#include "SceneGraph.h"
+#include "BVH.h"
+#include "StaticBatch.h"
 
 class Camera;
 class VulkanInstance;
 class CommandPool;
+class JobSystem;
 
 class Scene2D final
 {
@@ -24,6 +30,9 @@ public:
 	void Destroy(VkDevice device);
 
 	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t firstModel, uint32_t modelCount) const;
+
+	uint32_t GetModelCount() const;
 
 private:
 
@@ -38,15 +47,51 @@ public:
 	~Scene3D() = default;
 
 	void Initialize(const std::string& filePath);
-	void Initialize(std::vector<Model3D>&& models);
+	// Static models are merged into the static batch, every other model gets a root node in the scene graph with its transform as local transform
+	void Initialize(const VulkanInstance& instance, const CommandPool& commandPool, std::vector<Model3D>&& models);
 	void Destroy(VkDevice device);
 
-	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+	// Copies the world matrices of the nodes that moved into their models and refits the BVH, returns false when nothing moved
+	bool Update();
+	// Collects the models and static chunks inside the frustum, only those are added to the draw list
+	void Cull(const Frustum& frustum);
+	void AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const;
+	// Model matrices and materials of the draws in draw order, the instance stream the draws are recorded against
+	void GetInstances(std::span<const DrawItem> drawItems, std::vector<InstanceData>& instances) const;
+	// Consecutive draws that share a mesh become one instanced draw, returns how many draws it covered.
+	// firstInstance is the stream position of the first draw.
+	uint32_t DrawInstances(VkCommandBuffer commandBuffer, std::span<const DrawItem> drawItems, uint32_t firstInstance, DrawRecordState& state) const;
+
+	// Models that are not static
+	uint32_t GetModelCount() const;
+
+	// Models are moved through their nodes, extra nodes can group them
+	SceneGraph& GetSceneGraph();
+	SceneNode GetModelNode(uint32_t modelIdx) const;
+
+	// The primitives of the BVH are the model indices
+	const BVH& GetBVH() const;
+	const std::vector<uint32_t>& GetVisibleModels() const;
+
+private:
+
+	bool UpdateModelMatrices();
 
 private:
 
 	std::vector<Model3D> m_Models;
 
+	SceneGraph m_SceneGraph;
+	std::vector<SceneNode> m_ModelNodes;
+	std::vector<uint32_t> m_NodeModels; // Model index per node, UINT32_MAX for nodes without model
+
+	BVH m_BVH;
+	std::vector<AABB> m_ModelBounds;
+	std::vector<uint32_t> m_VisibleModels;
+
+	StaticBatch m_StaticBatch;
+	std::vector<uint32_t> m_VisibleChunks;
+
 };
 
 class Scene3DIR final
@@ -61,9 +106,23 @@ public:
 	{
 		// move models
 		m_Models = std::move(other.m_Models);
+		m_BVH = std::move(other.m_BVH);
+		m_InstanceBounds = std::move(other.m_InstanceBounds);
+		m_FirstInstances = std::move(other.m_FirstInstances);
+		m_ModelBounds = std::move(other.m_ModelBounds);
+		m_VisiblePrimitives = std::move(other.m_VisiblePrimitives);
+		m_VisibleModels = std::move(other.m_VisibleModels);
+		m_IsModelVisible = std::move(other.m_IsModelVisible);
 
 		// Invalidate the moved-from object
 		other.m_Models.clear();
+		other.m_BVH.Clear();
+		other.m_InstanceBounds.clear();
+		other.m_FirstInstances.clear();
+		other.m_ModelBounds.clear();
+		other.m_VisiblePrimitives.clear();
+		other.m_VisibleModels.clear();
+		other.m_IsModelVisible.clear();
 	}
 
 	// Add move assignment operator
@@ -73,24 +132,67 @@ public:
 		{
 			// Move resources from other
 			m_Models = std::move(other.m_Models);
+			m_BVH = std::move(other.m_BVH);
+			m_InstanceBounds = std::move(other.m_InstanceBounds);
+			m_FirstInstances = std::move(other.m_FirstInstances);
+			m_ModelBounds = std::move(other.m_ModelBounds);
+			m_VisiblePrimitives = std::move(other.m_VisiblePrimitives);
+			m_VisibleModels = std::move(other.m_VisibleModels);
+			m_IsModelVisible = std::move(other.m_IsModelVisible);
 
 			// Invalidate the moved-from object
 			other.m_Models.clear();
+			other.m_BVH.Clear();
+			other.m_InstanceBounds.clear();
+			other.m_FirstInstances.clear();
+			other.m_ModelBounds.clear();
+			other.m_VisiblePrimitives.clear();
+			other.m_VisibleModels.clear();
+			other.m_IsModelVisible.clear();
 		}
 		return *this;
 	}
 
-	void Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath);
+	// Every model of the file samples the texture table slot of material
+	void Initialize(const VulkanInstance& instance, const CommandPool& commandPool, const std::string& filePath, uint32_t material = 0);
 	void Initialize(std::vector<Model3DIR>&& models);
 	void Destroy(VkDevice device);
 
-	void Update(VkDevice device);
-	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+	// Builds the BVH over every instance on the first call and refits it when instances moved.
+	// Uploads the instance buffers of the frame, so only call it once its frame slot is free.
+	void Update(VkDevice device, JobSystem& jobSystem, uint32_t currentFrame);
+	// Frustum culls the instances through the BVH, a model is visible when any of its instances is
+	void Cull(const Frustum& frustum);
+	// One draw per visible model at the depth of the bounds around all its instances
+	void AddDraws(DrawList& drawList, uint32_t pipeline, const DrawView& view) const;
+	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame) const;
+	void Draw(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, uint32_t firstModel, uint32_t modelCount) const;
+	void DrawModel(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout, uint32_t currentFrame, uint32_t modelIdx, DrawRecordState& state) const;
+
+	uint32_t GetModelCount() const;
+
+	// One primitive per instance, GetInstance maps a primitive back to its model and instance
+	const BVH& GetBVH() const;
+	void GetInstance(uint32_t primitive, uint32_t& modelIdx, uint32_t& instanceIdx) const;
+
+private:
+
+	void UpdateInstanceBounds(uint32_t modelIdx, JobSystem& jobSystem);
 
 private:
 
 	std::vector<Model3DIR> m_Models;
 
+	BVH m_BVH;
+	std::vector<AABB> m_InstanceBounds;
+	std::vector<uint32_t> m_FirstInstances; // First primitive of every model
+	std::vector<AABB> m_ModelBounds; // Around all instances of a model
+
+	// Result of the last Cull
+	std::vector<uint32_t> m_VisiblePrimitives;
+	std::vector<uint32_t> m_VisibleModels;
+	std::vector<uint8_t> m_IsModelVisible;
+
 };
 
 #endif // !SCENE_H
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include <stdexcept>
+#include <algorithm>
+#include <numeric>
+
+#include "SceneGraph.h"
+
+namespace
+{
+	constexpr uint32_t s_NoIndex{ UINT32_MAX };
+}
+
+SceneGraph::SceneGraph()
+	: m_NodeParents{}
+	, m_NodeIndices{}
+	, m_Nodes{}
+	, m_ParentIndices{}
+	, m_LocalTransforms{}
+	, m_WorldMatrices{}
+	, m_Dirty{}
+	, m_FirstDirty{ s_NoIndex }
+	, m_NeedsSort{ false }
+	, m_ChangedNodes{}
+{
+}
+
+void SceneGraph::Clear()
+{
+	m_NodeParents.clear();
+	m_NodeIndices.clear();
+	m_Nodes.clear();
+	m_ParentIndices.clear();
+	m_LocalTransforms.clear();
+	m_WorldMatrices.clear();
+	m_Dirty.clear();
+	m_FirstDirty = s_NoIndex;
+	m_NeedsSort = false;
+	m_ChangedNodes.clear();
+}
+
+SceneNode SceneGraph::CreateNode(SceneNode parent, const Transform3D& localTransform)
+{
+	if (parent != s_InvalidNode) ValidateNode(parent);
+
+	const SceneNode node{ static_cast<SceneNode>(m_NodeParents.size()) };
+	const uint32_t index{ static_cast<uint32_t>(m_Nodes.size()) };
+
+	m_NodeParents.emplace_back(parent);
+	m_NodeIndices.emplace_back(index);
+
+	// Appending keeps every parent in front of its children until the next Update restores the depth order
+	m_Nodes.emplace_back(node);
+	m_ParentIndices.emplace_back(parent == s_InvalidNode ? s_NoIndex : m_NodeIndices[parent]);
+	m_LocalTransforms.emplace_back(localTransform);
+	m_WorldMatrices.emplace_back(1.f);
+	m_Dirty.emplace_back(uint8_t{ 0 });
+
+	m_NeedsSort = true;
+	MarkDirty(index);
+
+	return node;
+}
+
+void SceneGraph::SetParent(SceneNode node, SceneNode parent)
+{
+	ValidateNode(node);
+	if (parent != s_InvalidNode)
+	{
+		ValidateNode(parent);
+		for (SceneNode ancestor{ parent }; ancestor != s_InvalidNode; ancestor = m_NodeParents[ancestor])
+		{
+			if (ancestor == node) throw std::runtime_error{ "SceneGraph: a node can not become a child of its own subtree!" };
+		}
+	}
+
+	if (m_NodeParents[node] == parent) return;
+
+	m_NodeParents[node] = parent;
+	m_NeedsSort = true;
+	MarkDirty(m_NodeIndices[node]);
+}
+
+void SceneGraph::SetLocalTransform(SceneNode node, const Transform3D& localTransform)
+{
+	ValidateNode(node);
+	const uint32_t index{ m_NodeIndices[node] };
+	m_LocalTransforms[index] = localTransform;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetPosition(SceneNode node, const glm::vec3& position)
+{
+	ValidateNode(node);
+	const uint32_t index{ m_NodeIndices[node] };
+	m_LocalTransforms[index].position = position;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetRotation(SceneNode node, const glm::quat& rotation)
+{
+	ValidateNode(node);
+	const uint32_t index{ m_NodeIndices[node] };
+	m_LocalTransforms[index].rotation = rotation;
+	MarkDirty(index);
+}
+
+void SceneGraph::SetScale(SceneNode node, const glm::vec3& scale)
+{
+	ValidateNode(node);
+	const uint32_t index{ m_NodeIndices[node] };
+	m_LocalTransforms[index].scale = scale;
+	MarkDirty(index);
+}
+
+SceneNode SceneGraph::GetParent(SceneNode node) const
+{
+	ValidateNode(node);
+	return m_NodeParents[node];
+}
+
+const Transform3D& SceneGraph::GetLocalTransform(SceneNode node) const
+{
+	ValidateNode(node);
+	return m_LocalTransforms[m_NodeIndices[node]];
+}
+
+const glm::mat4& SceneGraph::GetWorldMatrix(SceneNode node) const
+{
+	ValidateNode(node);
+	return m_WorldMatrices[m_NodeIndices[node]];
+}
+
+uint32_t SceneGraph::GetNodeCount() const
+{
+	return static_cast<uint32_t>(m_Nodes.size());
+}
+
+const std::vector<SceneNode>& SceneGraph::Update()
+{
+	m_ChangedNodes.clear();
+
+	if (m_NeedsSort) SortByDepth();
+	if (m_FirstDirty == s_NoIndex) return m_ChangedNodes;
+
+	// Parents are visited first, so a dirty parent passes its flag down before its children are reached
+	const uint32_t nodeCount{ static_cast<uint32_t>(m_Nodes.size()) };
+	for (uint32_t index{ m_FirstDirty }; index < nodeCount; ++index)
+	{
+		const uint32_t parentIndex{ m_ParentIndices[index] };
+		if (parentIndex != s_NoIndex && m_Dirty[parentIndex]) m_Dirty[index] = 1;
+		if (!m_Dirty[index]) continue;
+
+		const glm::mat4 localMatrix{ m_LocalTransforms[index].GetModelMatrix() };
+		m_WorldMatrices[index] = parentIndex == s_NoIndex ? localMatrix : m_WorldMatrices[parentIndex] * localMatrix;
+
+		m_ChangedNodes.emplace_back(m_Nodes[index]);
+	}
+
+	// Cleared afterwards, the children needed the flags of their parents during the pass
+	for (SceneNode node : m_ChangedNodes)
+	{
+		m_Dirty[m_NodeIndices[node]] = 0;
+	}
+	m_FirstDirty = s_NoIndex;
+
+	return m_ChangedNodes;
+}
+
+// Private Functions //
+void SceneGraph::MarkDirty(uint32_t index)
+{
+	m_Dirty[index] = 1;
+	m_FirstDirty = std::min(m_FirstDirty, index);
+}
+
+void SceneGraph::SortByDepth()
+{
+	const uint32_t nodeCount{ static_cast<uint32_t>(m_NodeParents.size()) };
+
+	// Depth of every node, each chain is only walked up to the first node with a known depth
+	std::vector<uint32_t> depths(nodeCount, s_NoIndex);
+	std::vector<SceneNode> chain{};
+	for (SceneNode node{}; node < nodeCount; ++node)
+	{
+		SceneNode current{ node };
+		while (current != s_InvalidNode && depths[current] == s_NoIndex)
+		{
+			chain.emplace_back(current);
+			current = m_NodeParents[current];
+		}
+
+		uint32_t depth{ current == s_InvalidNode ? 0 : depths[current] + 1 };
+		for (auto chainIt{ chain.rbegin() }; chainIt != chain.rend(); ++chainIt)
+		{
+			depths[*chainIt] = depth++;
+		}
+		chain.clear();
+	}
+
+	std::vector<SceneNode> order(nodeCount);
+	std::iota(order.begin(), order.end(), SceneNode{});
+	std::stable_sort(order.begin(), order.end(), [&depths](SceneNode lhs, SceneNode rhs) { return depths[lhs] < depths[rhs]; });
+
+	std::vector<Transform3D> localTransforms(nodeCount);
+	std::vector<glm::mat4> worldMatrices(nodeCount);
+	std::vector<uint8_t> dirty(nodeCount);
+	for (uint32_t index{}; index < nodeCount; ++index)
+	{
+		const uint32_t oldIndex{ m_NodeIndices[order[index]] };
+		localTransforms[index] = m_LocalTransforms[oldIndex];
+		worldMatrices[index] = m_WorldMatrices[oldIndex];
+		dirty[index] = m_Dirty[oldIndex];
+	}
+
+	m_Nodes = std::move(order);
+	m_LocalTransforms = std::move(localTransforms);
+	m_WorldMatrices = std::move(worldMatrices);
+	m_Dirty = std::move(dirty);
+
+	for (uint32_t index{}; index < nodeCount; ++index)
+	{
+		m_NodeIndices[m_Nodes[index]] = index;
+	}
+
+	m_FirstDirty = s_NoIndex;
+	for (uint32_t index{}; index < nodeCount; ++index)
+	{
+		const SceneNode parent{ m_NodeParents[m_Nodes[index]] };
+		m_ParentIndices[index] = parent == s_InvalidNode ? s_NoIndex : m_NodeIndices[parent];
+
+		if (m_Dirty[index] && m_FirstDirty == s_NoIndex) m_FirstDirty = index;
+	}
+
+	m_NeedsSort = false;
+}
+
+void SceneGraph::ValidateNode(SceneNode node) const
+{
+	if (node >= m_NodeParents.size()) throw std::runtime_error{ "SceneGraph: invalid node " + std::to_string(node) + "!" };
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "VulkanStructs.h"
+
+// Stable handle of a node, the node's slot in the sorted arrays changes when the hierarchy changes
+using SceneNode = uint32_t;
+
+// Transform hierarchy with the nodes stored in contiguous arrays sorted by depth, so every parent comes before its children.
+// Changing a local transform only marks the node dirty. Update recomputes the world matrices of the dirty nodes
+// and their descendants in one linear pass, starting at the first dirty node.
+class SceneGraph final
+{
+public:
+
+	static constexpr SceneNode s_InvalidNode{ UINT32_MAX };
+
+	SceneGraph();
+	~SceneGraph() = default;
+
+	SceneGraph(const SceneGraph& other) = default;
+	SceneGraph(SceneGraph&& other) noexcept = default;
+	SceneGraph& operator=(const SceneGraph& other) = default;
+	SceneGraph& operator=(SceneGraph&& other) noexcept = default;
+
+	void Clear();
+
+	SceneNode CreateNode(SceneNode parent = s_InvalidNode, const Transform3D& localTransform = Transform3D{});
+	void SetParent(SceneNode node, SceneNode parent);
+
+	void SetLocalTransform(SceneNode node, const Transform3D& localTransform);
+	void SetPosition(SceneNode node, const glm::vec3& position);
+	void SetRotation(SceneNode node, const glm::quat& rotation);
+	void SetScale(SceneNode node, const glm::vec3& scale);
+
+	SceneNode GetParent(SceneNode node) const;
+	const Transform3D& GetLocalTransform(SceneNode node) const;
+	// Valid after the Update that followed the last change
+	const glm::mat4& GetWorldMatrix(SceneNode node) const;
+	uint32_t GetNodeCount() const;
+
+	// Returns the nodes whose world matrix was recomputed, valid until the next Update
+	const std::vector<SceneNode>& Update();
+
+private:
+
+	void MarkDirty(uint32_t index);
+	void SortByDepth();
+	void ValidateNode(SceneNode node) const;
+
+private:
+
+	// Indexed by handle
+	std::vector<SceneNode> m_NodeParents;
+	std::vector<uint32_t> m_NodeIndices;
+
+	// Indexed by depth sorted slot
+	std::vector<SceneNode> m_Nodes;
+	std::vector<uint32_t> m_ParentIndices;
+	std::vector<Transform3D> m_LocalTransforms;
+	std::vector<glm::mat4> m_WorldMatrices;
+	std::vector<uint8_t> m_Dirty;
+
+	uint32_t m_FirstDirty;
+	bool m_NeedsSort;
+
+	std::vector<SceneNode> m_ChangedNodes;
+
+};
+
+#endif // !SCENEGRAPH_H
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "ShaderCache.h"
+#include "VulkanStructs.h"
+
+ShaderCache::ShaderCache()
+	: m_Shaders{}
+	, m_ShadersMutex{}
+{
+}
+
+void ShaderCache::Destroy(VkDevice device)
+{
+	std::lock_guard<std::mutex> lock{ m_ShadersMutex };
+
+	for (auto& [key, pEntry] : m_Shaders)
+	{
+		pEntry->shader.Destroy(device);
+	}
+	m_Shaders.clear();
+}
+
+const Shader& ShaderCache::GetShader(VkDevice device, const ShaderConfig& shaderConfig)
+{
+	const std::string key{ shaderConfig.filePath + "|" + shaderConfig.entryPoint + "|" + std::to_string(shaderConfig.stage) };
+
+	Entry* pEntry{ nullptr };
+	{
+		std::lock_guard<std::mutex> lock{ m_ShadersMutex };
+
+		std::unique_ptr<Entry>& pStoredEntry{ m_Shaders[key] };
+		if (!pStoredEntry) pStoredEntry = std::make_unique<Entry>();
+		pEntry = pStoredEntry.get();
+	}
+
+	// Loading happens outside the map lock, concurrent requests for the same module wait here
+	std::call_once(pEntry->loaded, [&]() { pEntry->shader.Initialize(device, shaderConfig); });
+
+	return pEntry->shader;
+}
\ No newline at end of file
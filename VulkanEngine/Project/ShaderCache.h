@@ -0,0 +1,46 @@
+#ifndef SHADERCACHE_H
+#define SHADERCACHE_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.h>
+
+#include "Shader.h"
+
+struct ShaderConfig;
+
+// Thread safe cache of shader modules, every SPIR-V file is read and turned into a module once.
+// Modules are only needed while pipelines are created and can be destroyed afterwards.
+class ShaderCache final
+{
+public:
+
+	ShaderCache();
+	~ShaderCache() = default;
+
+	ShaderCache(const ShaderCache& other) = delete;
+	ShaderCache(ShaderCache&& other) noexcept = delete;
+	ShaderCache& operator=(const ShaderCache& other) = delete;
+	ShaderCache& operator=(ShaderCache&& other) noexcept = delete;
+
+	void Destroy(VkDevice device);
+
+	const Shader& GetShader(VkDevice device, const ShaderConfig& shaderConfig);
+
+private:
+
+	struct Entry
+	{
+		std::once_flag loaded{};
+		Shader shader{};
+	};
+
+	std::unordered_map<std::string, std::unique_ptr<Entry>> m_Shaders;
+	std::mutex m_ShadersMutex;
+
+};
+
+#endif // !SHADERCACHE_H
\ No newline at end of file
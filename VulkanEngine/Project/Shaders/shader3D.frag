@@ -1,15 +1,18 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D textures[];
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
+layout(location = 2) flat in uint fragMaterial;
 
 layout(location = 0) out vec4 outColor;
 
 void main()
 {
-    outColor = texture(texSampler, fragTexCoord);
+    // Instances of one draw can use different materials
+    outColor = texture(textures[nonuniformEXT(fragMaterial)], fragTexCoord);
     //outColor = vec4(fragTexCoord, 1.f, 1.f);
     //outColor = vec4(fragColor, 1.f);
 }
\ No newline at end of file
@@ -1,10 +1,5 @@
 #version 450
 
-layout(push_constant) uniform Model3DUBO
-{
-    mat4 model;
-} modelUBO;
-
 layout(set = 0, binding = 0) uniform CameraUBO
 {
     mat4 view;
@@ -14,13 +9,17 @@ layout(set = 0, binding = 0) uniform CameraUBO
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in mat4 instanceModelMatrix;
+layout(location = 7) in uint instanceMaterial;
 
 layout(location = 0) out vec3 fragColor;
 layout(location = 1) out vec2 fragTexCoord;
+layout(location = 2) flat out uint fragMaterial;
 
 void main()
 {
-    gl_Position = cameraUBO.proj * cameraUBO.view * modelUBO.model * vec4(inPosition, 1.0);
+    gl_Position = cameraUBO.proj * cameraUBO.view * instanceModelMatrix * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
+    fragMaterial = instanceMaterial;
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #version 450
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(binding = 1) uniform sampler2D texSampler;
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform MaterialPush
+{
+    uint material;
+} materialPush;
 
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in vec2 fragTexCoord;
@@ -9,6 +15,6 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
-    outColor = texture(texSampler, fragTexCoord);
+    outColor = texture(textures[materialPush.material], fragTexCoord);
     //outColor = vec4(fragTexCoord, 1.f, 1.f);
 }
\ No newline at end of file
@@ -0,0 +1,201 @@
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <string>
+
+#include "StaticBatch.h"
+#include "Model.h"
+
+namespace
+{
+	// Large enough to keep the draw count in the tens for big scenes, small enough for the chunks to still be culled
+	constexpr uint32_t s_MaxChunkIndexCount{ 3 * 65536 };
+
+	struct Geometry
+	{
+		std::vector<Vertex3D> vertices{};
+		std::vector<uint32_t> indices{};
+	};
+}
+
+StaticBatch::StaticBatch()
+	: m_Mesh{}
+	, m_Chunks{}
+	, m_ChunkBounds{}
+	, m_BVH{}
+{
+}
+
+void StaticBatch::Build(const VulkanInstance& instance, const CommandPool& commandPool, std::span<const Model3D> models)
+{
+	if (!m_Chunks.empty()) throw std::runtime_error{ "Static batch already built!" };
+	if (models.empty()) return;
+
+	// Every file is loaded once, no matter how many props use it
+	std::unordered_map<std::string, Geometry> geometries{};
+
+	std::vector<Vertex3D> worldVertices{};
+	std::vector<uint32_t> modelIndices{};
+	std::vector<BatchedModel> batchedModels{};
+	batchedModels.reserve(models.size());
+
+	for (const Model3D& model : models)
+	{
+		if (model.GetFilePath().empty()) throw std::runtime_error{ "Static models need a model file to be batched!" };
+
+		auto geometryIt{ geometries.find(model.GetFilePath()) };
+		if (geometryIt == geometries.end())
+		{
+			geometryIt = geometries.emplace(model.GetFilePath(), Geometry{}).first;
+			Mesh::LoadFromFile(model.GetFilePath(), geometryIt->second.vertices, geometryIt->second.indices);
+		}
+		const Geometry& geometry{ geometryIt->second };
+		const glm::mat4& modelMatrix{ model.GetModelMatrix().model };
+
+		BatchedModel batchedModel{};
+		batchedModel.firstVertex = static_cast<uint32_t>(worldVertices.size());
+		batchedModel.vertexCount = static_cast<uint32_t>(geometry.vertices.size());
+		batchedModel.firstIndex = static_cast<uint32_t>(modelIndices.size());
+		batchedModel.indexCount = static_cast<uint32_t>(geometry.indices.size());
+		batchedModel.material = model.GetMaterial();
+
+		for (Vertex3D vertex : geometry.vertices)
+		{
+			vertex.pos = glm::vec3{ modelMatrix * glm::vec4{ vertex.pos, 1.f } };
+			batchedModel.bounds.Grow(vertex.pos);
+			worldVertices.emplace_back(vertex);
+		}
+		modelIndices.insert(modelIndices.end(), geometry.indices.begin(), geometry.indices.end());
+
+		batchedModels.emplace_back(batchedModel);
+	}
+
+	// A chunk is one draw with one instance, so it can only hold models of a single material
+	std::stable_sort(batchedModels.begin(), batchedModels.end(), [](const BatchedModel& lhs, const BatchedModel& rhs)
+	{
+		return lhs.material < rhs.material;
+	});
+
+	std::vector<std::span<BatchedModel>> chunkModels{};
+	for (auto materialBegin{ batchedModels.begin() }; materialBegin != batchedModels.end();)
+	{
+		const auto materialEnd{ std::find_if(materialBegin, batchedModels.end(), [materialBegin](const BatchedModel& model) { return model.material != materialBegin->material; }) };
+		SplitChunks(std::span<BatchedModel>{ materialBegin, materialEnd }, chunkModels);
+		materialBegin = materialEnd;
+	}
+
+	// Vertices and indices are laid out in chunk order, so every chunk is one contiguous index range
+	std::vector<Vertex3D> vertices{};
+	std::vector<uint32_t> indices{};
+	vertices.reserve(worldVertices.size());
+	indices.reserve(modelIndices.size());
+
+	AABB batchBounds{};
+	for (const std::span<BatchedModel> chunk : chunkModels)
+	{
+		Chunk& newChunk{ m_Chunks.emplace_back(Chunk{ static_cast<uint32_t>(indices.size()), 0, chunk.front().material }) };
+		AABB& chunkBounds{ m_ChunkBounds.emplace_back() };
+
+		for (const BatchedModel& batchedModel : chunk)
+		{
+			const uint32_t baseVertex{ static_cast<uint32_t>(vertices.size()) };
+			vertices.insert(vertices.end(), worldVertices.begin() + batchedModel.firstVertex, worldVertices.begin() + batchedModel.firstVertex + batchedModel.vertexCount);
+
+			for (uint32_t indexIdx{}; indexIdx < batchedModel.indexCount; ++indexIdx)
+			{
+				indices.emplace_back(baseVertex + modelIndices[batchedModel.firstIndex + indexIdx]);
+			}
+
+			chunkBounds.Grow(batchedModel.bounds);
+		}
+
+		newChunk.indexCount = static_cast<uint32_t>(indices.size()) - newChunk.firstIndex;
+		batchBounds.Grow(chunkBounds);
+	}
+
+	m_Mesh.Initialize(instance, commandPool, vertices.data(), sizeof(vertices[0]) * vertices.size(), indices, batchBounds);
+	m_BVH.Build(m_ChunkBounds);
+}
+
+void StaticBatch::Destroy(VkDevice device)
+{
+	if (!m_Chunks.empty()) m_Mesh.Destroy(device);
+
+	m_Chunks.clear();
+	m_ChunkBounds.clear();
+	m_BVH.Clear();
+}
+
+void StaticBatch::Cull(const Frustum& frustum, std::vector<uint32_t>& visibleChunks) const
+{
+	if (m_Chunks.empty()) return;
+
+	m_BVH.QueryFrustum(frustum, visibleChunks);
+}
+
+void StaticBatch::DrawChunk(VkCommandBuffer commandBuffer, uint32_t chunkIdx, uint32_t firstInstance, DrawRecordState& state) const
+{
+	if (state.pMesh != &m_Mesh)
+	{
+		m_Mesh.Bind(commandBuffer);
+		state.pMesh = &m_Mesh;
+		++state.stats.vertexBufferBinds;
+	}
+
+	const Chunk& chunk{ m_Chunks[chunkIdx] };
+	vkCmdDrawIndexed(commandBuffer, chunk.indexCount, 1, chunk.firstIndex, 0, firstInstance);
+	++state.stats.drawCount;
+}
+
+uint32_t StaticBatch::GetChunkCount() const
+{
+	return static_cast<uint32_t>(m_Chunks.size());
+}
+
+const AABB& StaticBatch::GetChunkBounds(uint32_t chunkIdx) const
+{
+	return m_ChunkBounds[chunkIdx];
+}
+
+uint32_t StaticBatch::GetChunkMaterial(uint32_t chunkIdx) const
+{
+	return m_Chunks[chunkIdx].material;
+}
+
+const Mesh& StaticBatch::GetMesh() const
+{
+	return m_Mesh;
+}
+
+// Private Functions //
+void StaticBatch::SplitChunks(std::span<BatchedModel> models, std::vector<std::span<BatchedModel>>& chunkModels) const
+{
+	uint64_t indexCount{};
+	AABB centroidBounds{};
+	for (const BatchedModel& model : models)
+	{
+		indexCount += model.indexCount;
+		centroidBounds.Grow(model.bounds.GetCenter());
+	}
+
+	// A single model larger than a chunk still becomes its own chunk
+	if (indexCount <= s_MaxChunkIndexCount || models.size() == 1)
+	{
+		chunkModels.emplace_back(models);
+		return;
+	}
+
+	const glm::vec3 extent{ centroidBounds.GetExtent() };
+	int axis{ 0 };
+	if (extent.y > extent.x) axis = 1;
+	if (extent.z > extent[axis]) axis = 2;
+
+	const size_t middle{ models.size() / 2 };
+	std::nth_element(models.begin(), models.begin() + middle, models.end(), [axis](const BatchedModel& lhs, const BatchedModel& rhs)
+	{
+		return lhs.bounds.GetCenter()[axis] < rhs.bounds.GetCenter()[axis];
+	});
+
+	SplitChunks(models.first(middle), chunkModels);
+	SplitChunks(models.subspan(middle), chunkModels);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+#include "Mesh.h"
+#include "BVH.h"
+#include "DrawList.h"
+
+class Model3D;
+class CommandPool;
+class VulkanInstance;
+
+// Never moving models merged into one vertex and index buffer, with their vertices transformed to world space at build time.
+// The merged geometry is split by material and then spatially into chunks with contiguous index ranges, each chunk is culled and drawn as one draw.
+class StaticBatch final
+{
+public:
+
+	StaticBatch();
+	~StaticBatch() = default;
+
+	StaticBatch(const StaticBatch& other) = delete;
+	StaticBatch(StaticBatch&& other) noexcept = delete;
+	StaticBatch& operator=(const StaticBatch& other) = delete;
+	StaticBatch& operator=(StaticBatch&& other) noexcept = delete;
+
+	// The geometry is loaded again from the models' files, the models themselves are left untouched
+	void Build(const VulkanInstance& instance, const CommandPool& commandPool, std::span<const Model3D> models);
+	void Destroy(VkDevice device);
+
+	void Cull(const Frustum& frustum, std::vector<uint32_t>& visibleChunks) const;
+	// The chunk's vertices are already in world space, the instance at firstInstance has to hold an identity matrix and the chunk's material
+	void DrawChunk(VkCommandBuffer commandBuffer, uint32_t chunkIdx, uint32_t firstInstance, DrawRecordState& state) const;
+
+	uint32_t GetChunkCount() const;
+	const AABB& GetChunkBounds(uint32_t chunkIdx) const;
+	uint32_t GetChunkMaterial(uint32_t chunkIdx) const;
+	const Mesh& GetMesh() const;
+
+private:
+
+	struct BatchedModel
+	{
+		AABB bounds{};
+		uint32_t firstVertex{};
+		uint32_t vertexCount{};
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		uint32_t material{};
+	};
+
+	struct Chunk
+	{
+		uint32_t firstIndex{};
+		uint32_t indexCount{};
+		uint32_t material{};
+	};
+
+	// Median splits on the longest axis until every range of models fits in a chunk
+	void SplitChunks(std::span<BatchedModel> models, std::vector<std::span<BatchedModel>>& chunkModels) const;
+
+private:
+
+	Mesh m_Mesh;
+	std::vector<Chunk> m_Chunks;
+	std::vector<AABB> m_ChunkBounds;
+	BVH m_BVH;
+
+};
+
+#endif // !STATICBATCH_H
\ No newline at end of file
@@ -4,10 +4,11 @@
 #include "Swapchain.h"
 #include "VulkanInstance.h"
 #include "Window.h"
+#include "EngineSettings.h"
 
-void Swapchain::Initialize(const VulkanInstance& instance, const Window& window)
+void Swapchain::Initialize(const VulkanInstance& instance, const Window& window, VkSwapchainKHR oldSwapchain)
 {
-	CreateSwapchain(instance, window);
+	CreateSwapchain(instance, window, oldSwapchain);
 	CreateSwapchainImageViews(instance.GetVkDevice());
 }
 
@@ -41,12 +42,17 @@ const VkExtent2D& Swapchain::GetVkExtent() const
 	return m_VkExtent;
 }
 
+const std::vector<VkImage>& Swapchain::GetVkImages() const
+{
+	return m_VkImages;
+}
+
 const std::vector<ImageView>& Swapchain::GetImageViews() const
 {
 	return m_ImageViews;
 }
 
-void Swapchain::CreateSwapchain(const VulkanInstance& instance, const Window& window)
+void Swapchain::CreateSwapchain(const VulkanInstance& instance, const Window& window, VkSwapchainKHR oldSwapchain)
 {
 	const VkDevice& device{ instance.GetVkDevice() };
 	const VkSurfaceKHR& surface{ instance.GetVkSurface() };
@@ -58,6 +64,10 @@ void Swapchain::CreateSwapchain(const VulkanInstance& instance, const Window& wi
 	VkExtent2D extent{ ChooseSwapExtent(swapChainSupport.capabilities, window) };
 
 	uint32_t imageCount{ swapChainSupport.capabilities.minImageCount + 1 }; // recommended minimum + 1 (otherwise bottleneck)
+	if (EngineSettings::Get().GetSwapchainImageCount() > 0) // configured count, still at least the surface minimum
+	{
+		imageCount = std::max(EngineSettings::Get().GetSwapchainImageCount(), swapChainSupport.capabilities.minImageCount);
+	}
 	if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) // check to not exceed max
 	{
 		imageCount = swapChainSupport.capabilities.maxImageCount;
@@ -96,7 +106,7 @@ void Swapchain::CreateSwapchain(const VulkanInstance& instance, const Window& wi
 	createInfo.presentMode = presentMode;
 	createInfo.clipped = VK_TRUE; // Enabling clipping (best performance)
 
-	createInfo.oldSwapchain = VK_NULL_HANDLE; // Needed when recreating swapchain (window resizing, etc..)
+	createInfo.oldSwapchain = oldSwapchain; // Needed when recreating swapchain (window resizing, etc..)
 
 	if (vkCreateSwapchainKHR(device, &createInfo, VK_NULL_HANDLE, &m_VkSwapChain) != VK_SUCCESS)
 	{
@@ -148,14 +158,15 @@ VkPresentModeKHR Swapchain::ChooseSwapPresentMode(const std::vector<VkPresentMod
 	// VK_PRESENT_MODE_FIFO_RELAXED_KHR // Force inserts it, can have teering
 	// VK_PRESENT_MODE_MAILBOX_KHR // Queue get replaced (triple buffering)
 
+	const VkPresentModeKHR preferredPresentMode{ EngineSettings::Get().GetPreferredPresentMode() };
 	for (const auto& availablePresentMode : availablePresentModes)
 	{
-		if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
+		if (availablePresentMode == preferredPresentMode)
 		{
 			return availablePresentMode;
 		}
 	}
-	return VK_PRESENT_MODE_FIFO_KHR;
+	return VK_PRESENT_MODE_FIFO_KHR; // always supported
 }
 
 VkExtent2D Swapchain::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities, const Window& window) const
@@ -17,17 +17,19 @@ public:
 	Swapchain() = default;
 	~Swapchain() = default;
 
-	void Initialize(const VulkanInstance& instance, const Window& window);
+	// Passing the previous swapchain lets the presentation engine hand its resources over, it has to be destroyed by the caller
+	void Initialize(const VulkanInstance& instance, const Window& window, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE);
 	void Destroy(VkDevice device);
 
 	const VkSwapchainKHR& GetVkSwapchain() const;
 	const VkFormat& GetVkFormat() const;
 	const VkExtent2D& GetVkExtent() const;
+	const std::vector<VkImage>& GetVkImages() const;
 	const std::vector<ImageView>& GetImageViews() const;
 
 private:
 
-	void CreateSwapchain(const VulkanInstance& instance, const Window& window);
+	void CreateSwapchain(const VulkanInstance& instance, const Window& window, VkSwapchainKHR oldSwapchain);
 	void CreateSwapchainImageViews(VkDevice device);
 
 	VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) const;
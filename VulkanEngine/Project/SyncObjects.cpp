@@ -1,25 +1,21 @@
 #include "SyncObjects.h"
 
 #include "VulkanUtils.h"
+#include "EngineSettings.h"
 
 void SyncObjects::Initialize(VkDevice device)
 {
-	m_ImageAvailableSemaphores.resize(g_MaxFramesInFlight);
-	m_RenderFinishedSemaphores.resize(g_MaxFramesInFlight);
-	m_InFlightFences.resize(g_MaxFramesInFlight);
+	m_ImageAvailableSemaphores.resize(EngineSettings::Get().GetMaxFramesInFlight());
+	m_RenderFinishedSemaphores.resize(EngineSettings::Get().GetMaxFramesInFlight());
+	m_FrameSubmissions.assign(EngineSettings::Get().GetMaxFramesInFlight(), QueueSubmission{});
 
 	VkSemaphoreCreateInfo semaphoreInfo{};
 	semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-	VkFenceCreateInfo fenceInfo{};
-	fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-	fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-	for (int idx{}; idx < g_MaxFramesInFlight; idx++)
+	for (uint32_t idx{}; idx < EngineSettings::Get().GetMaxFramesInFlight(); idx++)
 	{
 		if (vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &m_ImageAvailableSemaphores[idx]) != VK_SUCCESS ||
-			vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &m_RenderFinishedSemaphores[idx]) != VK_SUCCESS ||
-			vkCreateFence(device, &fenceInfo, VK_NULL_HANDLE, &m_InFlightFences[idx]) != VK_SUCCESS)
+			vkCreateSemaphore(device, &semaphoreInfo, VK_NULL_HANDLE, &m_RenderFinishedSemaphores[idx]) != VK_SUCCESS)
 		{
 
 			throw std::runtime_error{ "failed to create synchronization objects for a frame!" };
@@ -41,11 +37,7 @@ void SyncObjects::Destroy(VkDevice device)
 	}
 	m_RenderFinishedSemaphores.clear();
 
-	for (auto inFlightFence : m_InFlightFences)
-	{
-		vkDestroyFence(device, inFlightFence, VK_NULL_HANDLE);
-	}
-	m_InFlightFences.clear();
+	m_FrameSubmissions.clear();
 }
 
 const VkSemaphore& SyncObjects::GetImageAvailableSemaphore(uint32_t currentFrame)
@@ -58,7 +50,12 @@ const VkSemaphore& SyncObjects::GetRenderFinishedSemaphore(uint32_t currentFrame
 	return m_RenderFinishedSemaphores[currentFrame];
 }
 
-const VkFence& SyncObjects::GetInFlightFence(uint32_t currentFrame)
+const QueueSubmission& SyncObjects::GetFrameSubmission(uint32_t currentFrame) const
+{
+	return m_FrameSubmissions[currentFrame];
+}
+
+void SyncObjects::SetFrameSubmission(uint32_t currentFrame, const QueueSubmission& submission)
 {
-	return m_InFlightFences[currentFrame];
+	m_FrameSubmissions[currentFrame] = submission;
 }
\ No newline at end of file
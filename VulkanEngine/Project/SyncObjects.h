@@ -5,6 +5,10 @@
 
 #include <vulkan/vulkan.h>
 
+#include "Queue.h"
+
+// Binary semaphores are only used for swapchain acquire and present,
+// frame slots are reused once the graphics queue timeline reached the value of their last submission
 class SyncObjects final
 {
 public:
@@ -17,13 +21,14 @@ public:
 
 	const VkSemaphore& GetImageAvailableSemaphore(uint32_t currentFrame);
 	const VkSemaphore& GetRenderFinishedSemaphore(uint32_t currentFrame);
-	const VkFence& GetInFlightFence(uint32_t currentFrame);
+	const QueueSubmission& GetFrameSubmission(uint32_t currentFrame) const;
+	void SetFrameSubmission(uint32_t currentFrame, const QueueSubmission& submission);
 
 private:
 
 	std::vector<VkSemaphore> m_ImageAvailableSemaphores;
 	std::vector<VkSemaphore> m_RenderFinishedSemaphores;
-	std::vector<VkFence> m_InFlightFences;
+	std::vector<QueueSubmission> m_FrameSubmissions;
 
 };
 
@@ -1,4 +1,5 @@
 #include <stdexcept>
+#include <algorithm>
 
 #include <iostream>
 #include <filesystem>
@@ -9,58 +10,77 @@
 #include "Texture.h"
 
 #include "DataBuffer.h"
+#include "DeletionQueue.h"
+#include "Ktx2File.h"
 #include "VulkanUtils.h"
 #include "VulkanInstance.h"
+#include "Queue.h"
 
 Texture::Texture()
 	: m_Image{}
 	, m_ImageView{}
 	, m_TextureSampler{}
+	, m_OwnsSampler{ true }
 {
 }
 
-void Texture::Initialize(const VulkanInstance& instance, const CommandPool& cmndPl, const std::string& filePath)
+void Texture::Initialize(const VulkanInstance& instance, const std::string& filePath)
 {
 	const VkDevice& device{ instance.GetVkDevice() };
 	const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
-	const VkQueue& graphQ{ instance.GetGraphicsQueue() };
-
-	constexpr VkFormat imageFormat{ VK_FORMAT_R8G8B8A8_SRGB };
+	Queue& graphicsQueue{ instance.GetQueue(QueueType::Graphics) };
 
 	// Image //
-	InitImage(device, phyDevice, graphQ, cmndPl, filePath, imageFormat);
+	const VkFormat imageFormat{ InitImage(device, phyDevice, graphicsQueue, filePath) };
 
 	// ImageView //
 	InitImageView(device, imageFormat);
 
 	// Sampler
-	m_TextureSampler.Initialize(device, phyDevice);
+	m_TextureSampler.Initialize(device, phyDevice, m_Image.GetMipLevels());
+	m_OwnsSampler = true;
 }
 
-void Texture::Initialize(const VulkanInstance& instance, const CommandPool& cmndPl, const std::string& filePath, const Sampler& sampler)
+void Texture::Initialize(const VulkanInstance& instance, const std::string& filePath, const Sampler& sampler)
 {
 	const VkDevice& device{ instance.GetVkDevice() };
 	const VkPhysicalDevice& phyDevice{ instance.GetVkPhysicalDevice() };
-	const VkQueue& graphQ{ instance.GetGraphicsQueue() };
-
-	constexpr VkFormat imageFormat{ VK_FORMAT_R8G8B8A8_SRGB };
+	Queue& graphicsQueue{ instance.GetQueue(QueueType::Graphics) };
 
 	// Image //
-	InitImage(device, phyDevice, graphQ, cmndPl, filePath, imageFormat);
+	const VkFormat imageFormat{ InitImage(device, phyDevice, graphicsQueue, filePath) };
 
 	// ImageView //
 	InitImageView(device, imageFormat);
-	m_TextureSampler.Destroy(device);
+
+	// Sampler is shared, its owner is responsible for destroying it
 	m_TextureSampler = sampler;
+	m_OwnsSampler = false;
 }
 
 void Texture::Destroy(VkDevice device)
 {
-	m_TextureSampler.Destroy(device);
+	if (m_OwnsSampler) m_TextureSampler.Destroy(device);
+	m_TextureSampler = Sampler{};
 	m_ImageView.Destroy(device);
 	m_Image.Destroy(device);
 }
 
+void Texture::DeferDestroy()
+{
+	ImageView imageView{ m_ImageView };
+	Sampler sampler{ m_OwnsSampler ? m_TextureSampler : Sampler{} };
+	DeletionQueue::Get().Push([imageView, sampler](VkDevice device) mutable
+		{
+			sampler.Destroy(device);
+			imageView.Destroy(device);
+		});
+
+	m_TextureSampler = Sampler{};
+	m_ImageView = ImageView{};
+	m_Image.DeferDestroy();
+}
+
 const VkImage& Texture::GetVkImage() const
 {
 	return m_Image.GetVkImage();
@@ -91,7 +111,26 @@ const Sampler& Texture::GetSampler() const
 	return m_TextureSampler;
 }
 
-void Texture::InitImage(VkDevice device, VkPhysicalDevice phyDevice, VkQueue queue, const CommandPool& cmndPl, const std::string& filePath, VkFormat imageFormat)
+VkFormat Texture::InitImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath)
+{
+	// Prefer the cooked block compressed version, decode the source image if it is missing or not supported
+	const std::string cookedFilePath{ GetCookedFilePath(filePath) };
+
+	VkFormat imageFormat{ VK_FORMAT_UNDEFINED };
+	if (InitCompressedImage(device, phyDevice, queue, cookedFilePath, imageFormat)) return imageFormat;
+
+	if (cookedFilePath == filePath)
+	{
+		throw std::runtime_error{ "ktx2 texture format not supported by device: " + filePath };
+	}
+
+	imageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+	InitImage(device, phyDevice, queue, filePath, imageFormat);
+
+	return imageFormat;
+}
+
+void Texture::InitImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath, VkFormat imageFormat)
 {
 	if (!std::filesystem::exists(filePath))
 	{
@@ -126,14 +165,106 @@ void Texture::InitImage(VkDevice device, VkPhysicalDevice phyDevice, VkQueue que
 
 	m_Image.Initialize(device, phyDevice, texWidth, texHeight, imageFormat, imageTilling, imageUsage, imageProperties);
 
-	m_Image.TransitionImageLayout(device, cmndPl, queue, imageFormat, oldLayout, newerLayout);
-	m_Image.CopyBufferToImage(device, stagingBuffer, cmndPl, queue);
-	m_Image.TransitionImageLayout(device, cmndPl, queue, imageFormat, newerLayout, newestLayout);
+	m_Image.TransitionImageLayout(device, queue, imageFormat, oldLayout, newerLayout);
+	m_Image.CopyBufferToImage(device, stagingBuffer, queue);
+	m_Image.TransitionImageLayout(device, queue, imageFormat, newerLayout, newestLayout);
+
+	stagingBuffer.DeferDestroy();
+}
+
+bool Texture::InitCompressedImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath, VkFormat& imageFormat)
+{
+	if (!std::filesystem::exists(filePath) || !Ktx2File::IsKtx2File(filePath)) return false;
+
+	Ktx2File ktx2File{};
+	ktx2File.LoadFromFile(filePath);
+
+	if (!IsFormatSupported(phyDevice, ktx2File.GetVkFormat()))
+	{
+		std::cout << "Compressed texture format not supported, falling back to uncompressed: " << filePath << "\n";
+		return false;
+	}
+
+	imageFormat = ktx2File.GetVkFormat();
+
+	constexpr VkImageTiling imageTilling{ VK_IMAGE_TILING_OPTIMAL };
+	constexpr VkImageUsageFlags imageUsage{ VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT };
+	constexpr VkMemoryPropertyFlags imageProperties{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+
+	constexpr VkImageLayout oldLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+	constexpr VkImageLayout newerLayout{ VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL };
+	constexpr VkImageLayout newestLayout{ VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+	constexpr VkMemoryPropertyFlags stagingBufferProperties{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+	constexpr VkBufferUsageFlags stagingBufferUsage{ VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+
+	const uint32_t levelCount{ ktx2File.GetLevelCount() };
+
+	// Levels are stored smallest first and already block aligned, stage them as one contiguous range
+	uint64_t dataBegin{ UINT64_MAX };
+	uint64_t dataEnd{};
+	for (uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx)
+	{
+		const Ktx2File::Level& level{ ktx2File.GetLevel(levelIdx) };
+		dataBegin = std::min(dataBegin, level.byteOffset);
+		dataEnd = std::max(dataEnd, level.byteOffset + level.byteLength);
+	}
+
+	const VkDeviceSize dataSize{ dataEnd - dataBegin };
+
+	std::vector<VkBufferImageCopy> regions(levelCount);
+	for (uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx)
+	{
+		VkBufferImageCopy& region{ regions[levelIdx] };
+		region.bufferOffset = ktx2File.GetLevel(levelIdx).byteOffset - dataBegin;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = levelIdx;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent =
+		{
+			std::max(ktx2File.GetWidth() >> levelIdx, 1u),
+			std::max(ktx2File.GetHeight() >> levelIdx, 1u),
+			1
+		};
+	}
+
+	DataBuffer stagingBuffer{};
+	stagingBuffer.Initialize(device, phyDevice, stagingBufferProperties, dataSize, stagingBufferUsage);
+	stagingBuffer.Upload(device, dataSize, ktx2File.GetData().data() + dataBegin);
+
+	m_Image.Initialize(device, phyDevice, ktx2File.GetWidth(), ktx2File.GetHeight(), imageFormat, imageTilling, imageUsage, imageProperties, levelCount);
 
-	stagingBuffer.Destroy(device);
+	m_Image.TransitionImageLayout(device, queue, imageFormat, oldLayout, newerLayout);
+	m_Image.CopyBufferToImage(device, stagingBuffer, queue, regions);
+	m_Image.TransitionImageLayout(device, queue, imageFormat, newerLayout, newestLayout);
+
+	stagingBuffer.DeferDestroy();
+
+	return true;
 }
 
 void Texture::InitImageView(VkDevice device, VkFormat imageFormat)
 {
-	m_ImageView.Initialize(device, m_Image.GetVkImage(), imageFormat);
+	m_ImageView.Initialize(device, m_Image.GetVkImage(), imageFormat, VK_IMAGE_ASPECT_COLOR_BIT, m_Image.GetMipLevels());
+}
+
+std::string Texture::GetCookedFilePath(const std::string& filePath)
+{
+	return std::filesystem::path{ filePath }.replace_extension(".ktx2").string();
+}
+
+bool Texture::IsFormatSupported(VkPhysicalDevice phyDevice, VkFormat format)
+{
+	constexpr VkFormatFeatureFlags requiredFeatures{ VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT };
+
+	VkFormatProperties formatProperties{};
+	vkGetPhysicalDeviceFormatProperties(phyDevice, format, &formatProperties);
+
+	return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
 }
\ No newline at end of file
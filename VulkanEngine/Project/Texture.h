@@ -9,7 +9,7 @@
 #include "ImageView.h"
 #include "Sampler.h"
 
-class CommandPool;
+class Queue;
 class VulkanInstance;
 
 class Texture final
@@ -19,9 +19,10 @@ public:
 	Texture();
 	~Texture() = default;
 
-	void Initialize(const VulkanInstance& instance, const CommandPool& cmndPl, const std::string& filePath);
-	void Initialize(const VulkanInstance& instance, const CommandPool& cmndPl, const std::string& filePath, const Sampler& sampler);
+	void Initialize(const VulkanInstance& instance, const std::string& filePath);
+	void Initialize(const VulkanInstance& instance, const std::string& filePath, const Sampler& sampler);
 	void Destroy(VkDevice device);
+	void DeferDestroy();
 
 	const VkImage& GetVkImage() const;
 	const Image& GetImage() const;
@@ -30,16 +31,24 @@ public:
 	const VkSampler& GetVkSampler() const;
 	const Sampler& GetSampler() const;
 
+	// The block compressed file that is loaded instead of the source image when it exists
+	static std::string GetCookedFilePath(const std::string& filePath);
+
 private:
 
-	void InitImage(VkDevice device, VkPhysicalDevice phyDevice, VkQueue queue, const CommandPool& cmndPl, const std::string& filePath, VkFormat imageFormat);
+	VkFormat InitImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath);
+	void InitImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath, VkFormat imageFormat);
+	bool InitCompressedImage(VkDevice device, VkPhysicalDevice phyDevice, Queue& queue, const std::string& filePath, VkFormat& imageFormat);
 	void InitImageView(VkDevice device, VkFormat imageFormat);
 
+	static bool IsFormatSupported(VkPhysicalDevice phyDevice, VkFormat format);
+
 private:
 
 	Image m_Image;
 	ImageView m_ImageView;
 	Sampler m_TextureSampler;
+	bool m_OwnsSampler;
 
 };
 
@@ -0,0 +1,228 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "TextureTable.h"
+#include "Texture.h"
+#include "DeletionQueue.h"
+
+namespace
+{
+	constexpr uint32_t s_MaxTextureCount{ 4096 };
+}
+
+TextureTable::TextureTable()
+	: m_VkDescriptorSetLayout{ VK_NULL_HANDLE }
+	, m_VkDescriptorPool{ VK_NULL_HANDLE }
+	, m_VkDescriptorSet{ VK_NULL_HANDLE }
+	, m_Capacity{}
+	, m_DefaultImageInfo{}
+	, m_Slots{}
+	, m_SlotsByKey{}
+	, m_TextureCount{}
+	, m_FreeSlots{}
+	, m_FreeSlotMutex{}
+{
+}
+
+void TextureTable::Initialize(VkDevice device, VkPhysicalDevice phyDevice, const Texture& defaultTexture)
+{
+	m_Capacity = GetMaxTextureCount(phyDevice);
+
+	m_DefaultImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	m_DefaultImageInfo.imageView = defaultTexture.GetVkImageView();
+	m_DefaultImageInfo.sampler = defaultTexture.GetVkSampler();
+
+	VkDescriptorSetLayoutBinding textureBinding{};
+	textureBinding.binding = 0;
+	textureBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	textureBinding.descriptorCount = m_Capacity;
+	textureBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	// Unused slots are never sampled, and a slot is only rewritten once no pending frame can sample it
+	constexpr VkDescriptorBindingFlags bindingFlags
+	{
+		VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT
+	};
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{};
+	bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+	bindingFlagsInfo.bindingCount = 1;
+	bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+	VkDescriptorSetLayoutCreateInfo layoutInfo{};
+	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutInfo.pNext = &bindingFlagsInfo;
+	layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+	layoutInfo.bindingCount = 1;
+	layoutInfo.pBindings = &textureBinding;
+
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, VK_NULL_HANDLE, &m_VkDescriptorSetLayout) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create texture table descriptor set layout!" };
+	}
+
+	VkDescriptorPoolSize poolSize{};
+	poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	poolSize.descriptorCount = m_Capacity;
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+	poolInfo.poolSizeCount = 1;
+	poolInfo.pPoolSizes = &poolSize;
+	poolInfo.maxSets = 1;
+
+	if (vkCreateDescriptorPool(device, &poolInfo, VK_NULL_HANDLE, &m_VkDescriptorPool) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to create texture table descriptor pool!" };
+	}
+
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_VkDescriptorPool;
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &m_VkDescriptorSetLayout;
+
+	if (vkAllocateDescriptorSets(device, &allocInfo, &m_VkDescriptorSet) != VK_SUCCESS)
+	{
+		throw std::runtime_error{ "failed to allocate texture table descriptor set!" };
+	}
+}
+
+void TextureTable::Destroy(VkDevice device)
+{
+	// The set is freed with its pool
+	if (m_VkDescriptorPool != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorPool(device, m_VkDescriptorPool, nullptr);
+		m_VkDescriptorPool = VK_NULL_HANDLE;
+	}
+	m_VkDescriptorSet = VK_NULL_HANDLE;
+
+	if (m_VkDescriptorSetLayout != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorSetLayout(device, m_VkDescriptorSetLayout, nullptr);
+		m_VkDescriptorSetLayout = VK_NULL_HANDLE;
+	}
+
+	m_Slots.clear();
+	m_SlotsByKey.clear();
+	m_TextureCount = 0;
+
+	std::lock_guard<std::mutex> lock{ m_FreeSlotMutex };
+	m_FreeSlots.clear();
+}
+
+uint32_t TextureTable::AddTexture(VkDevice device, uint64_t key, const Texture& texture)
+{
+	if (const auto it{ m_SlotsByKey.find(key) }; it != m_SlotsByKey.end())
+	{
+		++m_Slots[it->second].userCount;
+		return it->second;
+	}
+
+	uint32_t slot{ static_cast<uint32_t>(m_Slots.size()) };
+	{
+		std::lock_guard<std::mutex> lock{ m_FreeSlotMutex };
+		if (!m_FreeSlots.empty())
+		{
+			slot = m_FreeSlots.back();
+			m_FreeSlots.pop_back();
+		}
+	}
+
+	if (slot == m_Slots.size())
+	{
+		if (m_Slots.size() >= m_Capacity) throw std::runtime_error{ "Texture table is full!" };
+		m_Slots.emplace_back(Slot{});
+	}
+
+	m_Slots[slot] = Slot{ key, 1 };
+	m_SlotsByKey.emplace(key, slot);
+	++m_TextureCount;
+
+	VkDescriptorImageInfo imageInfo{};
+	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	imageInfo.imageView = texture.GetVkImageView();
+	imageInfo.sampler = texture.GetVkSampler();
+	WriteDescriptor(device, slot, imageInfo);
+
+	return slot;
+}
+
+void TextureTable::RemoveTexture(uint32_t slot)
+{
+	if (slot >= m_Slots.size() || m_Slots[slot].userCount == 0) throw std::runtime_error{ "TextureTable: removed slot is not in use!" };
+
+	Slot& usedSlot{ m_Slots[slot] };
+	if (--usedSlot.userCount > 0) return;
+
+	m_SlotsByKey.erase(usedSlot.key);
+	--m_TextureCount;
+
+	// Frames that are still in flight may sample the slot, so it is only rewritten and reused once they finished
+	DeletionQueue::Get().Push([this, slot](VkDevice device) { FreeSlot(device, slot); });
+}
+
+VkDescriptorSetLayout TextureTable::GetVkDescriptorSetLayout() const
+{
+	return m_VkDescriptorSetLayout;
+}
+
+VkDescriptorSet TextureTable::GetVkDescriptorSet() const
+{
+	return m_VkDescriptorSet;
+}
+
+uint32_t TextureTable::GetTextureCount() const
+{
+	return m_TextureCount;
+}
+
+// Private Functions //
+void TextureTable::WriteDescriptor(VkDevice device, uint32_t slot, const VkDescriptorImageInfo& imageInfo) const
+{
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = m_VkDescriptorSet;
+	descriptorWrite.dstBinding = 0;
+	descriptorWrite.dstArrayElement = slot;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
+
+	vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, VK_NULL_HANDLE);
+}
+
+void TextureTable::FreeSlot(VkDevice device, uint32_t slot)
+{
+	// The table may have been destroyed while the slot waited on the gpu
+	if (m_VkDescriptorSet == VK_NULL_HANDLE) return;
+
+	// A stale material index samples the default texture instead of a destroyed image
+	WriteDescriptor(device, slot, m_DefaultImageInfo);
+
+	std::lock_guard<std::mutex> lock{ m_FreeSlotMutex };
+	m_FreeSlots.emplace_back(slot);
+}
+
+uint32_t TextureTable::GetMaxTextureCount(VkPhysicalDevice phyDevice)
+{
+	VkPhysicalDeviceVulkan12Properties vulkan12Properties{};
+	vulkan12Properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+	VkPhysicalDeviceProperties2 properties2{};
+	properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+	properties2.pNext = &vulkan12Properties;
+	vkGetPhysicalDeviceProperties2(phyDevice, &properties2);
+
+	// A combined image sampler counts against both the sampled image and the sampler limits
+	return std::min
+	({
+		s_MaxTextureCount,
+		vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		vulkan12Properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+		vulkan12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+		vulkan12Properties.maxDescriptorSetUpdateAfterBindSamplers
+	});
+}
\ No newline at end of file
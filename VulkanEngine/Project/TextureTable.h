@@ -0,0 +1,73 @@
+#ifndef TEXTURETABLE_H
+#define TEXTURETABLE_H
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdint>
+
+#include <vulkan/vulkan.h>
+
+class Texture;
+
+// Bindless texture array: every texture lives in one descriptor set that is bound once, shaders pick their texture with a material index.
+// The set is update after bind and partially bound, so textures can be added to free slots while frames using the set are in flight.
+// Slots are keyed by the asset registry key of their texture, a removed texture's slot is reused once the gpu is done with it.
+class TextureTable final
+{
+public:
+
+	TextureTable();
+	~TextureTable() = default;
+
+	TextureTable(const TextureTable& other) = delete;
+	TextureTable(TextureTable&& other) noexcept = delete;
+	TextureTable& operator=(const TextureTable& other) = delete;
+	TextureTable& operator=(TextureTable&& other) noexcept = delete;
+
+	// Freed slots are pointed at the default texture, it has to stay alive until the table is destroyed
+	void Initialize(VkDevice device, VkPhysicalDevice phyDevice, const Texture& defaultTexture);
+	void Destroy(VkDevice device);
+
+	// Returns the slot of the texture, a key that is already in the table keeps its slot and gets one more user
+	uint32_t AddTexture(VkDevice device, uint64_t key, const Texture& texture);
+	// Drops one user of the slot. After the last one the slot samples the default texture and is reused once the submitted frames finished.
+	void RemoveTexture(uint32_t slot);
+
+	VkDescriptorSetLayout GetVkDescriptorSetLayout() const;
+	VkDescriptorSet GetVkDescriptorSet() const;
+	uint32_t GetTextureCount() const;
+
+private:
+
+	struct Slot
+	{
+		uint64_t key{};
+		uint32_t userCount{};
+	};
+
+	void WriteDescriptor(VkDevice device, uint32_t slot, const VkDescriptorImageInfo& imageInfo) const;
+	void FreeSlot(VkDevice device, uint32_t slot);
+
+	static uint32_t GetMaxTextureCount(VkPhysicalDevice phyDevice);
+
+private:
+
+	VkDescriptorSetLayout m_VkDescriptorSetLayout;
+	VkDescriptorPool m_VkDescriptorPool;
+	VkDescriptorSet m_VkDescriptorSet;
+
+	uint32_t m_Capacity;
+	VkDescriptorImageInfo m_DefaultImageInfo;
+
+	std::vector<Slot> m_Slots;
+	std::unordered_map<uint64_t, uint32_t> m_SlotsByKey;
+	uint32_t m_TextureCount;
+
+	// Filled by the deletion queue, which flushes on a worker thread
+	std::vector<uint32_t> m_FreeSlots;
+	std::mutex m_FreeSlotMutex;
+
+};
+
+#endif // !TEXTURETABLE_H
\ No newline at end of file
@@ -0,0 +1,408 @@
+#include <stdexcept>
+#include <algorithm>
+
+#include "TransformSoA.h"
+#include "JobSystem.h"
+
+// 8 instances per instruction with AVX2, two halves of 4 with SSE, one by one elsewhere
+#if defined(__AVX2__)
+#define TRANSFORMSOA_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORMSOA_SSE
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+	// Below this many dirty blocks the job overhead outweighs the work
+	constexpr uint32_t s_ParallelBlockThreshold{ 256 };
+	constexpr uint32_t s_BlocksPerJob{ 128 };
+
+	// Component pointers of the first instance of a block
+	struct BlockInput
+	{
+		const float* pPositionX;
+		const float* pPositionY;
+		const float* pPositionZ;
+		const float* pRotationX;
+		const float* pRotationY;
+		const float* pRotationZ;
+		const float* pRotationW;
+		const float* pScaleX;
+		const float* pScaleY;
+		const float* pScaleZ;
+	};
+
+	// The rotation columns of a unit quaternion scaled by the matching scale axis, translation in the last column.
+	// Same result as translate * mat4_cast * scale without the general 4x4 multiplies.
+#if defined(TRANSFORMSOA_AVX2)
+
+	void ComposeMatrices(const BlockInput& input, ModelUBO* pMatrices)
+	{
+		const __m256 zero{ _mm256_setzero_ps() };
+		const __m256 one{ _mm256_set1_ps(1.f) };
+		const __m256 two{ _mm256_set1_ps(2.f) };
+
+		const __m256 x{ _mm256_loadu_ps(input.pRotationX) };
+		const __m256 y{ _mm256_loadu_ps(input.pRotationY) };
+		const __m256 z{ _mm256_loadu_ps(input.pRotationZ) };
+		const __m256 w{ _mm256_loadu_ps(input.pRotationW) };
+
+		const __m256 sx{ _mm256_loadu_ps(input.pScaleX) };
+		const __m256 sy{ _mm256_loadu_ps(input.pScaleY) };
+		const __m256 sz{ _mm256_loadu_ps(input.pScaleZ) };
+
+		const __m256 xx{ _mm256_mul_ps(x, x) };
+		const __m256 yy{ _mm256_mul_ps(y, y) };
+		const __m256 zz{ _mm256_mul_ps(z, z) };
+		const __m256 xy{ _mm256_mul_ps(x, y) };
+		const __m256 xz{ _mm256_mul_ps(x, z) };
+		const __m256 yz{ _mm256_mul_ps(y, z) };
+		const __m256 wx{ _mm256_mul_ps(w, x) };
+		const __m256 wy{ _mm256_mul_ps(w, y) };
+		const __m256 wz{ _mm256_mul_ps(w, z) };
+
+		// Components of the matrices in column major order, one instance per lane
+		__m256 rows[8]
+		{
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+			zero,
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+			zero
+		};
+		__m256 lastRows[8]
+		{
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+			_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+			zero,
+			_mm256_loadu_ps(input.pPositionX),
+			_mm256_loadu_ps(input.pPositionY),
+			_mm256_loadu_ps(input.pPositionZ),
+			one
+		};
+
+		// An 8x8 transpose turns the lanes into the first and the last 8 floats of every instance's matrix
+		const auto transpose{ [](__m256* pRows)
+		{
+			const __m256 t0{ _mm256_unpacklo_ps(pRows[0], pRows[1]) };
+			const __m256 t1{ _mm256_unpackhi_ps(pRows[0], pRows[1]) };
+			const __m256 t2{ _mm256_unpacklo_ps(pRows[2], pRows[3]) };
+			const __m256 t3{ _mm256_unpackhi_ps(pRows[2], pRows[3]) };
+			const __m256 t4{ _mm256_unpacklo_ps(pRows[4], pRows[5]) };
+			const __m256 t5{ _mm256_unpackhi_ps(pRows[4], pRows[5]) };
+			const __m256 t6{ _mm256_unpacklo_ps(pRows[6], pRows[7]) };
+			const __m256 t7{ _mm256_unpackhi_ps(pRows[6], pRows[7]) };
+
+			const __m256 s0{ _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)) };
+			const __m256 s1{ _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)) };
+			const __m256 s2{ _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)) };
+			const __m256 s3{ _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2)) };
+			const __m256 s4{ _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0)) };
+			const __m256 s5{ _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2)) };
+			const __m256 s6{ _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0)) };
+			const __m256 s7{ _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2)) };
+
+			pRows[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+			pRows[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+			pRows[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+			pRows[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+			pRows[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+			pRows[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+			pRows[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+			pRows[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+		} };
+
+		transpose(rows);
+		transpose(lastRows);
+
+		for (uint32_t lane{}; lane < TransformSoA::s_BlockSize; ++lane)
+		{
+			float* pMatrix{ &pMatrices[lane].model[0][0] };
+			_mm256_storeu_ps(pMatrix, rows[lane]);
+			_mm256_storeu_ps(pMatrix + 8, lastRows[lane]);
+		}
+	}
+
+#elif defined(TRANSFORMSOA_SSE)
+
+	void ComposeMatrices(const BlockInput& input, ModelUBO* pMatrices)
+	{
+		const __m128 zero{ _mm_setzero_ps() };
+		const __m128 one{ _mm_set1_ps(1.f) };
+		const __m128 two{ _mm_set1_ps(2.f) };
+
+		for (uint32_t half{}; half < TransformSoA::s_BlockSize; half += 4)
+		{
+			const __m128 x{ _mm_loadu_ps(input.pRotationX + half) };
+			const __m128 y{ _mm_loadu_ps(input.pRotationY + half) };
+			const __m128 z{ _mm_loadu_ps(input.pRotationZ + half) };
+			const __m128 w{ _mm_loadu_ps(input.pRotationW + half) };
+
+			const __m128 sx{ _mm_loadu_ps(input.pScaleX + half) };
+			const __m128 sy{ _mm_loadu_ps(input.pScaleY + half) };
+			const __m128 sz{ _mm_loadu_ps(input.pScaleZ + half) };
+
+			const __m128 xx{ _mm_mul_ps(x, x) };
+			const __m128 yy{ _mm_mul_ps(y, y) };
+			const __m128 zz{ _mm_mul_ps(z, z) };
+			const __m128 xy{ _mm_mul_ps(x, y) };
+			const __m128 xz{ _mm_mul_ps(x, z) };
+			const __m128 yz{ _mm_mul_ps(y, z) };
+			const __m128 wx{ _mm_mul_ps(w, x) };
+			const __m128 wy{ _mm_mul_ps(w, y) };
+			const __m128 wz{ _mm_mul_ps(w, z) };
+
+			// Every column of 4 components is transposed into 4 floats of each of the 4 matrices
+			__m128 columns[4][4]
+			{
+				{
+					_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+					_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+					_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+					zero
+				},
+				{
+					_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+					_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+					_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+					zero
+				},
+				{
+					_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+					_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+					_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+					zero
+				},
+				{
+					_mm_loadu_ps(input.pPositionX + half),
+					_mm_loadu_ps(input.pPositionY + half),
+					_mm_loadu_ps(input.pPositionZ + half),
+					one
+				}
+			};
+
+			for (uint32_t column{}; column < 4; ++column)
+			{
+				__m128* pColumn{ columns[column] };
+				_MM_TRANSPOSE4_PS(pColumn[0], pColumn[1], pColumn[2], pColumn[3]);
+
+				for (uint32_t lane{}; lane < 4; ++lane)
+				{
+					_mm_storeu_ps(&pMatrices[half + lane].model[column][0], pColumn[lane]);
+				}
+			}
+		}
+	}
+
+#else
+
+	void ComposeMatrices(const BlockInput& input, ModelUBO* pMatrices)
+	{
+		for (uint32_t lane{}; lane < TransformSoA::s_BlockSize; ++lane)
+		{
+			const float x{ input.pRotationX[lane] };
+			const float y{ input.pRotationY[lane] };
+			const float z{ input.pRotationZ[lane] };
+			const float w{ input.pRotationW[lane] };
+
+			const float sx{ input.pScaleX[lane] };
+			const float sy{ input.pScaleY[lane] };
+			const float sz{ input.pScaleZ[lane] };
+
+			glm::mat4& model{ pMatrices[lane].model };
+			model[0] = glm::vec4{ (1.f - 2.f * (y * y + z * z)) * sx, 2.f * (x * y + w * z) * sx, 2.f * (x * z - w * y) * sx, 0.f };
+			model[1] = glm::vec4{ 2.f * (x * y - w * z) * sy, (1.f - 2.f * (x * x + z * z)) * sy, 2.f * (y * z + w * x) * sy, 0.f };
+			model[2] = glm::vec4{ 2.f * (x * z + w * y) * sz, 2.f * (y * z - w * x) * sz, (1.f - 2.f * (x * x + y * y)) * sz, 0.f };
+			model[3] = glm::vec4{ input.pPositionX[lane], input.pPositionY[lane], input.pPositionZ[lane], 1.f };
+		}
+	}
+
+#endif
+}
+
+TransformSoA::TransformSoA()
+	: m_Count{}
+	, m_PositionX{}
+	, m_PositionY{}
+	, m_PositionZ{}
+	, m_RotationX{}
+	, m_RotationY{}
+	, m_RotationZ{}
+	, m_RotationW{}
+	, m_ScaleX{}
+	, m_ScaleY{}
+	, m_ScaleZ{}
+	, m_BlockDirty{}
+	, m_DirtyBlocks{}
+{
+}
+
+void TransformSoA::Resize(uint32_t count)
+{
+	const uint32_t blockCount{ (count + s_BlockSize - 1) / s_BlockSize };
+	const size_t paddedCount{ size_t{ blockCount } * s_BlockSize };
+
+	m_Count = count;
+
+	m_PositionX.resize(paddedCount, 0.f);
+	m_PositionY.resize(paddedCount, 0.f);
+	m_PositionZ.resize(paddedCount, 0.f);
+
+	m_RotationX.resize(paddedCount, 0.f);
+	m_RotationY.resize(paddedCount, 0.f);
+	m_RotationZ.resize(paddedCount, 0.f);
+	m_RotationW.resize(paddedCount, 1.f);
+
+	m_ScaleX.resize(paddedCount, 1.f);
+	m_ScaleY.resize(paddedCount, 1.f);
+	m_ScaleZ.resize(paddedCount, 1.f);
+
+	m_BlockDirty.assign(blockCount, 1);
+
+	// Padding lanes of a shrunk last block may still hold a removed instance
+	for (uint32_t index{ count }; index < paddedCount; ++index)
+	{
+		SetTransform(index, Transform3D{});
+	}
+
+	m_DirtyBlocks.resize(blockCount);
+	for (uint32_t blockIdx{}; blockIdx < blockCount; ++blockIdx)
+	{
+		m_DirtyBlocks[blockIdx] = blockIdx;
+	}
+}
+
+void TransformSoA::Clear()
+{
+	m_Count = 0;
+
+	m_PositionX.clear();
+	m_PositionY.clear();
+	m_PositionZ.clear();
+
+	m_RotationX.clear();
+	m_RotationY.clear();
+	m_RotationZ.clear();
+	m_RotationW.clear();
+
+	m_ScaleX.clear();
+	m_ScaleY.clear();
+	m_ScaleZ.clear();
+
+	m_BlockDirty.clear();
+	m_DirtyBlocks.clear();
+}
+
+void TransformSoA::SetPosition(uint32_t index, const glm::vec3& position)
+{
+	m_PositionX[index] = position.x;
+	m_PositionY[index] = position.y;
+	m_PositionZ[index] = position.z;
+	MarkDirty(index);
+}
+
+void TransformSoA::SetRotation(uint32_t index, const glm::quat& rotation)
+{
+	m_RotationX[index] = rotation.x;
+	m_RotationY[index] = rotation.y;
+	m_RotationZ[index] = rotation.z;
+	m_RotationW[index] = rotation.w;
+	MarkDirty(index);
+}
+
+void TransformSoA::SetScale(uint32_t index, const glm::vec3& scale)
+{
+	m_ScaleX[index] = scale.x;
+	m_ScaleY[index] = scale.y;
+	m_ScaleZ[index] = scale.z;
+	MarkDirty(index);
+}
+
+void TransformSoA::SetTransform(uint32_t index, const Transform3D& transform)
+{
+	SetPosition(index, transform.position);
+	SetRotation(index, transform.rotation);
+	SetScale(index, transform.scale);
+}
+
+Transform3D TransformSoA::GetTransform(uint32_t index) const
+{
+	Transform3D transform{};
+	transform.position = glm::vec3{ m_PositionX[index], m_PositionY[index], m_PositionZ[index] };
+	transform.rotation = glm::quat{ m_RotationW[index], m_RotationX[index], m_RotationY[index], m_RotationZ[index] };
+	transform.scale = glm::vec3{ m_ScaleX[index], m_ScaleY[index], m_ScaleZ[index] };
+	return transform;
+}
+
+uint32_t TransformSoA::GetCount() const
+{
+	return m_Count;
+}
+
+uint32_t TransformSoA::GetPaddedCount() const
+{
+	return static_cast<uint32_t>(m_PositionX.size());
+}
+
+bool TransformSoA::IsDirty() const
+{
+	return !m_DirtyBlocks.empty();
+}
+
+bool TransformSoA::UpdateMatrices(std::span<ModelUBO> matrices, JobSystem* pJobSystem)
+{
+	if (m_DirtyBlocks.empty()) return false;
+	if (matrices.size() < GetPaddedCount()) throw std::runtime_error{ "TransformSoA: matrix output smaller than the padded instance count!" };
+
+	ModelUBO* pMatrices{ matrices.data() };
+	const uint32_t dirtyBlockCount{ static_cast<uint32_t>(m_DirtyBlocks.size()) };
+
+	const auto composeRange{ [this, pMatrices](uint32_t begin, uint32_t end)
+	{
+		for (uint32_t dirtyIdx{ begin }; dirtyIdx < end; ++dirtyIdx)
+		{
+			ComposeBlock(m_DirtyBlocks[dirtyIdx], pMatrices);
+		}
+	} };
+
+	if (pJobSystem && dirtyBlockCount >= s_ParallelBlockThreshold) pJobSystem->ParallelFor(dirtyBlockCount, s_BlocksPerJob, composeRange);
+	else composeRange(0, dirtyBlockCount);
+
+	for (uint32_t blockIdx : m_DirtyBlocks)
+	{
+		m_BlockDirty[blockIdx] = 0;
+	}
+	m_DirtyBlocks.clear();
+
+	return true;
+}
+
+// Private Functions //
+void TransformSoA::MarkDirty(uint32_t index)
+{
+	const uint32_t blockIdx{ index / s_BlockSize };
+	if (m_BlockDirty[blockIdx]) return;
+
+	m_BlockDirty[blockIdx] = 1;
+	m_DirtyBlocks.emplace_back(blockIdx);
+}
+
+void TransformSoA::ComposeBlock(uint32_t blockIdx, ModelUBO* pMatrices) const
+{
+	const size_t first{ size_t{ blockIdx } * s_BlockSize };
+
+	const BlockInput input
+	{
+		&m_PositionX[first], &m_PositionY[first], &m_PositionZ[first],
+		&m_RotationX[first], &m_RotationY[first], &m_RotationZ[first], &m_RotationW[first],
+		&m_ScaleX[first], &m_ScaleY[first], &m_ScaleZ[first]
+	};
+
+	ComposeMatrices(input, pMatrices + first);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#ifndef TRANSFORMSOA_H
+#define TRANSFORMSOA_H
+
+#include <vector>
+#include <span>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "VulkanStructs.h"
+
+class JobSystem;
+
+// Position, rotation and scale of many instances stored as one array per component. Setters only mark the block
+// of the instance dirty, UpdateMatrices composes the model matrices of every dirty block in one batch, 8 instances at a time.
+class TransformSoA final
+{
+public:
+
+	static constexpr uint32_t s_BlockSize{ 8 };
+
+	TransformSoA();
+	~TransformSoA() = default;
+
+	TransformSoA(const TransformSoA& other) = default;
+	TransformSoA(TransformSoA&& other) noexcept = default;
+	TransformSoA& operator=(const TransformSoA& other) = default;
+	TransformSoA& operator=(TransformSoA&& other) noexcept = default;
+
+	// New instances start at the identity transform, every instance is dirty afterwards
+	void Resize(uint32_t count);
+	void Clear();
+
+	void SetPosition(uint32_t index, const glm::vec3& position);
+	void SetRotation(uint32_t index, const glm::quat& rotation);
+	void SetScale(uint32_t index, const glm::vec3& scale);
+	void SetTransform(uint32_t index, const Transform3D& transform);
+
+	Transform3D GetTransform(uint32_t index) const;
+
+	uint32_t GetCount() const;
+	// Instance count rounded up to whole blocks, the size the matrix output needs
+	uint32_t GetPaddedCount() const;
+	bool IsDirty() const;
+
+	// Writes the model matrix of every instance in a dirty block and clears the dirty state, returns false when nothing was dirty.
+	// Large batches are split over the job system when one is given.
+	bool UpdateMatrices(std::span<ModelUBO> matrices, JobSystem* pJobSystem = nullptr);
+
+private:
+
+	void MarkDirty(uint32_t index);
+	void ComposeBlock(uint32_t blockIdx, ModelUBO* pMatrices) const;
+
+private:
+
+	uint32_t m_Count;
+
+	std::vector<float> m_PositionX;
+	std::vector<float> m_PositionY;
+	std::vector<float> m_PositionZ;
+
+	std::vector<float> m_RotationX;
+	std::vector<float> m_RotationY;
+	std::vector<float> m_RotationZ;
+	std::vector<float> m_RotationW;
+
+	std::vector<float> m_ScaleX;
+	std::vector<float> m_ScaleY;
+	std::vector<float> m_ScaleZ;
+
+	std::vector<uint8_t> m_BlockDirty;
+	std::vector<uint32_t> m_DirtyBlocks;
+
+};
+
+#endif // !TRANSFORMSOA_H
\ No newline at end of file
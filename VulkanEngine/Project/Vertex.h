@@ -1,3 +1,6 @@
+#ifndef VERTEX_H
+#define VERTEX_H
+
 #include <array>
 
 #include <vulkan/vulkan.h>
@@ -6,6 +9,8 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 
+#include "VulkanStructs.h"
+
 struct Vertex2D
 {
 	glm::vec2 pos{};
@@ -41,6 +46,13 @@ struct Vertex3DIR
 	}
 };
 
+enum class VertexType
+{
+	Vertex2D,
+	Vertex3D,
+	Vertex3DIR
+};
+
 namespace std
 {
 	template<>
@@ -126,7 +138,8 @@ namespace Descriptions
 	}
 
 	// 3D //
-	using BindingDescriptions3D = std::array<VkVertexInputBindingDescription, 1>;
+	// Model3D draws are instanced as well, their matrices come from the per frame instance stream
+	using BindingDescriptions3D = std::array<VkVertexInputBindingDescription, 2>;
 	static BindingDescriptions3D Get3DBindingDescriptions()
 	{
 		BindingDescriptions3D bindingDescription{};
@@ -135,10 +148,14 @@ namespace Descriptions
 		bindingDescription[0].stride = sizeof(Vertex3D);
 		bindingDescription[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
+		bindingDescription[1].binding = 1;
+		bindingDescription[1].stride = sizeof(InstanceData);
+		bindingDescription[1].inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
 		return bindingDescription;
 	}
 
-	using AttributeDescriptions3D = std::array<VkVertexInputAttributeDescription, 3>;
+	using AttributeDescriptions3D = std::array<VkVertexInputAttributeDescription, 8>;
 	static AttributeDescriptions3D Get3DAttributeDescriptions()
 	{
 		AttributeDescriptions3D attributeDescriptions{};
@@ -158,6 +175,20 @@ namespace Descriptions
 		attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
 		attributeDescriptions[2].offset = offsetof(Vertex3D, texCoord);
 
+		for (size_t matrixVectorIdx{}; matrixVectorIdx < 4; ++matrixVectorIdx)
+		{
+			const size_t index{ 3 + matrixVectorIdx };
+			attributeDescriptions[index].binding = 1;
+			attributeDescriptions[index].location = static_cast<uint32_t>(index);
+			attributeDescriptions[index].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+			attributeDescriptions[index].offset = static_cast<uint32_t>(offsetof(InstanceData, model) + matrixVectorIdx * sizeof(glm::vec4));
+		}
+
+		attributeDescriptions[7].binding = 1;
+		attributeDescriptions[7].location = 7;
+		attributeDescriptions[7].format = VK_FORMAT_R32_UINT;
+		attributeDescriptions[7].offset = offsetof(InstanceData, material);
+
 		return attributeDescriptions;
 	}
 
@@ -213,4 +244,6 @@ namespace Descriptions
 
 		return attributeDescriptions;
 	}
-}
\ No newline at end of file
+}
+
+#endif // !VERTEX_H
\ No newline at end of file
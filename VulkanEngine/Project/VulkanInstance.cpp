@@ -1,6 +1,8 @@
 #include <set>
+#include <map>
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 #define VK_USE_PLATFORM_WIN32_KHR
 #define GLFW_INCLUDE_VULKAN
@@ -11,18 +13,22 @@
 #include "VulkanInstance.h"
 
 #include "VulkanUtils.h"
+#include "DeviceFunctions.h"
 
 const std::vector<const char*> VulkanInstance::s_DeviceExtensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 const std::vector<const char*> VulkanInstance::s_ValidationLayers{ "VK_LAYER_KHRONOS_validation" };
 
 const std::string VulkanInstance::s_AppName{ "VulkanApplication" };
 const std::string VulkanInstance::s_EngineName{ "MorrogEngine" };
+const std::string VulkanInstance::s_PipelineCacheFilePath{ "pipeline_cache.bin" };
 
 void VulkanInstance::Initialize(GLFWwindow* window)
 {
 	CreateVulkanInstance();
 	CreateSurface(window);
 	CreateDevices();
+
+	m_PipelineCache.Initialize(m_VkDevice, m_VkPhysicalDevice, s_PipelineCacheFilePath);
 }
 
 void VulkanInstance::Destroy()
@@ -30,6 +36,12 @@ void VulkanInstance::Destroy()
 	// Devices
 	if (m_VkDevice != VK_NULL_HANDLE)
 	{
+		m_PipelineCache.Destroy(m_VkDevice);
+
+		for (std::unique_ptr<Queue>& pQueue : m_Queues) pQueue->Destroy(m_VkDevice);
+		m_Queues.clear();
+		m_pQueues.fill(nullptr);
+
 		vkDestroyDevice(m_VkDevice, VK_NULL_HANDLE);
 		m_VkDevice = VK_NULL_HANDLE;
 	}
@@ -78,12 +90,22 @@ const VkPhysicalDevice& VulkanInstance::GetVkPhysicalDevice() const
 
 const VkQueue& VulkanInstance::GetGraphicsQueue() const
 {
-	return m_GraphicsVkQueue;
+	return GetQueue(QueueType::Graphics).GetVkQueue();
 }
 
 const VkQueue& VulkanInstance::GetPresentQueue() const
 {
-	return m_PresentVkQueue;
+	return GetQueue(QueueType::Present).GetVkQueue();
+}
+
+Queue& VulkanInstance::GetQueue(QueueType queueType) const
+{
+	return *m_pQueues[static_cast<size_t>(queueType)];
+}
+
+bool VulkanInstance::IsDynamicRenderingSupported() const
+{
+	return m_DynamicRenderingSupported;
 }
 
 VkResult VulkanInstance::DeviceWaitIdle()
@@ -91,6 +113,16 @@ VkResult VulkanInstance::DeviceWaitIdle()
 	return vkDeviceWaitIdle(m_VkDevice);
 }
 
+const PipelineCache& VulkanInstance::GetPipelineCache() const
+{
+	return m_PipelineCache;
+}
+
+const VkPipelineCache& VulkanInstance::GetVkPipelineCache() const
+{
+	return m_PipelineCache.GetVkPipelineCache();
+}
+
 void VulkanInstance::SetupDebugMessenger()
 {
 	if (!m_ValidationLayersEnabled) return;
@@ -176,6 +208,20 @@ bool VulkanInstance::CheckDeviceExtensionSupport(VkPhysicalDevice device)
 	return requiredExtensions.empty();
 }
 
+bool VulkanInstance::IsDeviceExtensionSupported(VkPhysicalDevice device, const char* extensionName)
+{
+	uint32_t extensionCount{};
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+
+	std::vector<VkExtensionProperties> availableExtensions{ extensionCount };
+	vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+
+	return std::any_of(availableExtensions.begin(), availableExtensions.end(), [extensionName](const VkExtensionProperties& extension)
+		{
+			return std::string{ extension.extensionName } == extensionName;
+		});
+}
+
 SwapChainSupportDetails VulkanInstance::QuerySwapChainSupport(VkPhysicalDevice phyDevice) const
 {
 	if (phyDevice == VK_NULL_HANDLE)
@@ -231,25 +277,47 @@ QueueFamilyIndices VulkanInstance::FindQueueFamilies(VkPhysicalDevice phyDevice)
 
 	const VkSurfaceKHR& surface{ m_Surface.GetVkSurface() };
 
-	int idx{ 0 };
-	for (const auto& queueFamily : queueFamilies)
+	bool hasTransferOnlyFamily{ false };
+	for (uint32_t idx{}; idx < queueFamilyCount; ++idx)
 	{
-		if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
-		{
-			indices.graphicsFamily = idx;
-		}
+		const VkQueueFlags queueFlags{ queueFamilies[idx].queueFlags };
 
 		VkBool32 presentSupport{ false };
 		vkGetPhysicalDeviceSurfaceSupportKHR(phyDevice, idx, surface, &presentSupport);
 
-		if (presentSupport)
+		if ((queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphicsFamily.has_value())
+		{
+			indices.graphicsFamily = idx;
+		}
+
+		// Presenting from the graphics family avoids a semaphore handoff between queues
+		if (presentSupport && (!indices.presentFamily.has_value() || ((queueFlags & VK_QUEUE_GRAPHICS_BIT) && indices.graphicsFamily == idx)))
 		{
 			indices.presentFamily = idx;
 		}
 
-		if (indices.IsComplete()) break;
+		if (!(queueFlags & VK_QUEUE_GRAPHICS_BIT))
+		{
+			// A transfer only family maps to the copy engine, prefer it over a compute family that can transfer
+			const bool transferOnly{ !(queueFlags & VK_QUEUE_COMPUTE_BIT) };
+			if ((queueFlags & VK_QUEUE_TRANSFER_BIT) && (!indices.transferFamily.has_value() || (transferOnly && !hasTransferOnlyFamily)))
+			{
+				indices.transferFamily = idx;
+				hasTransferOnlyFamily = transferOnly;
+			}
 
-		idx++;
+			if ((queueFlags & VK_QUEUE_COMPUTE_BIT) && !indices.computeFamily.has_value())
+			{
+				indices.computeFamily = idx;
+			}
+		}
+	}
+
+	// Devices without dedicated families run transfer and compute work on the graphics family
+	if (indices.graphicsFamily.has_value())
+	{
+		if (!indices.transferFamily.has_value()) indices.transferFamily = indices.graphicsFamily;
+		if (!indices.computeFamily.has_value()) indices.computeFamily = indices.graphicsFamily;
 	}
 
 	return indices;
@@ -273,7 +341,7 @@ void VulkanInstance::CreateVulkanInstance()
 	appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 	appInfo.pEngineName = s_EngineName.c_str(); //"MorrogEngine"
 	appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-	appInfo.apiVersion = VK_API_VERSION_1_0;
+	appInfo.apiVersion = VK_API_VERSION_1_3; // Highest version the engine uses, 1.2 devices get the 1.3 features from extensions
 
 	VkInstanceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -367,38 +435,120 @@ void VulkanInstance::CreateLogicDevice()
 {
 	QueueFamilyIndices indices{ FindQueueFamilies(m_VkPhysicalDevice) };
 
-	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
-	std::set<uint32_t> uniqueQueueFamilies{ indices.graphicsFamily.value(), indices.presentFamily.value() };
+	uint32_t queueFamilyCount{ 0 };
+	vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &queueFamilyCount, nullptr);
+
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(m_VkPhysicalDevice, &queueFamilyCount, queueFamilies.data());
 
-	float queuePriority{ 1.f };
-	for (uint32_t queueFamily : uniqueQueueFamilies)
+	// Every queue type gets its own queue while its family has one left, otherwise it shares the last one
+	std::map<uint32_t, uint32_t> familyQueueCounts{};
+	const auto reserveQueue{ [&](uint32_t family) -> std::pair<uint32_t, uint32_t>
+		{
+			uint32_t& queueCount{ familyQueueCounts[family] };
+			if (queueCount < queueFamilies[family].queueCount) return { family, queueCount++ };
+			return { family, queueCount - 1 };
+		} };
+
+	std::array<std::pair<uint32_t, uint32_t>, 4> queueSlots{};
+	queueSlots[static_cast<size_t>(QueueType::Graphics)] = reserveQueue(indices.graphicsFamily.value());
+	queueSlots[static_cast<size_t>(QueueType::Present)] = indices.presentFamily == indices.graphicsFamily
+		? queueSlots[static_cast<size_t>(QueueType::Graphics)]
+		: reserveQueue(indices.presentFamily.value());
+	queueSlots[static_cast<size_t>(QueueType::Transfer)] = reserveQueue(indices.transferFamily.value());
+	queueSlots[static_cast<size_t>(QueueType::Compute)] = reserveQueue(indices.computeFamily.value());
+
+	std::map<uint32_t, std::vector<float>> queuePriorities{};
+	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+	for (const auto& [queueFamily, queueCount] : familyQueueCounts)
 	{
+		std::vector<float>& priorities{ queuePriorities[queueFamily] };
+		priorities.assign(queueCount, 1.f);
+
 		VkDeviceQueueCreateInfo queueCreateInfo{};
 		queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
 		queueCreateInfo.queueFamilyIndex = queueFamily;
-		queueCreateInfo.queueCount = 1;
-		queueCreateInfo.pQueuePriorities = &queuePriority;
+		queueCreateInfo.queueCount = queueCount;
+		queueCreateInfo.pQueuePriorities = priorities.data();
 		queueCreateInfos.push_back(queueCreateInfo);
 	}
 
-	VkDeviceQueueCreateInfo queueCreateInfo{};
-	queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-	queueCreateInfo.queueFamilyIndex = indices.graphicsFamily.value();
-	queueCreateInfo.queueCount = 1;
+	VkPhysicalDeviceFeatures supportedFeatures{};
+	vkGetPhysicalDeviceFeatures(m_VkPhysicalDevice, &supportedFeatures);
 
 	VkPhysicalDeviceFeatures deviceFeatures{};
 	deviceFeatures.samplerAnisotropy = VK_TRUE;
+	deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC; // Cooked ktx2 textures
+	deviceFeatures.fillModeNonSolid = supportedFeatures.fillModeNonSolid; // Wireframe pipeline variants
+
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(m_VkPhysicalDevice, &properties);
+	const bool isVulkan13{ properties.apiVersion >= VK_API_VERSION_1_3 };
+
+	// Dynamic rendering is optional, core in 1.3 and probed through its extension on a 1.2 device
+	const bool hasDynamicRenderingExtension{ !isVulkan13 && IsDeviceExtensionSupported(m_VkPhysicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) };
+
+	VkPhysicalDeviceVulkan13Features supportedVulkan13Features{};
+	supportedVulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+	VkPhysicalDeviceDynamicRenderingFeatures supportedDynamicRenderingFeatures{};
+	supportedDynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+
+	VkPhysicalDeviceFeatures2 supportedFeatures2{};
+	supportedFeatures2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+	if (isVulkan13) supportedFeatures2.pNext = &supportedVulkan13Features;
+	else if (hasDynamicRenderingExtension) supportedFeatures2.pNext = &supportedDynamicRenderingFeatures;
+	vkGetPhysicalDeviceFeatures2(m_VkPhysicalDevice, &supportedFeatures2);
+	m_DynamicRenderingSupported = isVulkan13 ? supportedVulkan13Features.dynamicRendering : supportedDynamicRenderingFeatures.dynamicRendering;
+
+	// A 1.2 device gets synchronization2 and dynamic rendering from their extensions, which have their own feature structs
+	std::vector<const char*> deviceExtensions{ s_DeviceExtensions };
+
+	VkPhysicalDeviceVulkan13Features vulkan13Features{};
+	vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+	vulkan13Features.synchronization2 = VK_TRUE; // Render graph barriers
+	vulkan13Features.dynamicRendering = m_DynamicRenderingSupported; // Optional, the render pass path is the fallback
+
+	VkPhysicalDeviceDynamicRenderingFeatures dynamicRenderingFeatures{};
+	dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES;
+	dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+
+	VkPhysicalDeviceSynchronization2Features synchronization2Features{};
+	synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+	synchronization2Features.synchronization2 = VK_TRUE;
+
+	if (!isVulkan13)
+	{
+		deviceExtensions.emplace_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+		if (m_DynamicRenderingSupported)
+		{
+			deviceExtensions.emplace_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+			synchronization2Features.pNext = &dynamicRenderingFeatures;
+		}
+	}
+
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.pNext = isVulkan13 ? static_cast<void*>(&vulkan13Features) : static_cast<void*>(&synchronization2Features);
+	vulkan12Features.timelineSemaphore = VK_TRUE;
+	// Bindless texture table
+	vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+	vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+	vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+	vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+	vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
 
 	VkDeviceCreateInfo createInfo{};
 	createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	createInfo.pNext = &vulkan12Features;
 
 	createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 	createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
 	createInfo.pEnabledFeatures = &deviceFeatures;
 
-	createInfo.enabledExtensionCount = static_cast<uint32_t>(s_DeviceExtensions.size());
-	createInfo.ppEnabledExtensionNames = s_DeviceExtensions.data();
+	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
 	if (m_ValidationLayersEnabled)
 	{
@@ -414,9 +564,24 @@ void VulkanInstance::CreateLogicDevice()
 	{
 		throw std::runtime_error("failed to create logical device!");
 	}
+	DeviceFunctions::Get().Initialize(m_VkDevice, properties.apiVersion, m_DynamicRenderingSupported);
 
-	vkGetDeviceQueue(m_VkDevice, indices.graphicsFamily.value(), 0, &m_GraphicsVkQueue);
-	vkGetDeviceQueue(m_VkDevice, indices.presentFamily.value(), 0, &m_PresentVkQueue);
+	std::map<std::pair<uint32_t, uint32_t>, Queue*> createdQueues{};
+	for (size_t typeIdx{}; typeIdx < queueSlots.size(); ++typeIdx)
+	{
+		Queue*& pQueue{ createdQueues[queueSlots[typeIdx]] };
+		if (!pQueue)
+		{
+			m_Queues.emplace_back(std::make_unique<Queue>());
+			m_Queues.back()->Initialize(m_VkDevice, queueSlots[typeIdx].first, queueSlots[typeIdx].second);
+			pQueue = m_Queues.back().get();
+		}
+		m_pQueues[typeIdx] = pQueue;
+	}
+
+	std::cout << "Queue families: graphics " << indices.graphicsFamily.value() << ", present " << indices.presentFamily.value()
+		<< ", transfer " << indices.transferFamily.value() << ", compute " << indices.computeFamily.value()
+		<< " (" << m_Queues.size() << " queues)\n";
 }
 
 bool VulkanInstance::IsDeviceSuitable(VkPhysicalDevice phyDevice)
@@ -432,5 +597,38 @@ bool VulkanInstance::IsDeviceSuitable(VkPhysicalDevice phyDevice)
 	VkPhysicalDeviceFeatures supportedFeatures{};
 	vkGetPhysicalDeviceFeatures(phyDevice, &supportedFeatures);
 
-	return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+	VkPhysicalDeviceProperties properties{};
+	vkGetPhysicalDeviceProperties(phyDevice, &properties);
+
+	// Frame and queue synchronization is built on timeline semaphores, the render graph on synchronization2, textures on descriptor indexing.
+	// Vulkan 1.2 is the floor, synchronization2 is core in 1.3 and an extension below it.
+	const bool isVulkan13{ properties.apiVersion >= VK_API_VERSION_1_3 };
+
+	VkPhysicalDeviceVulkan13Features vulkan13Features{};
+	vulkan13Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+	VkPhysicalDeviceSynchronization2Features synchronization2Features{};
+	synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES;
+
+	VkPhysicalDeviceVulkan12Features vulkan12Features{};
+	vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+	vulkan12Features.pNext = isVulkan13 ? static_cast<void*>(&vulkan13Features) : static_cast<void*>(&synchronization2Features);
+
+	bool syncFeaturesSupported{ false };
+	const bool hasSynchronization2{ isVulkan13 || IsDeviceExtensionSupported(phyDevice, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) };
+	if (properties.apiVersion >= VK_API_VERSION_1_2 && hasSynchronization2)
+	{
+		VkPhysicalDeviceFeatures2 features2{};
+		features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features2.pNext = &vulkan12Features;
+		vkGetPhysicalDeviceFeatures2(phyDevice, &features2);
+
+		const VkBool32 synchronization2{ isVulkan13 ? vulkan13Features.synchronization2 : synchronization2Features.synchronization2 };
+		syncFeaturesSupported = vulkan12Features.timelineSemaphore && synchronization2 &&
+			vulkan12Features.runtimeDescriptorArray && vulkan12Features.descriptorBindingPartiallyBound &&
+			vulkan12Features.descriptorBindingSampledImageUpdateAfterBind && vulkan12Features.descriptorBindingUpdateUnusedWhilePending &&
+			vulkan12Features.shaderSampledImageArrayNonUniformIndexing;
+	}
+
+	return indices.IsComplete() && extensionsSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy && syncFeaturesSupported;
 }
\ No newline at end of file
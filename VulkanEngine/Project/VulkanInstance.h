@@ -1,11 +1,15 @@
 #ifndef VULKANINSTANCE_H
 
 #include <vector>
+#include <array>
+#include <memory>
 #include <string>
 
 #include <vulkan/vulkan.h>
 
 #include "Surface.h"
+#include "PipelineCache.h"
+#include "Queue.h"
 #include "VulkanStructs.h"
 
 using MessageCreateInfo = VkDebugUtilsMessengerCreateInfoEXT;
@@ -39,8 +43,14 @@ public:
 	const VkPhysicalDevice& GetVkPhysicalDevice() const;
 	const VkQueue& GetGraphicsQueue() const;
 	const VkQueue& GetPresentQueue() const;
+	Queue& GetQueue(QueueType queueType) const;
+	bool IsDynamicRenderingSupported() const;
 	VkResult DeviceWaitIdle();
 
+	// Pipeline Cache
+	const PipelineCache& GetPipelineCache() const;
+	const VkPipelineCache& GetVkPipelineCache() const;
+
 	SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device) const;
 	SwapChainSupportDetails QuerySwapChainSupport() const;
 	QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device) const;
@@ -57,6 +67,7 @@ private:
 	std::vector<const char*> GetRequiredExtensions();
 	bool CheckValidationLayerSupport();
 	bool CheckDeviceExtensionSupport(VkPhysicalDevice device);
+	static bool IsDeviceExtensionSupported(VkPhysicalDevice device, const char* extensionName);
 
 	static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(MessageSeverity messgSeverity, MessageType messgType, const MessageData* callbakcD, void* pUserData);
 
@@ -84,6 +95,7 @@ private:
 
 	static const std::string s_AppName;
 	static const std::string s_EngineName;
+	static const std::string s_PipelineCacheFilePath;
 
 	// Surface
 	Surface m_Surface;
@@ -91,8 +103,14 @@ private:
 	// Devices
 	VkPhysicalDevice m_VkPhysicalDevice;
 	VkDevice m_VkDevice;
-	VkQueue m_GraphicsVkQueue;
-	VkQueue m_PresentVkQueue;
+	bool m_DynamicRenderingSupported{ false };
+
+	// Queues, types without a dedicated family share the queue of the family they fall back to
+	std::vector<std::unique_ptr<Queue>> m_Queues;
+	std::array<Queue*, 4> m_pQueues;
+
+	// Pipeline Cache
+	PipelineCache m_PipelineCache;
 
 };
 
@@ -16,6 +16,8 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
 
+class PipelineStateCache;
+
 struct InputState
 {
 	bool keyChange = false;
@@ -41,14 +43,37 @@ struct GraphicsPipelineConfigs
 {
 	VkDevice device;
 	ShadersConfigs shaderConfigs;
-	VkExtent2D swapchainExtent;
-	VkRenderPass renderPass;
+	VkRenderPass renderPass; // VK_NULL_HANDLE for dynamic rendering
+	VkFormat colorFormat;
+	VkFormat depthFormat;
+	PipelineStateCache* stateCache;
+};
+
+struct SamplerConfigs
+{
+	VkFilter filter{ VK_FILTER_LINEAR };
+	VkSamplerAddressMode addressMode{ VK_SAMPLER_ADDRESS_MODE_REPEAT };
+	bool anisotropyEnable{ true };
+	float maxLod{ 1.f };
+};
+
+struct AssetResidencyStats
+{
+	uint32_t meshCount{};
+	uint32_t textureCount{};
+	uint32_t samplerCount{};
+	VkDeviceSize meshBytes{};
+	VkDeviceSize textureBytes{};
+	uint64_t cacheHits{};
+	uint64_t cacheMisses{};
 };
 
 struct QueueFamilyIndices
 {
 	std::optional<uint32_t> graphicsFamily{};
 	std::optional<uint32_t> presentFamily{};
+	std::optional<uint32_t> transferFamily{};
+	std::optional<uint32_t> computeFamily{};
 
 	bool IsComplete()
 	{
@@ -74,6 +99,13 @@ struct ModelUBO
 	alignas(16) glm::mat4 model{ 1.f };
 };
 
+// Per instance vertex data of the 3D pipeline, the material is the texture table slot the fragment shader samples
+struct InstanceData
+{
+	alignas(16) glm::mat4 model{ 1.f };
+	uint32_t material{};
+};
+
 struct Transform2D
 {
 	glm::vec2 position{ 0.f, 0.f };
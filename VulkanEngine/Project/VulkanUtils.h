@@ -7,7 +7,7 @@
 
 #include <vulkan/vulkan.h>
 
-const int g_MaxFramesInFlight{ 2 };
+constexpr const char* g_EngineSettingsPath{ "Resources/EngineSettings.json" };
 
 constexpr const char* g_Model3DPath1{ "Resources/Models/viking_room.obj" };
 constexpr const char* g_CubeModel{ "Resources/Models/cube.obj" };
@@ -3,15 +3,19 @@
 #endif // DEBUG
 
 #include "Application.h"
+#include "EngineSettings.h"
 
 /// !!!!!!!!
 // Lot of Vulkan Code based on https://vulkan-tutorial.com/ //
 // /////
 
-int main()
+int main(int argc, char* argv[])
 {
     try
     {
+        EngineSettings::Get().Initialize(argc, argv);
+        EngineSettings::Get().Print();
+
         Application vulkanApp{};
         vulkanApp.Run();
     }
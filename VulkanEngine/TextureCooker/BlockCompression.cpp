@@ -0,0 +1,438 @@
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+
+#include "BlockCompression.h"
+
+namespace
+{
+	using Block = uint8_t[16][4];
+
+	constexpr uint32_t s_BC7Weights4[16]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	class BitWriter final
+	{
+	public:
+
+		explicit BitWriter(uint8_t* output)
+			: m_Output{ output }
+			, m_BitPosition{}
+		{
+			std::memset(m_Output, 0, 16);
+		}
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t bitIdx{}; bitIdx < bitCount; ++bitIdx, ++m_BitPosition)
+			{
+				if ((value >> bitIdx) & 1u) m_Output[m_BitPosition >> 3] |= static_cast<uint8_t>(1u << (m_BitPosition & 7u));
+			}
+		}
+
+	private:
+
+		uint8_t* m_Output;
+		uint32_t m_BitPosition;
+
+	};
+
+	void FetchBlock(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& block)
+	{
+		for (uint32_t y{}; y < 4; ++y)
+		{
+			const uint32_t pixelY{ std::min(blockY * 4 + y, height - 1) };
+			for (uint32_t x{}; x < 4; ++x)
+			{
+				const uint32_t pixelX{ std::min(blockX * 4 + x, width - 1) };
+				std::memcpy(block[y * 4 + x], rgbaPixels + (static_cast<size_t>(pixelY) * width + pixelX) * 4, 4);
+			}
+		}
+	}
+
+	// Fits a line through the block colors along their principal axis and returns its extremes
+	void ComputeEndpoints(const Block& block, uint32_t channelCount, float endpoint0[4], float endpoint1[4])
+	{
+		float mean[4]{};
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			for (uint32_t c{}; c < channelCount; ++c) mean[c] += block[pixelIdx][c] / 16.f;
+		}
+
+		float covariance[4][4]{};
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			for (uint32_t row{}; row < channelCount; ++row)
+			{
+				for (uint32_t col{}; col < channelCount; ++col)
+				{
+					covariance[row][col] += (block[pixelIdx][row] - mean[row]) * (block[pixelIdx][col] - mean[col]);
+				}
+			}
+		}
+
+		// Power iteration for the dominant eigenvector
+		float axis[4]{ 1.f, 1.f, 1.f, 1.f };
+		for (uint32_t iteration{}; iteration < 8; ++iteration)
+		{
+			float next[4]{};
+			float length{};
+			for (uint32_t row{}; row < channelCount; ++row)
+			{
+				for (uint32_t col{}; col < channelCount; ++col) next[row] += covariance[row][col] * axis[col];
+				length += next[row] * next[row];
+			}
+
+			length = std::sqrt(length);
+			if (length < 1e-6f) break;
+
+			for (uint32_t c{}; c < channelCount; ++c) axis[c] = next[c] / length;
+		}
+
+		float minProjection{ FLT_MAX };
+		float maxProjection{ -FLT_MAX };
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			float projection{};
+			for (uint32_t c{}; c < channelCount; ++c) projection += (block[pixelIdx][c] - mean[c]) * axis[c];
+
+			minProjection = std::min(minProjection, projection);
+			maxProjection = std::max(maxProjection, projection);
+		}
+
+		for (uint32_t c{}; c < 4; ++c)
+		{
+			endpoint0[c] = c < channelCount ? std::clamp(mean[c] + axis[c] * minProjection, 0.f, 255.f) : 255.f;
+			endpoint1[c] = c < channelCount ? std::clamp(mean[c] + axis[c] * maxProjection, 0.f, 255.f) : 255.f;
+		}
+	}
+
+	uint16_t ToRgb565(const float color[4])
+	{
+		const uint32_t r{ static_cast<uint32_t>(std::lround(color[0] * 31.f / 255.f)) };
+		const uint32_t g{ static_cast<uint32_t>(std::lround(color[1] * 63.f / 255.f)) };
+		const uint32_t b{ static_cast<uint32_t>(std::lround(color[2] * 31.f / 255.f)) };
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	void FromRgb565(uint16_t packed, float color[3])
+	{
+		const uint32_t r{ (packed >> 11) & 31u };
+		const uint32_t g{ (packed >> 5) & 63u };
+		const uint32_t b{ packed & 31u };
+		color[0] = static_cast<float>((r << 3) | (r >> 2));
+		color[1] = static_cast<float>((g << 2) | (g >> 4));
+		color[2] = static_cast<float>((b << 3) | (b >> 2));
+	}
+
+	void EncodeBC1Block(const Block& block, uint8_t* output)
+	{
+		float endpoint0[4]{};
+		float endpoint1[4]{};
+		ComputeEndpoints(block, 3, endpoint0, endpoint1);
+
+		uint16_t color0{ ToRgb565(endpoint1) };
+		uint16_t color1{ ToRgb565(endpoint0) };
+
+		// color0 > color1 selects the opaque four color mode
+		if (color0 < color1) std::swap(color0, color1);
+
+		float palette[4][3]{};
+		FromRgb565(color0, palette[0]);
+		FromRgb565(color1, palette[1]);
+		for (uint32_t c{}; c < 3; ++c)
+		{
+			palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+			palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+		}
+
+		uint32_t indices{};
+		if (color0 != color1)
+		{
+			for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+			{
+				uint32_t bestIdx{};
+				float bestError{ FLT_MAX };
+				for (uint32_t paletteIdx{}; paletteIdx < 4; ++paletteIdx)
+				{
+					float error{};
+					for (uint32_t c{}; c < 3; ++c)
+					{
+						const float diff{ block[pixelIdx][c] - palette[paletteIdx][c] };
+						error += diff * diff;
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIdx = paletteIdx;
+					}
+				}
+				indices |= bestIdx << (pixelIdx * 2);
+			}
+		}
+
+		output[0] = static_cast<uint8_t>(color0 & 0xFF);
+		output[1] = static_cast<uint8_t>(color0 >> 8);
+		output[2] = static_cast<uint8_t>(color1 & 0xFF);
+		output[3] = static_cast<uint8_t>(color1 >> 8);
+		std::memcpy(output + 4, &indices, sizeof(indices));
+	}
+
+	void EncodeBC3AlphaBlock(const Block& block, uint8_t* output)
+	{
+		uint8_t alpha0{ 0 };
+		uint8_t alpha1{ 255 };
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			alpha0 = std::max(alpha0, block[pixelIdx][3]);
+			alpha1 = std::min(alpha1, block[pixelIdx][3]);
+		}
+
+		// alpha0 > alpha1 selects the eight value interpolation mode
+		float palette[8]{ static_cast<float>(alpha0), static_cast<float>(alpha1) };
+		for (uint32_t paletteIdx{ 1 }; paletteIdx < 7; ++paletteIdx)
+		{
+			palette[paletteIdx + 1] = ((7 - paletteIdx) * palette[0] + paletteIdx * palette[1]) / 7.f;
+		}
+
+		uint64_t indices{};
+		if (alpha0 != alpha1)
+		{
+			for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+			{
+				uint64_t bestIdx{};
+				float bestError{ FLT_MAX };
+				for (uint32_t paletteIdx{}; paletteIdx < 8; ++paletteIdx)
+				{
+					const float error{ std::abs(block[pixelIdx][3] - palette[paletteIdx]) };
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIdx = paletteIdx;
+					}
+				}
+				indices |= bestIdx << (pixelIdx * 3);
+			}
+		}
+
+		output[0] = alpha0;
+		output[1] = alpha1;
+		for (uint32_t byteIdx{}; byteIdx < 6; ++byteIdx)
+		{
+			output[2 + byteIdx] = static_cast<uint8_t>((indices >> (byteIdx * 8)) & 0xFF);
+		}
+	}
+
+	// Quantizes an endpoint to 7 bits per channel and picks the shared p-bit with the smallest error
+	void QuantizeBC7Endpoint(const float endpoint[4], uint32_t quantized[4], uint32_t& pBit)
+	{
+		float bestError{ FLT_MAX };
+		for (uint32_t candidatePBit{}; candidatePBit < 2; ++candidatePBit)
+		{
+			uint32_t candidate[4]{};
+			float error{};
+			for (uint32_t c{}; c < 4; ++c)
+			{
+				candidate[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - candidatePBit) / 2.f), 0l, 127l));
+				const float diff{ static_cast<float>((candidate[c] << 1) | candidatePBit) - endpoint[c] };
+				error += diff * diff;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				pBit = candidatePBit;
+				std::copy(candidate, candidate + 4, quantized);
+			}
+		}
+	}
+
+	struct BC7Endpoints
+	{
+		uint32_t quantized0[4];
+		uint32_t quantized1[4];
+		uint32_t pBit0;
+		uint32_t pBit1;
+	};
+
+	// Picks the closest palette entry for every pixel and returns the total squared error
+	float SelectBC7Indices(const Block& block, const BC7Endpoints& endpoints, uint32_t indices[16])
+	{
+		float palette[16][4]{};
+		for (uint32_t c{}; c < 4; ++c)
+		{
+			const uint32_t expanded0{ (endpoints.quantized0[c] << 1) | endpoints.pBit0 };
+			const uint32_t expanded1{ (endpoints.quantized1[c] << 1) | endpoints.pBit1 };
+			for (uint32_t paletteIdx{}; paletteIdx < 16; ++paletteIdx)
+			{
+				const uint32_t weight{ s_BC7Weights4[paletteIdx] };
+				palette[paletteIdx][c] = static_cast<float>(((64 - weight) * expanded0 + weight * expanded1 + 32) >> 6);
+			}
+		}
+
+		float totalError{};
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			float bestError{ FLT_MAX };
+			for (uint32_t paletteIdx{}; paletteIdx < 16; ++paletteIdx)
+			{
+				float error{};
+				for (uint32_t c{}; c < 4; ++c)
+				{
+					const float diff{ block[pixelIdx][c] - palette[paletteIdx][c] };
+					error += diff * diff;
+				}
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[pixelIdx] = paletteIdx;
+				}
+			}
+			totalError += bestError;
+		}
+
+		return totalError;
+	}
+
+	// Least squares fit of both endpoints for a fixed set of interpolation weights
+	bool RefineBC7Endpoints(const Block& block, const uint32_t indices[16], float endpoint0[4], float endpoint1[4])
+	{
+		float sumA{};
+		float sumB{};
+		float sumC{};
+		float rhs0[4]{};
+		float rhs1[4]{};
+		for (uint32_t pixelIdx{}; pixelIdx < 16; ++pixelIdx)
+		{
+			const float t{ s_BC7Weights4[indices[pixelIdx]] / 64.f };
+			sumA += (1.f - t) * (1.f - t);
+			sumB += (1.f - t) * t;
+			sumC += t * t;
+			for (uint32_t c{}; c < 4; ++c)
+			{
+				rhs0[c] += (1.f - t) * block[pixelIdx][c];
+				rhs1[c] += t * block[pixelIdx][c];
+			}
+		}
+
+		const float determinant{ sumA * sumC - sumB * sumB };
+		if (std::abs(determinant) < 1e-6f) return false;
+
+		for (uint32_t c{}; c < 4; ++c)
+		{
+			endpoint0[c] = std::clamp((sumC * rhs0[c] - sumB * rhs1[c]) / determinant, 0.f, 255.f);
+			endpoint1[c] = std::clamp((sumA * rhs1[c] - sumB * rhs0[c]) / determinant, 0.f, 255.f);
+		}
+		return true;
+	}
+
+	// BC7 mode 6: a single RGBA subset with 7.7.7.7 endpoints, per endpoint p-bits and 4 bit indices
+	void EncodeBC7Block(const Block& block, uint8_t* output)
+	{
+		constexpr uint32_t refineIterations{ 2 };
+
+		float endpoint0[4]{};
+		float endpoint1[4]{};
+		ComputeEndpoints(block, 4, endpoint0, endpoint1);
+
+		BC7Endpoints endpoints{};
+		QuantizeBC7Endpoint(endpoint0, endpoints.quantized0, endpoints.pBit0);
+		QuantizeBC7Endpoint(endpoint1, endpoints.quantized1, endpoints.pBit1);
+
+		uint32_t indices[16]{};
+		float bestError{ SelectBC7Indices(block, endpoints, indices) };
+
+		for (uint32_t iteration{}; iteration < refineIterations; ++iteration)
+		{
+			if (!RefineBC7Endpoints(block, indices, endpoint0, endpoint1)) break;
+
+			BC7Endpoints refined{};
+			QuantizeBC7Endpoint(endpoint0, refined.quantized0, refined.pBit0);
+			QuantizeBC7Endpoint(endpoint1, refined.quantized1, refined.pBit1);
+
+			uint32_t refinedIndices[16]{};
+			const float error{ SelectBC7Indices(block, refined, refinedIndices) };
+			if (error >= bestError) break;
+
+			bestError = error;
+			endpoints = refined;
+			std::copy(refinedIndices, refinedIndices + 16, indices);
+		}
+
+		uint32_t (&quantized0)[4]{ endpoints.quantized0 };
+		uint32_t (&quantized1)[4]{ endpoints.quantized1 };
+		uint32_t& pBit0{ endpoints.pBit0 };
+		uint32_t& pBit1{ endpoints.pBit1 };
+
+		// The anchor index is stored without its most significant bit, swap the endpoints if it is set
+		if (indices[0] & 8u)
+		{
+			std::swap(quantized0, quantized1);
+			std::swap(pBit0, pBit1);
+			for (uint32_t& index : indices) index = 15 - index;
+		}
+
+		BitWriter writer{ output };
+		writer.Write(1u << 6, 7);
+		for (uint32_t c{}; c < 4; ++c)
+		{
+			writer.Write(quantized0[c], 7);
+			writer.Write(quantized1[c], 7);
+		}
+		writer.Write(pBit0, 1);
+		writer.Write(pBit1, 1);
+
+		writer.Write(indices[0], 3);
+		for (uint32_t pixelIdx{ 1 }; pixelIdx < 16; ++pixelIdx)
+		{
+			writer.Write(indices[pixelIdx], 4);
+		}
+	}
+}
+
+uint32_t BlockCompression::GetBlockSize(BlockFormat format)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1: return 8;
+	case BlockFormat::BC3: return 16;
+	case BlockFormat::BC7: return 16;
+	}
+	throw std::invalid_argument{ "unknown block format!" };
+}
+
+std::vector<uint8_t> BlockCompression::CompressImage(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, BlockFormat format)
+{
+	const uint32_t blocksX{ (width + 3) / 4 };
+	const uint32_t blocksY{ (height + 3) / 4 };
+	const uint32_t blockSize{ GetBlockSize(format) };
+
+	std::vector<uint8_t> compressed(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+	Block block{};
+	for (uint32_t blockY{}; blockY < blocksY; ++blockY)
+	{
+		for (uint32_t blockX{}; blockX < blocksX; ++blockX)
+		{
+			FetchBlock(rgbaPixels, width, height, blockX, blockY, block);
+			uint8_t* output{ compressed.data() + (static_cast<size_t>(blockY) * blocksX + blockX) * blockSize };
+
+			switch (format)
+			{
+			case BlockFormat::BC1:
+				EncodeBC1Block(block, output);
+				break;
+			case BlockFormat::BC3:
+				EncodeBC3AlphaBlock(block, output);
+				EncodeBC1Block(block, output + 8);
+				break;
+			case BlockFormat::BC7:
+				EncodeBC7Block(block, output);
+				break;
+			}
+		}
+	}
+
+	return compressed;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef BLOCKCOMPRESSION_H
+#define BLOCKCOMPRESSION_H
+
+#include <vector>
+#include <cstdint>
+
+enum class BlockFormat
+{
+	BC1,
+	BC3,
+	BC7
+};
+
+namespace BlockCompression
+{
+	// Size in bytes of one compressed 4x4 block
+	uint32_t GetBlockSize(BlockFormat format);
+
+	// Compresses a tightly packed RGBA8 image, partial edge blocks are padded by clamping to the edge
+	std::vector<uint8_t> CompressImage(const uint8_t* rgbaPixels, uint32_t width, uint32_t height, BlockFormat format);
+}
+
+#endif // !BLOCKCOMPRESSION_H
\ No newline at end of file
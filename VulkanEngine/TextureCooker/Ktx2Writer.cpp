@@ -0,0 +1,164 @@
+#include <stdexcept>
+#include <fstream>
+#include <cstring>
+
+#include <vulkan/vulkan_core.h>
+
+#include "Ktx2Writer.h"
+
+namespace
+{
+	constexpr uint8_t s_Ktx2Identifier[12]{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+	// Khronos Data Format values used by the basic descriptor block
+	constexpr uint32_t s_DfdModelBC1A{ 128 };
+	constexpr uint32_t s_DfdModelBC3{ 130 };
+	constexpr uint32_t s_DfdModelBC7{ 135 };
+	constexpr uint32_t s_DfdPrimariesBT709{ 1 };
+	constexpr uint32_t s_DfdTransferLinear{ 1 };
+	constexpr uint32_t s_DfdTransferSrgb{ 2 };
+	constexpr uint32_t s_DfdChannelColor{ 0 };
+	constexpr uint32_t s_DfdChannelBC3Alpha{ 15 };
+	constexpr uint32_t s_DfdQualifierLinear{ 0x10 };
+
+	void AppendUint32(std::vector<uint8_t>& bytes, uint32_t value)
+	{
+		for (uint32_t byteIdx{}; byteIdx < 4; ++byteIdx) bytes.push_back(static_cast<uint8_t>((value >> (byteIdx * 8)) & 0xFF));
+	}
+
+	void AppendUint64(std::vector<uint8_t>& bytes, uint64_t value)
+	{
+		for (uint32_t byteIdx{}; byteIdx < 8; ++byteIdx) bytes.push_back(static_cast<uint8_t>((value >> (byteIdx * 8)) & 0xFF));
+	}
+
+	void AppendSample(std::vector<uint8_t>& bytes, uint32_t bitOffset, uint32_t bitLength, uint32_t channelType)
+	{
+		AppendUint32(bytes, bitOffset | ((bitLength - 1) << 16) | (channelType << 24));
+		AppendUint32(bytes, 0); // sample position
+		AppendUint32(bytes, 0); // lower
+		AppendUint32(bytes, UINT32_MAX); // upper
+	}
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+void Ktx2Writer::Write(const std::string& filePath, BlockFormat format, bool srgb, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels) const
+{
+	if (levels.empty())
+	{
+		throw std::invalid_argument{ "ktx2 file needs at least one level!" };
+	}
+
+	const uint32_t levelCount{ static_cast<uint32_t>(levels.size()) };
+	const std::vector<uint8_t> dataFormatDescriptor{ CreateDataFormatDescriptor(format, srgb) };
+
+	constexpr uint64_t headerSize{ sizeof(s_Ktx2Identifier) + 9 * sizeof(uint32_t) + 4 * sizeof(uint32_t) + 2 * sizeof(uint64_t) };
+	const uint64_t levelIndexSize{ levelCount * 3 * sizeof(uint64_t) };
+	const uint64_t dfdOffset{ headerSize + levelIndexSize };
+
+	// Level data must be aligned to lcm(texel block size, 4), the smallest level is stored first
+	const uint64_t levelAlignment{ BlockCompression::GetBlockSize(format) };
+
+	std::vector<uint64_t> levelOffsets(levelCount);
+	uint64_t fileOffset{ dfdOffset + dataFormatDescriptor.size() };
+	for (uint32_t levelIdx{ levelCount }; levelIdx-- > 0;)
+	{
+		fileOffset = AlignUp(fileOffset, levelAlignment);
+		levelOffsets[levelIdx] = fileOffset;
+		fileOffset += levels[levelIdx].size();
+	}
+
+	std::vector<uint8_t> bytes{};
+	bytes.reserve(fileOffset);
+
+	bytes.insert(bytes.end(), std::begin(s_Ktx2Identifier), std::end(s_Ktx2Identifier));
+	AppendUint32(bytes, GetVkFormat(format, srgb));
+	AppendUint32(bytes, 1); // typeSize
+	AppendUint32(bytes, width);
+	AppendUint32(bytes, height);
+	AppendUint32(bytes, 0); // pixelDepth
+	AppendUint32(bytes, 0); // layerCount
+	AppendUint32(bytes, 1); // faceCount
+	AppendUint32(bytes, levelCount);
+	AppendUint32(bytes, 0); // supercompressionScheme
+
+	AppendUint32(bytes, static_cast<uint32_t>(dfdOffset));
+	AppendUint32(bytes, static_cast<uint32_t>(dataFormatDescriptor.size()));
+	AppendUint32(bytes, 0); // kvdByteOffset
+	AppendUint32(bytes, 0); // kvdByteLength
+	AppendUint64(bytes, 0); // sgdByteOffset
+	AppendUint64(bytes, 0); // sgdByteLength
+
+	for (uint32_t levelIdx{}; levelIdx < levelCount; ++levelIdx)
+	{
+		AppendUint64(bytes, levelOffsets[levelIdx]);
+		AppendUint64(bytes, levels[levelIdx].size());
+		AppendUint64(bytes, levels[levelIdx].size());
+	}
+
+	bytes.insert(bytes.end(), dataFormatDescriptor.begin(), dataFormatDescriptor.end());
+
+	for (uint32_t levelIdx{ levelCount }; levelIdx-- > 0;)
+	{
+		bytes.resize(levelOffsets[levelIdx], 0);
+		bytes.insert(bytes.end(), levels[levelIdx].begin(), levels[levelIdx].end());
+	}
+
+	std::ofstream file{ filePath, std::ios::binary | std::ios::trunc };
+	if (!file.is_open())
+	{
+		throw std::runtime_error{ "failed to open output file: " + filePath };
+	}
+
+	file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+uint32_t Ktx2Writer::GetVkFormat(BlockFormat format, bool srgb)
+{
+	switch (format)
+	{
+	case BlockFormat::BC1: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+	case BlockFormat::BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+	case BlockFormat::BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+	}
+	throw std::invalid_argument{ "unknown block format!" };
+}
+
+std::vector<uint8_t> Ktx2Writer::CreateDataFormatDescriptor(BlockFormat format, bool srgb)
+{
+	const uint32_t sampleCount{ format == BlockFormat::BC3 ? 2u : 1u };
+	const uint32_t blockSize{ BlockCompression::GetBlockSize(format) };
+	const uint32_t descriptorBlockSize{ 24 + 16 * sampleCount };
+
+	uint32_t colorModel{};
+	switch (format)
+	{
+	case BlockFormat::BC1: colorModel = s_DfdModelBC1A; break;
+	case BlockFormat::BC3: colorModel = s_DfdModelBC3; break;
+	case BlockFormat::BC7: colorModel = s_DfdModelBC7; break;
+	}
+
+	std::vector<uint8_t> bytes{};
+	AppendUint32(bytes, 4 + descriptorBlockSize); // dfdTotalSize
+	AppendUint32(bytes, 0); // vendorId | descriptorType
+	AppendUint32(bytes, 2 | (descriptorBlockSize << 16)); // versionNumber | descriptorBlockSize
+	AppendUint32(bytes, colorModel | (s_DfdPrimariesBT709 << 8) | ((srgb ? s_DfdTransferSrgb : s_DfdTransferLinear) << 16));
+	AppendUint32(bytes, 3 | (3 << 8)); // 4x4 texel blocks
+	AppendUint32(bytes, blockSize); // bytesPlane0
+	AppendUint32(bytes, 0); // bytesPlane4..7
+
+	if (format == BlockFormat::BC3)
+	{
+		AppendSample(bytes, 0, 64, s_DfdChannelBC3Alpha | s_DfdQualifierLinear);
+		AppendSample(bytes, 64, 64, s_DfdChannelColor);
+	}
+	else
+	{
+		AppendSample(bytes, 0, blockSize * 8, s_DfdChannelColor);
+	}
+
+	return bytes;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef KTX2WRITER_H
+#define KTX2WRITER_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "BlockCompression.h"
+
+class Ktx2Writer final
+{
+public:
+
+	Ktx2Writer() = default;
+	~Ktx2Writer() = default;
+
+	// levels[0] is the full resolution level, every level holds the compressed blocks of that mip
+	void Write(const std::string& filePath, BlockFormat format, bool srgb, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels) const;
+
+	static uint32_t GetVkFormat(BlockFormat format, bool srgb);
+
+private:
+
+	static std::vector<uint8_t> CreateDataFormatDescriptor(BlockFormat format, bool srgb);
+
+};
+
+#endif // !KTX2WRITER_H
\ No newline at end of file
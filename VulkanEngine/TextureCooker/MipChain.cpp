@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "MipChain.h"
+
+namespace
+{
+	float SrgbToLinear(uint8_t value)
+	{
+		static const std::array<float, 256> s_Table{ []()
+			{
+				std::array<float, 256> table{};
+				for (uint32_t idx{}; idx < 256; ++idx)
+				{
+					const float srgb{ idx / 255.f };
+					table[idx] = srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f);
+				}
+				return table;
+			}() };
+
+		return s_Table[value];
+	}
+
+	uint8_t LinearToSrgb(float value)
+	{
+		const float srgb{ value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f };
+		return static_cast<uint8_t>(std::lround(std::clamp(srgb, 0.f, 1.f) * 255.f));
+	}
+
+	RgbaImage Downsample(const RgbaImage& source, bool srgb)
+	{
+		RgbaImage destination{};
+		destination.width = std::max(source.width / 2, 1u);
+		destination.height = std::max(source.height / 2, 1u);
+		destination.pixels.resize(static_cast<size_t>(destination.width) * destination.height * 4);
+
+		for (uint32_t y{}; y < destination.height; ++y)
+		{
+			const uint32_t sourceY0{ std::min(y * 2, source.height - 1) };
+			const uint32_t sourceY1{ std::min(y * 2 + 1, source.height - 1) };
+
+			for (uint32_t x{}; x < destination.width; ++x)
+			{
+				const uint32_t sourceX0{ std::min(x * 2, source.width - 1) };
+				const uint32_t sourceX1{ std::min(x * 2 + 1, source.width - 1) };
+
+				const std::array<const uint8_t*, 4> samples
+				{
+					&source.pixels[(static_cast<size_t>(sourceY0) * source.width + sourceX0) * 4],
+					&source.pixels[(static_cast<size_t>(sourceY0) * source.width + sourceX1) * 4],
+					&source.pixels[(static_cast<size_t>(sourceY1) * source.width + sourceX0) * 4],
+					&source.pixels[(static_cast<size_t>(sourceY1) * source.width + sourceX1) * 4]
+				};
+
+				uint8_t* output{ &destination.pixels[(static_cast<size_t>(y) * destination.width + x) * 4] };
+				for (uint32_t c{}; c < 4; ++c)
+				{
+					const bool isColor{ srgb && c < 3 };
+
+					float sum{};
+					for (const uint8_t* sample : samples)
+					{
+						sum += isColor ? SrgbToLinear(sample[c]) : sample[c] / 255.f;
+					}
+
+					const float average{ sum / 4.f };
+					output[c] = isColor ? LinearToSrgb(average) : static_cast<uint8_t>(std::lround(average * 255.f));
+				}
+			}
+		}
+
+		return destination;
+	}
+}
+
+uint32_t MipChain::GetLevelCount(uint32_t width, uint32_t height)
+{
+	return static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+}
+
+std::vector<RgbaImage> MipChain::Generate(const RgbaImage& baseLevel, bool srgb)
+{
+	const uint32_t levelCount{ GetLevelCount(baseLevel.width, baseLevel.height) };
+
+	std::vector<RgbaImage> levels{};
+	levels.reserve(levelCount);
+	levels.push_back(baseLevel);
+
+	for (uint32_t levelIdx{ 1 }; levelIdx < levelCount; ++levelIdx)
+	{
+		levels.push_back(Downsample(levels.back(), srgb));
+	}
+
+	return levels;
+}
\ No newline at end of file
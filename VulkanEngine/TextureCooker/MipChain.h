@@ -0,0 +1,22 @@
+#ifndef MIPCHAIN_H
+#define MIPCHAIN_H
+
+#include <vector>
+#include <cstdint>
+
+struct RgbaImage
+{
+	uint32_t width{};
+	uint32_t height{};
+	std::vector<uint8_t> pixels{};
+};
+
+namespace MipChain
+{
+	uint32_t GetLevelCount(uint32_t width, uint32_t height);
+
+	// Box filters every level from the previous one down to 1x1, color is averaged in linear space for sRGB images
+	std::vector<RgbaImage> Generate(const RgbaImage& baseLevel, bool srgb);
+}
+
+#endif // !MIPCHAIN_H
\ No newline at end of file
@@ -0,0 +1,101 @@
+#include <stdexcept>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "BlockCompression.h"
+#include "MipChain.h"
+#include "Ktx2Writer.h"
+
+// Offline texture cooker: decodes a source image, builds the full mip chain
+// and stores every level block compressed inside a KTX2 container.
+// Usage: TextureCooker <input> <output.ktx2> [--format bc1|bc3|bc7] [--linear]
+
+namespace
+{
+	BlockFormat ParseFormat(const std::string& format)
+	{
+		if (format == "bc1") return BlockFormat::BC1;
+		if (format == "bc3") return BlockFormat::BC3;
+		if (format == "bc7") return BlockFormat::BC7;
+		throw std::invalid_argument{ "unknown format: " + format };
+	}
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: TextureCooker <input> <output.ktx2> [--format bc1|bc3|bc7] [--linear]\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	try
+	{
+		const std::string inputPath{ argv[1] };
+		const std::string outputPath{ argv[2] };
+
+		BlockFormat format{ BlockFormat::BC7 };
+		bool srgb{ true };
+
+		for (int argIdx{ 3 }; argIdx < argc; ++argIdx)
+		{
+			if (std::strcmp(argv[argIdx], "--format") == 0 && argIdx + 1 < argc) format = ParseFormat(argv[++argIdx]);
+			else if (std::strcmp(argv[argIdx], "--linear") == 0) srgb = false;
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+		}
+
+		int texWidth{};
+		int texHeight{};
+		int texChannels{};
+
+		stbi_uc* pixels{ stbi_load(inputPath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha) };
+		if (!pixels) throw std::runtime_error("failed to load texture image: " + std::string(stbi_failure_reason()));
+
+		RgbaImage baseLevel{};
+		baseLevel.width = static_cast<uint32_t>(texWidth);
+		baseLevel.height = static_cast<uint32_t>(texHeight);
+		baseLevel.pixels.assign(pixels, pixels + static_cast<size_t>(texWidth) * texHeight * 4);
+
+		stbi_image_free(pixels);
+
+		const std::vector<RgbaImage> mipLevels{ MipChain::Generate(baseLevel, srgb) };
+
+		std::vector<std::vector<uint8_t>> compressedLevels{};
+		compressedLevels.reserve(mipLevels.size());
+
+		size_t compressedSize{};
+		for (const RgbaImage& level : mipLevels)
+		{
+			compressedLevels.push_back(BlockCompression::CompressImage(level.pixels.data(), level.width, level.height, format));
+			compressedSize += compressedLevels.back().size();
+		}
+
+		const Ktx2Writer writer{};
+		writer.Write(outputPath, format, srgb, baseLevel.width, baseLevel.height, compressedLevels);
+
+		std::cout << "Cooked " << inputPath << " -> " << outputPath
+			<< " (" << baseLevel.width << "x" << baseLevel.height << ", " << mipLevels.size() << " mips, "
+			<< compressedSize / 1024 << " KiB)\n";
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file
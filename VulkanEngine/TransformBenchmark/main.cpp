@@ -0,0 +1,174 @@
+#include <stdexcept>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+
+#include "TransformSoA.h"
+#include "JobSystem.h"
+
+// Microbenchmark of the instance model matrices: the per instance Transform3D::GetModelMatrix path
+// against the batched TransformSoA kernel, single threaded and on the job system.
+// Usage: TransformBenchmark [--instances <count>] [--dirty <percent>] [--iterations <count>] [--threads <count>]
+
+namespace
+{
+	std::vector<Transform3D> CreateTransforms(uint32_t count)
+	{
+		std::mt19937 generator{ 1337 };
+		std::uniform_real_distribution<float> positionDistribution{ -100.f, 100.f };
+		std::uniform_real_distribution<float> angleDistribution{ -3.1415f, 3.1415f };
+		std::uniform_real_distribution<float> scaleDistribution{ 0.5f, 2.f };
+
+		std::vector<Transform3D> transforms(count);
+		for (Transform3D& transform : transforms)
+		{
+			transform.position = glm::vec3{ positionDistribution(generator), positionDistribution(generator), positionDistribution(generator) };
+			transform.rotation = glm::quat{ glm::vec3{ angleDistribution(generator), angleDistribution(generator), angleDistribution(generator) } };
+			transform.scale = glm::vec3{ scaleDistribution(generator), scaleDistribution(generator), scaleDistribution(generator) };
+		}
+		return transforms;
+	}
+
+	// Every stride'th instance changes, spread over the whole range like moving objects in a scene
+	std::vector<uint32_t> CreateDirtyIndices(uint32_t count, uint32_t dirtyPercent)
+	{
+		std::vector<uint32_t> indices{};
+		if (dirtyPercent == 0) return indices;
+
+		const uint32_t stride{ std::max(100u / std::min(dirtyPercent, 100u), 1u) };
+		for (uint32_t index{}; index < count; index += stride) indices.emplace_back(index);
+		return indices;
+	}
+
+	double MeasureMs(uint32_t iterationCount, const std::function<void()>& function)
+	{
+		// Warm up the caches before measuring
+		function();
+
+		const auto start{ std::chrono::high_resolution_clock::now() };
+		for (uint32_t iteration{}; iteration < iterationCount; ++iteration) function();
+		const std::chrono::duration<double, std::milli> duration{ std::chrono::high_resolution_clock::now() - start };
+
+		return duration.count() / std::max(iterationCount, 1u);
+	}
+
+	float GetMaxDifference(const std::vector<ModelUBO>& lhs, const std::vector<ModelUBO>& rhs, uint32_t count)
+	{
+		float maxDifference{};
+		for (uint32_t index{}; index < count; ++index)
+		{
+			for (int column{}; column < 4; ++column)
+			{
+				for (int row{}; row < 4; ++row)
+				{
+					maxDifference = std::max(maxDifference, std::abs(lhs[index].model[column][row] - rhs[index].model[column][row]));
+				}
+			}
+		}
+		return maxDifference;
+	}
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: TransformBenchmark [--instances <count>] [--dirty <percent>] [--iterations <count>] [--threads <count>]\n";
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	uint32_t instanceCount{ 100000 };
+	uint32_t dirtyPercent{ 100 };
+	uint32_t iterationCount{ 100 };
+	uint32_t threadCount{ JobSystem::GetDefaultThreadCount() };
+
+	try
+	{
+		for (int argIdx{ 1 }; argIdx < argc; ++argIdx)
+		{
+			if (argIdx + 1 >= argc)
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+
+			const uint32_t value{ static_cast<uint32_t>(std::stoul(argv[argIdx + 1])) };
+			if (std::strcmp(argv[argIdx], "--instances") == 0) instanceCount = value;
+			else if (std::strcmp(argv[argIdx], "--dirty") == 0) dirtyPercent = value;
+			else if (std::strcmp(argv[argIdx], "--iterations") == 0) iterationCount = value;
+			else if (std::strcmp(argv[argIdx], "--threads") == 0) threadCount = std::max(value, 1u);
+			else
+			{
+				PrintUsage();
+				return EXIT_FAILURE;
+			}
+			++argIdx;
+		}
+
+		const std::vector<Transform3D> transforms{ CreateTransforms(instanceCount) };
+		const std::vector<uint32_t> dirtyIndices{ CreateDirtyIndices(instanceCount, dirtyPercent) };
+
+		TransformSoA transformSoA{};
+		transformSoA.Resize(instanceCount);
+		for (uint32_t index{}; index < instanceCount; ++index) transformSoA.SetTransform(index, transforms[index]);
+
+		std::vector<ModelUBO> perInstanceMatrices(instanceCount);
+		std::vector<ModelUBO> batchedMatrices(transformSoA.GetPaddedCount());
+
+		JobSystem jobSystem{};
+		jobSystem.Initialize(threadCount);
+
+		// Both paths start from the same changed instances, the batched path also pays for marking them dirty
+		const double perInstanceMs{ MeasureMs(iterationCount, [&]()
+		{
+			for (uint32_t index : dirtyIndices) perInstanceMatrices[index].model = transforms[index].GetModelMatrix();
+		}) };
+
+		const double batchedMs{ MeasureMs(iterationCount, [&]()
+		{
+			for (uint32_t index : dirtyIndices) transformSoA.SetPosition(index, transforms[index].position);
+			transformSoA.UpdateMatrices(batchedMatrices);
+		}) };
+
+		const double parallelMs{ MeasureMs(iterationCount, [&]()
+		{
+			for (uint32_t index : dirtyIndices) transformSoA.SetPosition(index, transforms[index].position);
+			transformSoA.UpdateMatrices(batchedMatrices, &jobSystem);
+		}) };
+
+		jobSystem.Destroy();
+
+		// Every instance once more, so the whole output can be compared
+		for (uint32_t index{}; index < instanceCount; ++index) perInstanceMatrices[index].model = transforms[index].GetModelMatrix();
+		transformSoA.Resize(instanceCount);
+		transformSoA.UpdateMatrices(batchedMatrices);
+
+		std::cout << instanceCount << " instances, " << dirtyIndices.size() << " changed per iteration, " << iterationCount << " iterations\n";
+		std::cout << "path                      ms/iteration   speedup\n";
+
+		const auto printRow{ [perInstanceMs](const std::string& name, double iterationMs)
+		{
+			std::cout << std::left << std::setw(26) << name << std::right << std::setw(12) << std::fixed << std::setprecision(4) << iterationMs
+				<< std::setw(10) << std::setprecision(2) << perInstanceMs / std::max(iterationMs, 1e-9) << "x\n";
+		} };
+
+		printRow("per instance", perInstanceMs);
+		printRow("batched", batchedMs);
+		printRow("batched " + std::to_string(threadCount) + " threads", parallelMs);
+
+		std::cout << "max difference: " << std::scientific << GetMaxDifference(perInstanceMatrices, batchedMatrices, instanceCount) << "\n";
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "TransformBenchmark failed: " << e.what() << "\n";
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
\ No newline at end of file